@@ -0,0 +1,650 @@
+/*!
+ ********************************************************************
+   @file            cos_bench.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Mikro-Benchmarks fuer den co-operative Scheduler (COS)
+
+   @brief  Steuer-Task und Last-Tasks der Benchmarks, siehe cos_bench.h
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include <stdlib.h>
+#include "cos_bench.h"
+#include "cos_semaphore.h"
+#include "cos_data_fifo.h"
+#include "cos_ser.h"
+
+
+/*! Dauer einer Messung */
+#define BENCH_WINDOW_TICKS     _milliSecToTicks(100)
+/*! hoechstens so viele Last-Tasks, groesster Wert in benchChurnCounts_g.
+    Kleiner setzen, falls der Speicher nicht reicht: es werden dann
+    weniger Last-Tasks erzeugt, param zeigt die tatsaechliche Anzahl. */
+#ifndef BENCH_MAX_TASKS
+#define BENCH_MAX_TASKS        4096
+#endif
+/*! Wiederholungen bei churn und set_prio */
+#define BENCH_LOOPS            1000
+/*! Anzahl Slots pro Messung fifo_copy, ohne Task-Wechsel */
+#define BENCH_COPY_LOOPS       100000UL
+/*! Prioritaet der Steuer-Task, ueber allen Last-Tasks */
+#define BENCH_CTRL_PRIO        254
+/*! Anzahl Slots des FIFO fuer die Messung fifo */
+#define BENCH_FIFO_SLOTS       8
+/*! Slots pro Aufruf bei fifo_many */
+#define BENCH_FIFO_BATCH       4
+/*! Task-Wechsel, die die niedrige Task den Lock bei inversion haelt */
+#define BENCH_HOLD_YIELDS      4
+/*! Anzahl Tasks, die bei sem_fifo um einen Semaphor konkurrieren */
+#define BENCH_FAIR_TASKS       8
+/*! Ticks, die die mittlere Task bei inversion rechnet (und halb so lang schlaeft) */
+#define BENCH_INV_BURST_TICKS  4
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static const uint16_t benchCounts_g[] = {1, 2, 4, 8, 16, 32, 64, 128, 256};
+static const uint16_t benchChurnCounts_g[] = {1, 4, 16, 64, 256, 1024, 4096};  /*! churn, set_prio */
+static const uint8_t  benchSlotSizes_g[] = {1, 4, 16, 64, 255};
+static const uint8_t  benchCopySizes_g[] = {1, 2, 4, 8, 12, 16, 64};
+
+static CosTask_t *load_g[BENCH_MAX_TASKS];  /*! Last-Tasks der Messung */
+static uint16_t nLoad_g;                     /*! Anzahl erzeugter Last-Tasks */
+static void (*done_g)(void) = NULL;
+
+/* Zaehler, von den Last-Tasks geschrieben */
+static volatile uint32_t ops_g;
+static volatile uint32_t sumCycles_g;
+static volatile uint32_t maxCycles_g;
+static volatile uint32_t t0_g;
+static volatile uint32_t lockOps_g;
+static volatile uint8_t  lockWaiting_g;
+
+static CosSema_t sema_g, ack_g;
+static CosFifo_t fifo_g;
+static char fifoBuf_g[256];
+static char batchBuf_g[BENCH_FIFO_BATCH * 256];
+static CosFifoIndex_t prodCnt_g, consCnt_g;   /*! fifo_many: Zaehler der Macros */
+static char *prodSlot_g, *consSlot_g;          /*! fifo_inplace: offene Slots */
+static CosMutex_t mutex_g;
+typedef struct {
+        uint32_t t0;              /*! Beginn des Wartens */
+        uint8_t waiting;          /*! 1: wartet gerade */
+} BenchWaiter_t;
+static BenchWaiter_t fair_g[BENCH_FAIR_TASKS];  /*! sem_fifo: eine pro Task, ueber pData */
+static uint8_t useMutex_g;   /*! inversion: 1 Mutex, 0 Semaphor als Lock */
+
+/* Zustand der Steuer-Task, lokale Variablen ueberleben keinen Task-Wechsel */
+static uint8_t  idx_g;
+static uint16_t i_g;
+static uint32_t start_g;
+static uint16_t rand_g = 1;
+
+
+
+/*---------------------------------------------------------------*/
+static uint16_t _rand(void)
+{
+    rand_g = (uint16_t)(rand_g * 25173U + 13849U);
+    return rand_g;
+}
+/*---------------------------------------------------------------*/
+/* decimal output without the leading blank of serOutUint32Dec() */
+static void _putDec(uint32_t x)
+{
+    char digit[10];
+    int8_t n = 0;
+
+    do
+    {   digit[n++] = (char)('0' + x % 10);
+        x /= 10;
+    } while(x != 0);
+    while(n > 0)
+    {   serPutc(digit[--n]);
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Gibt eine Ergebnis-Zeile aus. Die Zeit pro Operation wird in ns
+       umgerechnet, die Zaehlschritte stehen zusaetzlich roh in der
+       Zeile.
+
+  @param  name   - IN, Name der Messung
+  @param  param  - IN, Parameter (Anzahl Tasks, Slot-Groesse)
+  @param  ops    - IN, Anzahl Operationen
+  @param  cycles - IN, Zeit fuer alle Operationen in Zaehlschritten
+  @param  max    - IN, laengste einzelne Operation oder 0
+  @retval keine
+ ********************************************************************/
+static void _report(char *name, uint16_t param, uint32_t ops,
+                    uint32_t cycles, uint32_t max)
+{
+    uint32_t perMs = _cyclesPerMilliSec();
+    uint32_t ns = 0;
+
+    if(0 != ops)
+    {   ns = (uint32_t)(((uint64_t) cycles * 1000000ULL) / perMs / ops);
+    }
+    serPuts(name);                        serPutc(';');
+    _putDec(param);                       serPutc(';');
+    _putDec(ops);                         serPutc(';');
+    _putDec(cycles);                      serPutc(';');
+    _putDec(ns);                          serPutc(';');
+    _putDec((uint32_t)(((uint64_t) max * 1000000ULL) / perMs));
+    serPuts("\r\n");
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Erzeugt Last-Tasks, bis insgesamt n vorhanden sind, hoechstens
+       BENCH_MAX_TASKS. Reicht der Speicher nicht, werden weniger erzeugt, nLoad_g enthaelt die
+       tatsaechliche Anzahl.
+
+  @param  n    - IN, gewuenschte Gesamtzahl
+  @param  prio - IN, Prioritaet der Tasks
+  @param  func - IN, Task-Funktion
+  @retval keine
+ ********************************************************************/
+static void _createLoad(uint16_t n, uint8_t prio, void (*func)(CosTask_t *))
+{
+    CosTask_t *t_pt;
+
+    while((nLoad_g < n) && (nLoad_g < BENCH_MAX_TASKS))
+    {   t_pt = COS_CreateTask(prio, NULL, func);
+        if(NULL == t_pt)
+        {   break;
+        }
+        load_g[nLoad_g++] = t_pt;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _deleteLoad(void)
+{
+    while(nLoad_g > 0)
+    {   COS_DeleteTask(load_g[--nLoad_g]);
+    }
+}
+/*---------------------------------------------------------------*/
+static void _startWindow(void)
+{
+    ops_g = 0;
+    sumCycles_g = 0;
+    maxCycles_g = 0;
+    start_g = _getCycles();
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Schreibt und liest n Slots ohne Task-Wechsel, misst also nur
+       Kopieren und Index-Rechnung des FIFO. COS_SemTryWait() haelt
+       die Semaphoren wie COS_SEM_WAIT() im Gleichgewicht.
+
+  @param  n - IN, Anzahl Slots
+  @retval keine
+ ********************************************************************/
+static void _fifoCopyLoop(uint32_t n)
+{
+    while(n-- > 0)
+    {   (void) COS_SemTryWait(&fifo_g.wSema);
+        _qWriteSingleSlot(&fifo_g, fifoBuf_g);
+        (void) COS_SemTryWait(&fifo_g.rSema);
+        _qReadSingleSlot(&fifo_g, fifoBuf_g);
+    }
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/****************************************************************/
+/* Last-Tasks */
+/****************************************************************/
+static void _spinTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   ops_g++;
+        COS_TASK_SCHEDULE(pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _sleepTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_TASK_SLEEP(pt, 0x7FFF);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _signalTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   t0_g = _getCycles();
+        COS_SEM_SIGNAL(&sema_g);
+        COS_SEM_WAIT(&ack_g, pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _wakeTask(CosTask_t *pt)
+{
+    uint32_t lat;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_SEM_WAIT(&sema_g, pt);
+        lat = _getCycles() - t0_g;
+        sumCycles_g += lat;
+        if(lat > maxCycles_g)
+        {   maxCycles_g = lat;
+        }
+        ops_g++;
+        COS_SEM_SIGNAL(&ack_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* sem_fifo: takes the semaphore, holds it across one yield */
+static void _fairTask(CosTask_t *pt)
+{
+    BenchWaiter_t *w = (BenchWaiter_t *) pt->pData;
+    uint32_t lat;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   w->t0 = _getCycles();
+        w->waiting = 1;
+        COS_SEM_WAIT(&sema_g, pt);
+        w = (BenchWaiter_t *) pt->pData;   /* locals are lost across the wait */
+        w->waiting = 0;
+        lat = _getCycles() - w->t0;
+        if(lat > maxCycles_g)
+        {   maxCycles_g = lat;
+        }
+        ops_g++;
+        COS_TASK_SCHEDULE(pt);
+        COS_SEM_SIGNAL(&sema_g);
+        COS_TASK_SCHEDULE(pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* inversion: medium prio, computes in bursts and starves lower tasks */
+static void _burstTask(CosTask_t *pt)
+{
+    static CosTicks_t until;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_TASK_SLEEP(pt, BENCH_INV_BURST_TICKS / 2);
+        until = _gettime_Ticks32() + BENCH_INV_BURST_TICKS;
+        while((int32_t)(until - _gettime_Ticks32()) > 0)
+        {   COS_TASK_SCHEDULE(pt);
+        }
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* inversion: holds the lock across yields, lowest prio */
+static void _lockHolderTask(CosTask_t *pt)
+{
+    static uint8_t n;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   if(useMutex_g)
+        {   COS_MUTEX_LOCK(&mutex_g, pt);
+        }
+        else
+        {   COS_SEM_WAIT(&sema_g, pt);
+        }
+        for(n = 0; n < BENCH_HOLD_YIELDS; n++)
+        {   COS_TASK_SCHEDULE(pt);
+        }
+        if(useMutex_g)
+        {   COS_MutexUnlock(&mutex_g, pt);
+        }
+        else
+        {   COS_SEM_SIGNAL(&sema_g);
+        }
+        COS_TASK_SCHEDULE(pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* inversion: highest prio, measures the time until it gets the lock */
+static void _lockWaiterTask(CosTask_t *pt)
+{
+    uint32_t lat;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_TASK_SLEEP(pt, 1);
+        t0_g = _getCycles();
+        lockWaiting_g = 1;
+        if(useMutex_g)
+        {   COS_MUTEX_LOCK(&mutex_g, pt);
+        }
+        else
+        {   COS_SEM_WAIT(&sema_g, pt);
+        }
+        lockWaiting_g = 0;
+        lat = _getCycles() - t0_g;
+        sumCycles_g += lat;
+        if(lat > maxCycles_g)
+        {   maxCycles_g = lat;
+        }
+        lockOps_g++;
+        if(useMutex_g)
+        {   COS_MutexUnlock(&mutex_g, pt);
+        }
+        else
+        {   COS_SEM_SIGNAL(&sema_g);
+        }
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _producerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingWriteSingleSlot(pt, &fifo_g, fifoBuf_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _consumerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReadSingleSlot(pt, &fifo_g, fifoBuf_g);
+        ops_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _batchProducerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingWriteMany(pt, &fifo_g, batchBuf_g, BENCH_FIFO_BATCH, prodCnt_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _batchConsumerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReadMany(pt, &fifo_g, batchBuf_g, BENCH_FIFO_BATCH, consCnt_g);
+        ops_g += BENCH_FIFO_BATCH;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _inplaceProducerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReserve(pt, &fifo_g, prodSlot_g);
+        prodSlot_g[0] = (char) ops_g;
+        COS_FifoCommit(&fifo_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _inplaceConsumerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingPeek(pt, &fifo_g, consSlot_g);
+        fifoBuf_g[0] = consSlot_g[0];
+        COS_FifoRelease(&fifo_g);
+        ops_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Steuer-Task: fuehrt alle Messungen nacheinander aus und gibt
+       die Ergebnisse aus. Zum Schluss wird die done-Funktion von
+       COS_BenchStart() aufgerufen und die Task beendet sich.
+
+  @param  pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _benchTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    serPuts("\r\nCOSBENCH 1 ");
+    _putDec(_cyclesPerMilliSec());
+    serPuts("\r\nbench;param;ops;cycles;ns_per_op;max_ns\r\n");
+
+    /* dispatch cost, all load tasks ready */
+    for(idx_g = 0; idx_g < sizeof(benchCounts_g)/sizeof(benchCounts_g[0]); idx_g++)
+    {   _createLoad(benchCounts_g[idx_g], 1, _spinTask);
+        COS_TASK_SLEEP(pt, 1);   /* start the window at a tick */
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        _report("dispatch_ready", nLoad_g, ops_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+    }
+
+    /* dispatch cost, one task ready, the others sleep */
+    for(idx_g = 0; idx_g < sizeof(benchCounts_g)/sizeof(benchCounts_g[0]); idx_g++)
+    {   _createLoad(1, 1, _spinTask);
+        _createLoad(benchCounts_g[idx_g], 1, _sleepTask);
+        COS_TASK_SLEEP(pt, 1);
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        _report("dispatch_sleeping", nLoad_g, ops_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+    }
+
+    /* signal to wake latency, the waiting task has the higher prio */
+    COS_SemCreate(&sema_g, 0);
+    COS_SemCreate(&ack_g, 0);
+    _createLoad(1, 2, _wakeTask);
+    _createLoad(2, 1, _signalTask);
+    COS_TASK_SLEEP(pt, 1);
+    _startWindow();
+    COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+    _report("sem_wake", 1, ops_g, sumCycles_g, maxCycles_g);
+    _deleteLoad();
+    COS_SemDestroy(&sema_g);
+    COS_SemDestroy(&ack_g);
+
+    /* fairness: tasks of equal prio contend for one semaphore; served
+       FIFO, none waits longer than the others need to pass once */
+    COS_SemCreate(&sema_g, 1);
+    for(idx_g = 0; idx_g < BENCH_FAIR_TASKS; idx_g++)
+    {   fair_g[idx_g].waiting = 0;
+        load_g[nLoad_g] = COS_CreateTask(1, &fair_g[idx_g], _fairTask);
+        if(NULL != load_g[nLoad_g])
+        {   nLoad_g++;
+        }
+    }
+    COS_TASK_SLEEP(pt, 1);
+    _startWindow();
+    COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+    for(idx_g = 0; idx_g < nLoad_g; idx_g++)
+    {   if(fair_g[idx_g].waiting && (_getCycles() - fair_g[idx_g].t0 > maxCycles_g))
+        {   maxCycles_g = _getCycles() - fair_g[idx_g].t0;   /* still waiting */
+        }
+    }
+    _report("sem_fifo", nLoad_g, ops_g, _getCycles() - start_g, maxCycles_g);
+    _deleteLoad();
+    COS_SemDestroy(&sema_g);
+
+    /* priority inversion: low holds the lock, medium computes, high
+       waits for the lock. A semaphore leaves high blocked as long as
+       medium runs, the mutex lends high's prio to low. */
+    for(useMutex_g = 0; useMutex_g < 2; useMutex_g++)
+    {   COS_SemCreate(&sema_g, 1);
+        COS_MutexInit(&mutex_g);
+        lockOps_g = 0;
+        lockWaiting_g = 0;
+        _createLoad(1, 1, _lockHolderTask);
+        _createLoad(2, 2, _burstTask);
+        _createLoad(3, 3, _lockWaiterTask);
+        COS_TASK_SLEEP(pt, 1);
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        if(lockWaiting_g && (_getCycles() - t0_g > maxCycles_g))
+        {   maxCycles_g = _getCycles() - t0_g;   /* still blocked */
+        }
+        _report(useMutex_g ? "inversion_mutex" : "inversion_sem", BENCH_INV_BURST_TICKS,
+                lockOps_g, sumCycles_g, maxCycles_g);
+        _deleteLoad();
+        COS_SemDestroy(&sema_g);
+    }
+
+    /* FIFO producer/consumer throughput */
+    for(idx_g = 0; idx_g < sizeof(benchSlotSizes_g); idx_g++)
+    {   if(0 != COS_FifoCreate(&fifo_g, benchSlotSizes_g[idx_g], BENCH_FIFO_SLOTS))
+        {   _report("fifo", benchSlotSizes_g[idx_g], 0, 0, 0);
+            continue;
+        }
+        _createLoad(1, 1, _producerTask);
+        _createLoad(2, 2, _consumerTask);
+        COS_TASK_SLEEP(pt, 1);
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        _report("fifo", benchSlotSizes_g[idx_g], ops_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+        COS_FifoDestroy(&fifo_g);
+    }
+
+    /* the same, filled and read in place without copies */
+    for(idx_g = 0; idx_g < sizeof(benchSlotSizes_g); idx_g++)
+    {   if(0 != COS_FifoCreate(&fifo_g, benchSlotSizes_g[idx_g], BENCH_FIFO_SLOTS))
+        {   _report("fifo_inplace", benchSlotSizes_g[idx_g], 0, 0, 0);
+            continue;
+        }
+        _createLoad(1, 1, _inplaceProducerTask);
+        _createLoad(2, 2, _inplaceConsumerTask);
+        COS_TASK_SLEEP(pt, 1);
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        _report("fifo_inplace", benchSlotSizes_g[idx_g], ops_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+        COS_FifoDestroy(&fifo_g);
+    }
+
+    /* the same with BENCH_FIFO_BATCH slots per call */
+    for(idx_g = 0; idx_g < sizeof(benchSlotSizes_g); idx_g++)
+    {   if(0 != COS_FifoCreate(&fifo_g, benchSlotSizes_g[idx_g], BENCH_FIFO_SLOTS))
+        {   _report("fifo_many", benchSlotSizes_g[idx_g], 0, 0, 0);
+            continue;
+        }
+        _createLoad(1, 1, _batchProducerTask);
+        _createLoad(2, 2, _batchConsumerTask);
+        COS_TASK_SLEEP(pt, 1);
+        _startWindow();
+        COS_TASK_SLEEP(pt, BENCH_WINDOW_TICKS);
+        _report("fifo_many", benchSlotSizes_g[idx_g], ops_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+        COS_FifoDestroy(&fifo_g);
+    }
+
+    /* FIFO copy and index cost alone, see COS_FIFO_POW2_FAST */
+    for(idx_g = 0; idx_g < sizeof(benchCopySizes_g); idx_g++)
+    {   if(0 != COS_FifoCreate(&fifo_g, benchCopySizes_g[idx_g], BENCH_FIFO_SLOTS))
+        {   _report("fifo_copy", benchCopySizes_g[idx_g], 0, 0, 0);
+            continue;
+        }
+        _startWindow();
+        _fifoCopyLoop(BENCH_COPY_LOOPS);
+        _report("fifo_copy", benchCopySizes_g[idx_g], BENCH_COPY_LOOPS, _getCycles() - start_g, 0);
+        COS_FifoDestroy(&fifo_g);
+        COS_TASK_SCHEDULE(pt);
+    }
+
+    /* create/delete churn and priority changes with n existing tasks */
+    for(idx_g = 0; idx_g < sizeof(benchChurnCounts_g)/sizeof(benchChurnCounts_g[0]); idx_g++)
+    {   _createLoad(benchChurnCounts_g[idx_g], 1, _sleepTask);
+        for(i_g = 0; i_g < nLoad_g; i_g++)
+        {   COS_SetTaskPrio(load_g[i_g], (uint8_t)(1 + _rand() % 200));
+        }
+        _startWindow();
+        for(i_g = 0; i_g < BENCH_LOOPS; i_g++)
+        {   COS_DeleteTask(COS_CreateTask((uint8_t)(1 + _rand() % 200), NULL, _sleepTask));
+        }
+        _report("churn", nLoad_g, BENCH_LOOPS, _getCycles() - start_g, 0);
+
+        _startWindow();
+        for(i_g = 0; (i_g < BENCH_LOOPS) && (nLoad_g > 0); i_g++)
+        {   COS_SetTaskPrio(load_g[_rand() % nLoad_g], (uint8_t)(1 + _rand() % 200));
+        }
+        _report("set_prio", nLoad_g, i_g, _getCycles() - start_g, 0);
+        _deleteLoad();
+        COS_TASK_SCHEDULE(pt);
+    }
+
+    serPuts("COSBENCH END\r\n");
+    if(NULL != done_g)
+    {   done_g();
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Erzeugt die Steuer-Task der Benchmarks. Die Messungen laufen,
+       sobald der Scheduler gestartet ist, und dauern einige Sekunden.
+       Andere Tasks der Anwendung verfaelschen die Messwerte.
+
+  @see cos_bench.h
+  @param  done - IN, wird am Ende aufgerufen, oder NULL
+  @retval Zeiger auf die Steuer-Task oder NULL bei Fehler
+
+  @par Code-Beispiel:
+  @verbatim
+    COS_InitTaskList();
+    COS_BenchStart(NULL);
+    COS_RunScheduler();
+  @endverbatim
+ ********************************************************************/
+CosTask_t* COS_BenchStart(void (*done)(void))
+{
+    done_g = done;
+    nLoad_g = 0;
+    return COS_CreateTask(BENCH_CTRL_PRIO, NULL, _benchTask);
+}
+/*---------------------------------------------------------------*/
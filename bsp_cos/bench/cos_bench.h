@@ -0,0 +1,96 @@
+/*!
+ ********************************************************************
+   @file            cos_bench.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Mikro-Benchmarks fuer den co-operative Scheduler (COS)
+
+   @brief  Misst die Kosten von Task-Wechsel, Semaphor, FIFO und
+           Task-Verwaltung, auf dem Host und auf dem RX63N.
+
+   @section Wie funktionieren die Benchmarks?
+                COS_BenchStart() erzeugt eine Steuer-Task mit hoher
+                Prioritaet. Sie erzeugt fuer jede Messung die noetigen
+                Last-Tasks, schlaeft ein Messfenster lang und zaehlt
+                danach die erledigten Operationen und die mit
+                _getCycles() gemessene Zeit. Gemessen wird also immer
+                mit dem echten Scheduler in der eingestellten
+                Konfiguration (cos_scheduler.c).
+
+                Messungen (Spalte bench):
+                - dispatch_ready: n Tasks gleicher Prioritaet, alle
+                  bereit, Kosten pro Task-Wechsel
+                - dispatch_sleeping: eine bereite Task und n-1
+                  schlafende, Kosten pro Task-Wechsel
+                - sem_wake: Zeit von COS_SEM_SIGNAL() bis zum Start der
+                  wartenden Task, Mittelwert und Maximum
+                - sem_fifo: param Tasks gleicher Prioritaet teilen
+                  sich einen Semaphor, Kosten pro Durchgang und
+                  laengste Wartezeit einer Task
+                - inversion_sem / inversion_mutex: eine niedrige
+                  Task haelt einen Lock ueber einige Task-Wechsel, eine
+                  mittlere rechnet immer wieder param Ticks lang, eine
+                  hohe wartet jeden Tick auf den Lock. Mittlere und
+                  maximale Wartezeit der hohen Task, mit Semaphor bzw.
+                  CosMutex_t als Lock
+                - fifo: Erzeuger und Verbraucher ueber ein FIFO mit 8
+                  Slots, Kosten pro Slot, param ist die Slot-Groesse
+                - fifo_inplace: wie fifo, aber die Slots werden mit
+                  COS_FifoBlockingReserve() / COS_FifoBlockingPeek()
+                  direkt im Puffer beschrieben und gelesen
+                - fifo_many: wie fifo, aber 4 Slots pro Aufruf mit
+                  COS_FifoBlockingWriteMany() / COS_FifoBlockingReadMany()
+                - fifo_copy: Schreiben und Lesen eines Slots ohne
+                  Task-Wechsel, param ist die Slot-Groesse
+                - churn: COS_CreateTask() und COS_DeleteTask() bei n
+                  vorhandenen Tasks (bis 4096), Kosten pro Paar
+                - set_prio: COS_SetTaskPrio() mit zufaelliger
+                  Prioritaet bei n vorhandenen Tasks (bis 4096)
+
+                Die Ausgabe geht ueber die serielle Schnittstelle, eine
+                Zeile pro Messung, Spalten mit ';' getrennt:
+
+   @verbatim
+   COSBENCH 1 <Zaehlschritte pro ms>
+   bench;param;ops;cycles;ns_per_op;max_ns
+   dispatch_ready;1;123456;600000;...;0
+   ...
+   COSBENCH END
+   @endverbatim
+
+                Im Host-Port die reale Uhr benutzen, siehe
+                host/host_bench.c und "make -C bsp_cos/host bench".
+                Auf dem RX63N cos_bench.c zum Projekt hinzufuegen und
+                COS_BenchStart(NULL) nach COS_InitTaskList() aufrufen.
+                Dort reicht der Speicher nicht fuer 4096 Tasks, mit
+                COS_USE_STATIC_POOLS 1 begrenzt COS_TASK_POOL_SIZE die
+                Anzahl, sonst der Heap.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_bench_h_
+#define _cos_bench_h_
+
+
+#include "cos_scheduler.h"
+
+
+CosTask_t* COS_BenchStart(void (*done)(void));
+
+
+#endif
@@ -251,6 +251,20 @@
  */
 #define FREERTOS_IS_PRESENT		( 0 )
 
+/*!
+ * Nutzen Sie die preemptive Stufe
+ * von COS (P-Tasks, cos_preempt.h)?
+ *
+ * - 0: nur kooperative Tasks
+ * - 1: P-Tasks mit eigenem Stack,
+ *      Taskwechsel im SWINT
+ *
+ * @note Die P-Tasks laufen nur im
+ *       Supervisiormode, main( ) laeuft
+ *       dann auf dem USP.
+ */
+#define COS_PREEMPT_IS_PRESENT	( 0 )
+
 /*!
  * Soll ihr Programm im Supervisior-
  * oder Usermode laufen?
@@ -261,7 +275,7 @@
  * @note freeRTOS funktioniert nur
  *       im Supervisiormode!
  */
-#define RUN_IN_USERMODE			( 1 && !FREERTOS_IS_PRESENT )
+#define RUN_IN_USERMODE			( 1 && !FREERTOS_IS_PRESENT && !COS_PREEMPT_IS_PRESENT )
 
 /*!
  * Was soll mit dem primary Thread
@@ -666,6 +680,14 @@
 # error "Invalid value for FREERTOS_IS_PRESENT in bsp.h!"
 #endif
 
+#if COS_PREEMPT_IS_PRESENT != 0 && COS_PREEMPT_IS_PRESENT != 1
+# error "Invalid value for COS_PREEMPT_IS_PRESENT in bsp.h!"
+#endif
+
+#if FREERTOS_IS_PRESENT && COS_PREEMPT_IS_PRESENT
+# error "freeRTOS and COS_PREEMPT_IS_PRESENT both use SWINT, choose one in bsp.h!"
+#endif
+
 #if RUN_IN_USERMODE != 0 && RUN_IN_USERMODE != 1
 # error "Invalid value for RUN_IN_USERMODE in bsp.h!"
 #endif
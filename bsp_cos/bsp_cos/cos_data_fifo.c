@@ -16,7 +16,7 @@
    @par Beschreibung
    Dieses Modul stellt ein einfaches FIFO zum Datentransfer fuer Tasks des
    COS Tasking-Systems bereit. Ein FIFO besteht aus mehreren Daten Slots
-   mit je maximal 255 Byte.
+   gleicher Groesse, die Grenzen legt COS_FIFO_INDEX_BITS fest.
 
    @verbatim
 
@@ -60,10 +60,19 @@
 #include <string.h>  // for memcpy()
 #include "cos_ser.h"
 #include "cos_data_fifo.h"
+#include "cos_trace.h"
 
 
 
 
+/*! 1: sind Anzahl und Groesse der Slots Zweierpotenzen, rechnet das FIFO
+    den Ring-Index mit einer Maske statt mit % (Division auf dem RX) und
+    kopiert Slots mit 1, 2, 4, 8 oder 16 Byte mit fester Laenge. Der
+    Compiler macht daraus einzelne Wort-Zugriffe statt eines Aufrufs von
+    memcpy(). 0: immer der allgemeine Weg, z.B. zum Vergleich */
+#define COS_FIFO_POW2_FAST 1
+
+
 /*------------- DEBUGGING ---------------------------------*/
 #define DEBUG_MODULE 1
 
@@ -80,6 +89,149 @@ static void _msg(char *msg)
 }
 #endif
 /*---------------------------------------------------------------*/
+#if COS_FIFO_POW2_FAST
+/* constant sizes let the compiler use single word moves, memcpy() stays
+   correct for slots that are not aligned in the caller's memory */
+static void _copySlot(char *dst, const char *src, CosFifoIndex_t size)
+{
+    switch(size)
+    {   case 1:  *dst = *src;            break;
+        case 2:  memcpy(dst, src, 2);    break;
+        case 4:  memcpy(dst, src, 4);    break;
+        case 8:  memcpy(dst, src, 8);    break;
+        case 16: memcpy(dst, src, 16);   break;
+        default: memcpy(dst, src, size); break;
+    }
+}
+#endif
+/*---------------------------------------------------------------*/
+/* copies n slots to the ring at wIndex, at most two memcpy(), split
+   at the end of the buffer */
+static void _qPut(CosFifo_t *q, const char *data, CosFifoIndex_t n)
+{
+  uint32_t size  = (uint32_t) q->maxSlots * q->slotSize;
+  uint32_t bytes = (uint32_t) n * q->slotSize;
+  uint32_t first = size - q->wIndex;
+  uint32_t w;
+
+  if(bytes < first)
+  { first = bytes;
+  }
+  memcpy(&(q->buffer[q->wIndex]), data, first);
+  if(bytes > first)
+  { memcpy(q->buffer, data + first, bytes - first);
+  }
+  w = q->wIndex + bytes;
+  if(w >= size)
+  { w -= size;
+  }
+  q->wIndex = (CosFifoIndex_t) w;
+  q->usedSlots += n;
+}
+/*---------------------------------------------------------------*/
+/* copies n slots from the ring at rIndex, see _qPut() */
+static void _qGet(CosFifo_t *q, char *data, CosFifoIndex_t n)
+{
+  uint32_t size  = (uint32_t) q->maxSlots * q->slotSize;
+  uint32_t bytes = (uint32_t) n * q->slotSize;
+  uint32_t first = size - q->rIndex;
+  uint32_t r;
+
+  if(bytes < first)
+  { first = bytes;
+  }
+  memcpy(data, &(q->buffer[q->rIndex]), first);
+  if(bytes > first)
+  { memcpy(data + first, q->buffer, bytes - first);
+  }
+  r = q->rIndex + bytes;
+  if(r >= size)
+  { r -= size;
+  }
+  q->rIndex = (CosFifoIndex_t) r;
+  q->usedSlots -= n;
+}
+/*---------------------------------------------------------------*/
+/* hands k written slots to the readers; behind an open reserved slot
+   they wait for COS_FifoCommit(), so the readers see the FIFO order */
+static void _qPublish(CosFifo_t *q, CosFifoIndex_t k)
+{
+  if(q->wOpen)
+  { q->wPending += k;
+  }
+  else
+  { COS_SemSignalMany(&(q->rSema), (CosSemCount_t) k);
+  }
+}
+/*---------------------------------------------------------------*/
+/* gives k read slots back to the writers; behind an open peeked slot
+   they wait for COS_FifoRelease(), the free space stays contiguous */
+static void _qFree(CosFifo_t *q, CosFifoIndex_t k)
+{
+  if(q->rOpen)
+  { q->rPending += k;
+  }
+  else
+  { COS_SemSignalMany(&(q->wSema), (CosSemCount_t) k);
+  }
+}
+/*---------------------------------------------------------------*/
+/* writes as many of n slots as are free, plus the slot a woken task
+   already holds (reserved 1), each semaphore is changed once */
+static CosFifoIndex_t _qWriteBatch(CosFifo_t *q, const char *data,
+                                   CosFifoIndex_t n, uint8_t reserved)
+{
+  CosFifoIndex_t k = reserved;
+
+  if(q->wSema.count > 0)
+  { k += (CosFifoIndex_t) q->wSema.count;
+  }
+  if(k > n)
+  { k = n;
+  }
+  if(0 == k)
+  { return 0;
+  }
+  q->wSema.count -= (CosSemCount_t)(k - reserved);
+  _qPut(q, data, k);
+  COS_TRACE_EVENT(COS_TRACE_FIFO_WRITE, q, q->usedSlots);
+  _qPublish(q, k);
+  return k;
+}
+/*---------------------------------------------------------------*/
+/* reads as many of n slots as are used, see _qWriteBatch() */
+static CosFifoIndex_t _qReadBatch(CosFifo_t *q, char *data,
+                                  CosFifoIndex_t n, uint8_t reserved)
+{
+  CosFifoIndex_t k = reserved;
+
+  if(q->rSema.count > 0)
+  { k += (CosFifoIndex_t) q->rSema.count;
+  }
+  if(k > n)
+  { k = n;
+  }
+  if(0 == k)
+  { return 0;
+  }
+  q->rSema.count -= (CosSemCount_t)(k - reserved);
+  _qGet(q, data, k);
+  COS_TRACE_EVENT(COS_TRACE_FIFO_READ, q, q->usedSlots);
+  _qFree(q, k);
+  return k;
+}
+/*---------------------------------------------------------------*/
+/* byte offset of the slot after index i */
+static CosFifoIndex_t _qNextSlot(CosFifo_t *q, CosFifoIndex_t i)
+{
+#if COS_FIFO_POW2_FAST
+  if(0 != q->mask)
+  { return (CosFifoIndex_t)((i + q->slotSize) & q->mask);
+  }
+#endif
+  return (CosFifoIndex_t)((i + q->slotSize) % (CosFifoIndex_t)(q->maxSlots * q->slotSize));
+}
+/*---------------------------------------------------------------*/
 
 
 
@@ -94,8 +246,9 @@ static void _msg(char *msg)
  *
  *
  * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
- * @param  slotSize        - IN, Groesse Daten-Slot (1..255) in Byte
- * @param  nSlots          - IN, Anzahl Slots (1..255) im FIFO
+ * @param  slotSize        - IN, Groesse Daten-Slot in Byte, mindestens 1
+ * @param  nSlots          - IN, Anzahl Slots im FIFO, 1..COS_SEM_COUNT_MAX,
+ *                           slotSize*nSlots hoechstens COS_FIFO_INDEX_MAX
  *
  * @retval 0               - kein Fehler
  * @retval negative        - Fehler
@@ -122,8 +275,14 @@ int main(void)
 }
   @endverbatim
  ************************************************************************/
-uint8_t COS_FifoCreate(CosFifo_t *q, uint8_t slotSize, uint8_t nSlots)
+uint8_t COS_FifoCreate(CosFifo_t *q, CosFifoIndex_t slotSize, CosFifoIndex_t nSlots)
 {
+  uint32_t n = nSlots;   /* checked in 32 bit, whatever the index width */
+
+  if(!COS_FIFO_GEOMETRY_OK((uint32_t) slotSize, n))
+  { DebugCode(_msg("FifoCreate:geometry!"););
+    return -1;
+  }
   /* create buffer */
   q->buffer = (char *) malloc(slotSize * nSlots * sizeof(char));
   if(NULL == q->buffer)
@@ -132,14 +291,24 @@ uint8_t COS_FifoCreate(CosFifo_t *q, uint8_t slotSize, uint8_t nSlots)
   }
   q->maxSlots  = nSlots;
   q->slotSize  = slotSize;
+  q->mask      = 0;         /* general case: wrap with % */
+#if COS_FIFO_POW2_FAST
+  if((0 == (nSlots & (nSlots - 1))) && (0 == (slotSize & (slotSize - 1))))
+  { q->mask = (CosFifoIndex_t)(nSlots * slotSize - 1);
+  }
+#endif
   q->rIndex    = 0;         /* empty queue */
   q->wIndex    = 0;
   q->usedSlots = 0;
+  q->wPending  = 0;         /* no slot open */
+  q->rPending  = 0;
+  q->wOpen     = 0;
+  q->rOpen     = 0;
   if(0!= COS_SemCreate(&(q->rSema), 0))  // nothing to read yet
   {  DebugCode(_msg("FifoCreate:SemCreate!"););
      return -1;
   }
-  if(0!= COS_SemCreate(&(q->wSema), nSlots)) // all slots are still free
+  if(0!= COS_SemCreate(&(q->wSema), (CosSemCount_t) nSlots)) // all slots are still free
   {  DebugCode(_msg("FifoCreate:SemCreate!"););
      return -1;
   }
@@ -320,11 +489,20 @@ int8_t _qWriteSingleSlot(CosFifo_t *q, const char *data)
   }
   else  /* at least one slot is free, write data */
   { retval = 1;
-    memcpy(&(q->buffer[q->wIndex]), data, q->slotSize); /* copy to FIFO */
-    q->wIndex += q->slotSize;                  /* next slot */
-    q->wIndex %= (q->maxSlots * q->slotSize);  /* circular buffer */
+#if COS_FIFO_POW2_FAST
+    if(0 != q->mask)
+    { _copySlot(&(q->buffer[q->wIndex]), data, q->slotSize);
+      q->wIndex = (CosFifoIndex_t)((q->wIndex + q->slotSize) & q->mask);
+    }
+    else
+#endif
+    { memcpy(&(q->buffer[q->wIndex]), data, q->slotSize); /* copy to FIFO */
+      q->wIndex += q->slotSize;                  /* next slot */
+      q->wIndex %= (CosFifoIndex_t)(q->maxSlots * q->slotSize);  /* circular buffer */
+    }
     q->usedSlots  += 1;
-    COS_SEM_SIGNAL(&(q->rSema));  // unblock tasks that wait for reading,
+    COS_TRACE_EVENT(COS_TRACE_FIFO_WRITE, q, q->usedSlots);
+    _qPublish(q, 1);  // unblock tasks that wait for reading,
   }
   return retval;
 }
@@ -370,11 +548,20 @@ int8_t _qReadSingleSlot(CosFifo_t *q, char *data)
   }
   else /* at least one slot has data */
   {   retval = 1;
-       memcpy(data, &(q->buffer[q->rIndex]), q->slotSize); /* read from queue */
-       q->rIndex += q->slotSize;                  /* next slot to read */
-       q->rIndex %= (q->maxSlots * q->slotSize);  /* circular buffer */
+#if COS_FIFO_POW2_FAST
+       if(0 != q->mask)
+       {   _copySlot(data, &(q->buffer[q->rIndex]), q->slotSize);
+           q->rIndex = (CosFifoIndex_t)((q->rIndex + q->slotSize) & q->mask);
+       }
+       else
+#endif
+       {   memcpy(data, &(q->buffer[q->rIndex]), q->slotSize); /* read from queue */
+           q->rIndex += q->slotSize;                  /* next slot to read */
+           q->rIndex %= (CosFifoIndex_t)(q->maxSlots * q->slotSize);  /* circular buffer */
+       }
        q->usedSlots  -= 1;
-       COS_SEM_SIGNAL(&(q->wSema));  // unblock tasks that wait for writing
+       COS_TRACE_EVENT(COS_TRACE_FIFO_READ, q, q->usedSlots);
+       _qFree(q, 1);  // unblock tasks that wait for writing
   }
   return retval;
 }
@@ -384,6 +571,328 @@ int8_t _qReadSingleSlot(CosFifo_t *q, char *data)
 
 
 
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion schreibt bis zu n Slots ins FIFO, ohne zu
+    blockieren, so viele wie frei sind. Die Daten liegen in data
+    hintereinander, jeweils 'slotSize' Byte. Kopiert wird mit hoechstens
+    zwei memcpy() (geteilt am Ende des Ringpuffers), die Semaphoren
+    werden einmal pro Aufruf angepasst, nicht einmal pro Slot.
+ *
+ * @see
+ * @arg  COS_FifoReadMany(), COS_FifoBlockingWriteMany()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ * @param  data            - IN, Zeiger auf n Slots Daten
+ * @param  n               - IN, Anzahl Slots
+ *
+ * @retval Anzahl geschriebener Slots, 0 falls das FIFO voll ist
+ ************************************************************************/
+CosFifoIndex_t COS_FifoWriteMany(CosFifo_t *q, const void *data, CosFifoIndex_t n)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoWriteMany:not init"););
+    return 0;
+  }
+  return _qWriteBatch(q, (const char *) data, n, 0);
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion liest bis zu n Slots aus dem FIFO, ohne zu
+    blockieren, so viele wie vorhanden sind. Siehe COS_FifoWriteMany().
+ *
+ * @see
+ * @arg  COS_FifoWriteMany(), COS_FifoBlockingReadMany()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ * @param  data            - OUT, Platz fuer n Slots Daten
+ * @param  n               - IN, Anzahl Slots
+ *
+ * @retval Anzahl gelesener Slots, 0 falls das FIFO leer ist
+ ************************************************************************/
+CosFifoIndex_t COS_FifoReadMany(CosFifo_t *q, void *data, CosFifoIndex_t n)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoReadMany:not init"););
+    return 0;
+  }
+  return _qReadBatch(q, (char *) data, n, 0);
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Kern von COS_FifoBlockingWriteMany(): schreibt, was von den n Slots
+    noch fehlt und ins FIFO passt. Fehlen danach noch Slots, blockiert
+    die Task am Schreib-Semaphor wie bei COS_SEM_WAIT(). Wird sie
+    geweckt, gehoert ihr ein freier Slot, der naechste Aufruf kommt
+    dann mit reserved 1.
+    SOLLTE NUR UEBER DAS MACRO genutzt werden.
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ * @param  data            - IN, Zeiger auf alle n Slots Daten
+ * @param  n               - IN, Anzahl Slots
+ * @param  cnt_p           - IN/OUT, Anzahl bereits geschriebener Slots
+ * @param  reserved        - IN, 1 nach dem Wecken, sonst 0
+ * @param  pt              - IN, Zeiger auf die laufende Task
+ *
+ * @retval 1 falls die Task blockiert ist, 0 falls alle Slots geschrieben sind
+ ************************************************************************/
+uint8_t _qWriteMany(CosFifo_t *q, const char *data, CosFifoIndex_t n,
+                    CosFifoIndex_t *cnt_p, uint8_t reserved, CosTask_t *pt)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("_qWriteMany:not init"););
+    return 0;
+  }
+  *cnt_p += _qWriteBatch(q, data + (uint32_t) *cnt_p * q->slotSize,
+                         (CosFifoIndex_t)(n - *cnt_p), reserved);
+  if(*cnt_p < n)
+  { _semBlock(&(q->wSema), pt);
+    return 1;
+  }
+  return 0;
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Kern von COS_FifoBlockingReadMany(), siehe _qWriteMany().
+    SOLLTE NUR UEBER DAS MACRO genutzt werden.
+ *
+ * @retval 1 falls die Task blockiert ist, 0 falls alle Slots gelesen sind
+ ************************************************************************/
+uint8_t _qReadMany(CosFifo_t *q, char *data, CosFifoIndex_t n,
+                   CosFifoIndex_t *cnt_p, uint8_t reserved, CosTask_t *pt)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("_qReadMany:not init"););
+    return 0;
+  }
+  *cnt_p += _qReadBatch(q, data + (uint32_t) *cnt_p * q->slotSize,
+                        (CosFifoIndex_t)(n - *cnt_p), reserved);
+  if(*cnt_p < n)
+  { _semBlock(&(q->rSema), pt);
+    return 1;
+  }
+  return 0;
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion reserviert ohne zu blockieren den naechsten freien
+    Slot und gibt einen Zeiger in den Puffer des FIFO zurueck. Der
+    Erzeuger fuellt den Slot dort und gibt ihn mit COS_FifoCommit() an
+    die Leser weiter. Der Zeiger ist nur bis COS_FifoCommit() gueltig.
+    Andere Schreiber schreiben bis dahin hinter den reservierten Slot.
+ *
+ * @see
+ * @arg  COS_FifoBlockingReserve(), COS_FifoCommit()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ *
+ * @retval Zeiger auf den Slot, NULL falls das FIFO voll ist oder schon
+ *         ein Slot reserviert ist
+ ************************************************************************/
+void *COS_FifoTryReserve(CosFifo_t *q)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoTryReserve:not init"););
+    return NULL;
+  }
+  if(q->wOpen || (0 != COS_SemTryWait(&(q->wSema))))
+  { return NULL;
+  }
+  return _qReserveSlot(q);
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion gibt einen mit COS_FifoBlockingReserve() bzw.
+    COS_FifoTryReserve() reservierten und gefuellten Slot an die Leser
+    weiter, zusammen mit den Slots, die andere Tasks inzwischen dahinter
+    geschrieben haben, und weckt ggf. wartende Leser.
+ *
+ * @see
+ * @arg  COS_FifoBlockingReserve(), COS_FifoTryReserve()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ *
+ * @retval 0 fuer ok, -1 falls kein Slot reserviert ist
+ ************************************************************************/
+int8_t COS_FifoCommit(CosFifo_t *q)
+{
+  CosFifoIndex_t k;
+
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoCommit:not init"););
+    return -1;
+  }
+  if(!q->wOpen)
+  { DebugCode(_msg("FifoCommit:nothing reserved"););
+    return -1;
+  }
+  k = (CosFifoIndex_t)(q->wPending + 1);
+  q->wOpen = 0;
+  q->wPending = 0;
+  COS_TRACE_EVENT(COS_TRACE_FIFO_WRITE, q, q->usedSlots);
+  COS_SemSignalMany(&(q->rSema), (CosSemCount_t) k);
+  return 0;
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion gibt ohne zu blockieren einen Zeiger auf den
+    aeltesten Slot im Puffer des FIFO zurueck. Der Leser bearbeitet
+    die Daten dort und gibt den Slot mit COS_FifoRelease() frei. Der
+    Zeiger ist nur bis COS_FifoRelease() gueltig. Andere Leser lesen
+    bis dahin die Slots dahinter.
+ *
+ * @see
+ * @arg  COS_FifoBlockingPeek(), COS_FifoRelease()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ *
+ * @retval Zeiger auf den Slot, NULL falls das FIFO leer ist oder schon
+ *         ein Slot offen ist
+ ************************************************************************/
+void *COS_FifoTryPeek(CosFifo_t *q)
+{
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoTryPeek:not init"););
+    return NULL;
+  }
+  if(q->rOpen || (0 != COS_SemTryWait(&(q->rSema))))
+  { return NULL;
+  }
+  return _qPeekSlot(q);
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Diese Funktion gibt einen mit COS_FifoBlockingPeek() bzw.
+    COS_FifoTryPeek() geholten Slot frei, zusammen mit den Slots, die
+    andere Tasks inzwischen dahinter gelesen haben, und weckt ggf.
+    wartende Schreiber.
+ *
+ * @see
+ * @arg  COS_FifoBlockingPeek(), COS_FifoTryPeek()
+ *
+ * @param  q               - IN/OUT, Zeiger auf FIFO Struktur
+ *
+ * @retval 0 fuer ok, -1 falls kein Slot offen ist
+ ************************************************************************/
+int8_t COS_FifoRelease(CosFifo_t *q)
+{
+  CosFifoIndex_t k;
+
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("FifoRelease:not init"););
+    return -1;
+  }
+  if(!q->rOpen)
+  { DebugCode(_msg("FifoRelease:nothing open"););
+    return -1;
+  }
+  k = (CosFifoIndex_t)(q->rPending + 1);
+  q->rOpen = 0;
+  q->rPending = 0;
+  q->usedSlots -= 1;
+  COS_TRACE_EVENT(COS_TRACE_FIFO_READ, q, q->usedSlots);
+  COS_SemSignalMany(&(q->wSema), (CosSemCount_t) k);
+  return 0;
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Oeffnet nach COS_SEM_WAIT() auf wSema den Slot am Schreib-Index:
+    der Schreib-Index rueckt gleich dahinter, der Slot zaehlt als
+    benutzt, wird aber erst mit COS_FifoCommit() an die Leser gemeldet.
+    Ist schon ein Slot reserviert, geht das Ereignis an wSema zurueck.
+    SOLLTE NUR UEBER DAS MACRO COS_FifoBlockingReserve() genutzt werden.
+ *
+ * @retval Zeiger auf den Slot, NULL falls schon ein Slot reserviert
+ *         oder das FIFO nicht initialisiert ist
+ ************************************************************************/
+void *_qReserveSlot(CosFifo_t *q)
+{
+  char *slot;
+
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("_qReserveSlot:not init"););
+    return NULL;
+  }
+  if(q->wOpen)
+  { DebugCode(_msg("_qReserveSlot:already open"););
+    COS_SEM_SIGNAL(&(q->wSema));
+    return NULL;
+  }
+  slot = &(q->buffer[q->wIndex]);
+  q->wIndex = _qNextSlot(q, q->wIndex);
+  q->usedSlots += 1;
+  q->wOpen = 1;
+  return slot;
+}
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Oeffnet nach COS_SEM_WAIT() auf rSema den Slot am Lese-Index: der
+    Lese-Index rueckt gleich dahinter, der Slot bleibt belegt, bis
+    COS_FifoRelease() ihn den Schreibern zurueckgibt. Ist schon ein
+    Slot offen, geht das Ereignis an rSema zurueck.
+    SOLLTE NUR UEBER DAS MACRO COS_FifoBlockingPeek() genutzt werden.
+ *
+ * @retval Zeiger auf den Slot, NULL falls schon ein Slot offen oder
+ *         das FIFO nicht initialisiert ist
+ ************************************************************************/
+void *_qPeekSlot(CosFifo_t *q)
+{
+  char *slot;
+
+  if(q->isInitialized == 0)
+  { DebugCode(_msg("_qPeekSlot:not init"););
+    return NULL;
+  }
+  if(q->rOpen)
+  { DebugCode(_msg("_qPeekSlot:already open"););
+    COS_SEM_SIGNAL(&(q->rSema));
+    return NULL;
+  }
+  slot = &(q->buffer[q->rIndex]);
+  q->rIndex = _qNextSlot(q, q->rIndex);
+  q->rOpen = 1;
+  return slot;
+}
+
+
+
 /*!
  **********************************************************************
  * @par Beschreibung:
@@ -398,7 +907,7 @@ int8_t _qReadSingleSlot(CosFifo_t *q, char *data)
  *
  * @retval Anzahl der belegten Slots
  ************************************************************************/
-uint8_t COS_FifoGetUsedSlots(CosFifo_t *q)
+CosFifoIndex_t COS_FifoGetUsedSlots(CosFifo_t *q)
 {   return q->usedSlots;
 }
 
@@ -418,7 +927,7 @@ uint8_t COS_FifoGetUsedSlots(CosFifo_t *q)
  *
  * @retval Anzahl der Slots im  FIFO
  ************************************************************************/
-uint8_t COS_FifoGetMaxSlots(CosFifo_t *q)
+CosFifoIndex_t COS_FifoGetMaxSlots(CosFifo_t *q)
 {   return q->maxSlots;
 }
 
@@ -436,7 +945,7 @@ uint8_t COS_FifoGetMaxSlots(CosFifo_t *q)
  *
  * @retval Slot Groesse in Byte
  ************************************************************************/
-uint8_t COS_FifoGetSlotSize(CosFifo_t *q)
+CosFifoIndex_t COS_FifoGetSlotSize(CosFifo_t *q)
 {
   return q->slotSize;
 }
@@ -7,9 +7,26 @@
    @brief  Daten-FIFO fuer COS auf Atmel.
           Der FIFO benutzt dynamische Speicherverwaltung (malloc()).
           Es kann nur ein Sorte Daten gespeichert werden.
-          Die maximale Anzahl von Speicherplaetzen (Slots) ist 255 wegen
-          der Verwendung von 1 Byte Indexvariablen. Ein Slot kann maximal
-          256 Byte Speichern.
+          Die Indizes sind Byte-Offsets in den Puffer, ihre Breite legt
+          COS_FIFO_INDEX_BITS fest: Slot-Groesse mal Anzahl Slots darf
+          hoechstens COS_FIFO_INDEX_MAX Byte sein. Die Anzahl Slots ist
+          ausserdem durch den Zaehler des Semaphors fuer die freien
+          Slots begrenzt (COS_SEM_COUNT_MAX, siehe cos_semaphore.h).
+          Feste Groessen prueft COS_FIFO_GEOMETRY_OK() schon beim
+          Uebersetzen. Sind Anzahl und Groesse der Slots Zweierpotenzen,
+          laeuft das FIFO schneller, siehe COS_FIFO_POW2_FAST in
+          cos_data_fifo.c.
+          Grosse Slots koennen ohne Kopie direkt im Puffer gefuellt und
+          gelesen werden: COS_FifoBlockingReserve() / COS_FifoCommit()
+          fuer den Erzeuger, COS_FifoBlockingPeek() / COS_FifoRelease()
+          fuer den Verbraucher. Pro Seite ist immer nur ein Slot offen,
+          ein zweites Reserve bzw. Peek wird abgelehnt. Die anderen
+          Zugriffe derselben Seite duerfen weiterlaufen und gehen hinter
+          den offenen Slot: was andere Tasks waehrend eines offenen
+          Reserve schreiben, sehen die Leser erst nach dem Commit, die
+          Reihenfolge im FIFO bleibt erhalten. Ebenso werden Slots, die
+          hinter einem offenen Peek gelesen werden, erst mit dem Release
+          wieder frei fuer die Schreiber.
 
 
    @par Author    : Fgb
@@ -63,16 +80,59 @@
 #endif
 
 
+/*! Breite der Indizes und Groessen eines FIFO in Bit: 8, 16 oder 32.
+    Mit 8 Bit ist der Puffer hoechstens 255 Byte gross. */
+#define COS_FIFO_INDEX_BITS  16
+
+#if COS_FIFO_INDEX_BITS == 8
+  typedef uint8_t  CosFifoIndex_t;
+  #define COS_FIFO_INDEX_MAX  0xFF
+#elif COS_FIFO_INDEX_BITS == 16
+  typedef uint16_t CosFifoIndex_t;
+  #define COS_FIFO_INDEX_MAX  0xFFFF
+#elif COS_FIFO_INDEX_BITS == 32
+  typedef uint32_t CosFifoIndex_t;
+  #define COS_FIFO_INDEX_MAX  0xFFFFFFFF
+#else
+  #error "COS_FIFO_INDEX_BITS must be 8, 16 or 32"
+#endif
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    1, falls ein FIFO mit nSlots Slots zu je slotSize Byte mit den
+    eingestellten Breiten von Index und Semaphor moeglich ist. Mit
+    Konstanten auch in #if verwendbar, COS_FifoCreate() prueft dasselbe
+    zur Laufzeit.
+ * @par Code-Beispiel :
+ * @verbatim
+#define SAMPLE_SLOTS  512
+#if !COS_FIFO_GEOMETRY_OK(4, SAMPLE_SLOTS)
+  #error "sample FIFO too large, increase COS_FIFO_INDEX_BITS or COS_SEM_COUNT_BITS"
+#endif
+  @endverbatim
+ ************************************************************************/
+#define COS_FIFO_GEOMETRY_OK(slotSize, nSlots)  \
+                        (((slotSize) >= 1) && ((nSlots) >= 1) && \
+                         ((nSlots) <= COS_SEM_COUNT_MAX) && \
+                         ((slotSize) <= COS_FIFO_INDEX_MAX / (nSlots)))
+
+
 /***********************************************
  * FIFO data structure :
  ***********************************************/
 typedef struct {
         char *buffer;        /*!< Queue Datenpuffer */
-        uint8_t maxSlots;      /*!< Gesamtzahl der Slots in der Queue  */
-        uint8_t slotSize;      /*!< Groesse eines Slot in Byte */
-        uint8_t rIndex;        /*!< Lese-Index des Puffers */
-        uint8_t wIndex;        /*!< Schrieb-Index des Puffers */
-        uint8_t usedSlots;     /*!< Anzahl der benutzten Slots */
+        CosFifoIndex_t maxSlots;  /*!< Gesamtzahl der Slots in der Queue  */
+        CosFifoIndex_t slotSize;  /*!< Groesse eines Slot in Byte */
+        CosFifoIndex_t rIndex;    /*!< Lese-Index des Puffers (Byte-Offset) */
+        CosFifoIndex_t wIndex;    /*!< Schreib-Index des Puffers (Byte-Offset) */
+        CosFifoIndex_t usedSlots; /*!< Anzahl der benutzten Slots, offene mitgezaehlt */
+        CosFifoIndex_t mask;      /*!< Puffergroesse-1 bei Zweierpotenzen, sonst 0 */
+        CosFifoIndex_t wPending;  /*!< hinter dem offenen Reserve geschriebene Slots */
+        CosFifoIndex_t rPending;  /*!< hinter dem offenen Peek gelesene Slots */
+        uint8_t wOpen;         /*!< 1: ein reservierter Slot wartet auf COS_FifoCommit() */
+        uint8_t rOpen;         /*!< 1: ein Slot wartet auf COS_FifoRelease() */
         uint8_t isInitialized; /*!< 0 falls noch nicht initialisiert */
         CosSema_t rSema;       /*!< wartet an diesem Semaphore beim Lesen */
         CosSema_t wSema;       /*!< wartet an diesem Semaphore beim Schreiben */
@@ -81,17 +141,31 @@ typedef struct {
 
 
 
-uint8_t COS_FifoCreate(CosFifo_t *q, uint8_t slotSize, uint8_t nSlots);
+uint8_t COS_FifoCreate(CosFifo_t *q, CosFifoIndex_t slotSize, CosFifoIndex_t nSlots);
 uint8_t COS_FifoDestroy(CosFifo_t *q);
 int8_t COS_FifoIsEmpty(CosFifo_t *q);
 int8_t COS_FifoIsFull(CosFifo_t *q);
 
-uint8_t COS_FifoGetUsedSlots(CosFifo_t *q);
-uint8_t COS_FifoGetMaxSlots(CosFifo_t *q);
-uint8_t COS_FifoGetSlotSize(CosFifo_t *q);
+CosFifoIndex_t COS_FifoGetUsedSlots(CosFifo_t *q);
+CosFifoIndex_t COS_FifoGetMaxSlots(CosFifo_t *q);
+CosFifoIndex_t COS_FifoGetSlotSize(CosFifo_t *q);
+
+CosFifoIndex_t COS_FifoWriteMany(CosFifo_t *q, const void *data, CosFifoIndex_t n);
+CosFifoIndex_t COS_FifoReadMany(CosFifo_t *q, void *data, CosFifoIndex_t n);
+
+void  *COS_FifoTryReserve(CosFifo_t *q);
+int8_t COS_FifoCommit(CosFifo_t *q);
+void  *COS_FifoTryPeek(CosFifo_t *q);
+int8_t COS_FifoRelease(CosFifo_t *q);
 
 int8_t _qWriteSingleSlot(CosFifo_t *q, const char *data);
 int8_t _qReadSingleSlot(CosFifo_t *q, char *data);
+uint8_t _qWriteMany(CosFifo_t *q, const char *data, CosFifoIndex_t n,
+                    CosFifoIndex_t *cnt_p, uint8_t reserved, CosTask_t *pt);
+void *_qReserveSlot(CosFifo_t *q);
+void *_qPeekSlot(CosFifo_t *q);
+uint8_t _qReadMany(CosFifo_t *q, char *data, CosFifoIndex_t n,
+                   CosFifoIndex_t *cnt_p, uint8_t reserved, CosTask_t *pt);
 
 // blockierende Macros
 
@@ -197,6 +271,177 @@ int main(void)
 #define COS_FifoBlockingReadSingleSlot(pt, q,  data)   COS_SEM_WAIT(&((q)->rSema),(pt)); \
                                                        _qReadSingleSlot((q), (char *)(data))
 
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Dieses Macro schreibt n Slots ins FIFO und blockiert, bis alle
+    geschrieben sind. Bei jedem Lauf der Task wird so viel geschrieben,
+    wie Platz ist, mit hoechstens zwei memcpy() und einer Aenderung
+    jedes Semaphors, nicht Slot fuer Slot. Ist das FIFO voll, wartet die
+    Task am Schreib-Semaphor wie COS_FifoBlockingWriteSingleSlot().
+    Ist genug Platz, laeuft die Task ohne Task-Wechsel weiter.
+ *
+ * @see
+ * @arg  COS_FifoBlockingReadMany(), COS_FifoWriteMany()
+ *
+ * @par Macro Parameter: (CosTask_t *pt, CosFifo_t *q, void *data, n, cnt)
+ *
+ * @param  pt   - IN/OUT, Zeiger auf Task struct
+ * @param  q    - IN/OUT, Zeiger auf Queue struct
+ * @param  data - IN, Zeiger auf n Slots Daten, muss bis zum Ende gueltig
+ *                bleiben (static)
+ * @param  n    - IN, Anzahl Slots, wird beim Weiterlaufen erneut
+ *                ausgewertet (Konstante oder static)
+ * @param  cnt  - OUT, CosFifoIndex_t Variable (static), zaehlt die
+ *                geschriebenen Slots, am Ende gleich n
+ * @retval void
+ * @par Example :
+ * @verbatim
+CosFifo_t adcFifo;     // COS_FifoCreate(&adcFifo, sizeof(uint16_t), 64)
+
+void adcTask(CosTask_t *pt)
+{   static uint16_t block[16];
+    static CosFifoIndex_t cnt;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   _adcReadBlock(block, 16);
+        COS_FifoBlockingWriteMany(pt, &adcFifo, block, 16, cnt);
+        COS_TASK_SLEEP(pt, 1);
+    }
+    COS_TASK_END(pt);
+}
+  @endverbatim
+ ************************************************************************/
+#define COS_FifoBlockingWriteMany(pt, q, data, n, cnt)  (cnt) = 0; \
+                            (pt)->lineCnt=__LINE__; \
+                            if(0) { \
+                              case __LINE__: \
+                                if(_qWriteMany((q), (const char *)(data), (n), &(cnt), 1, (pt))) { \
+                                  return; \
+                                } \
+                            } \
+                            else if(_qWriteMany((q), (const char *)(data), (n), &(cnt), 0, (pt))) { \
+                              return; \
+                            }
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Dieses Macro liest n Slots aus dem FIFO und blockiert, bis alle
+    gelesen sind, siehe COS_FifoBlockingWriteMany(). Wer nur lesen
+    will, was gerade da ist, nimmt COS_FifoReadMany().
+ *
+ * @see
+ * @arg  COS_FifoBlockingWriteMany(), COS_FifoReadMany()
+ *
+ * @param  pt   - IN/OUT, Zeiger auf Task struct
+ * @param  q    - IN/OUT, Zeiger auf Queue struct
+ * @param  data - OUT, Platz fuer n Slots Daten (static)
+ * @param  n    - IN, Anzahl Slots (Konstante oder static)
+ * @param  cnt  - OUT, CosFifoIndex_t Variable (static), zaehlt die
+ *                gelesenen Slots, am Ende gleich n
+ * @retval void
+ ************************************************************************/
+#define COS_FifoBlockingReadMany(pt, q, data, n, cnt)  (cnt) = 0; \
+                            (pt)->lineCnt=__LINE__; \
+                            if(0) { \
+                              case __LINE__: \
+                                if(_qReadMany((q), (char *)(data), (n), &(cnt), 1, (pt))) { \
+                                  return; \
+                                } \
+                            } \
+                            else if(_qReadMany((q), (char *)(data), (n), &(cnt), 0, (pt))) { \
+                              return; \
+                            }
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Dieses Macro reserviert den naechsten freien Slot und liefert einen
+    Zeiger direkt in den Puffer des FIFO. Ist das FIFO voll, blockiert
+    die Task wie bei COS_FifoBlockingWriteSingleSlot(). Die Task fuellt
+    den Slot an Ort und Stelle und gibt ihn mit COS_FifoCommit() frei,
+    die Kopie aus einem eigenen Puffer entfaellt. Bis zum Commit darf
+    die Task blockieren, andere Tasks duerfen weiter schreiben, ihre
+    Slots kommen hinter den reservierten. Ist schon ein Slot reserviert,
+    ist ptr NULL. Der Slot ist nur passend ausgerichtet, wenn die
+    Slot-Groesse ein Vielfaches der Ausrichtung des Datentyps ist.
+ *
+ * @see
+ * @arg  COS_FifoCommit(), COS_FifoTryReserve(), COS_FifoBlockingPeek()
+ *
+ * @par Macro Parameter: (CosTask_t *pt, CosFifo_t *q, ptr)
+ *
+ * @param  pt   - IN/OUT, Zeiger auf Task struct
+ * @param  q    - IN/OUT, Zeiger auf Queue struct
+ * @param  ptr  - OUT, Zeiger Variable (static) auf den Slot, NULL falls
+ *                auf dieser Seite schon ein Slot offen ist
+ * @retval void
+ * @par Example :
+ * @verbatim
+CosFifo_t frameFifo;   // COS_FifoCreate(&frameFifo, sizeof(Frame_t), 4)
+
+void rxTask(CosTask_t *pt)
+{   static Frame_t *f;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReserve(pt, &frameFifo, f);
+        _buildFrame(f);
+        COS_FifoCommit(&frameFifo);
+    }
+    COS_TASK_END(pt);
+}
+
+void handlerTask(CosTask_t *pt)
+{   static Frame_t *f;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingPeek(pt, &frameFifo, f);
+        _handleFrame(f);
+        COS_FifoRelease(&frameFifo);
+    }
+    COS_TASK_END(pt);
+}
+  @endverbatim
+ ************************************************************************/
+#define COS_FifoBlockingReserve(pt, q, ptr)   COS_SEM_WAIT(&((q)->wSema),(pt)); \
+                                              (ptr) = _qReserveSlot(q)
+
+
+
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+    Dieses Macro liefert einen Zeiger auf den aeltesten Slot direkt im
+    Puffer des FIFO. Ist das FIFO leer, blockiert die Task wie bei
+    COS_FifoBlockingReadSingleSlot(). Die Task bearbeitet die Daten an
+    Ort und Stelle und gibt den Slot mit COS_FifoRelease() frei. Bis
+    dahin lesen andere Tasks die Slots dahinter, ein zweites Peek auf
+    dasselbe FIFO liefert NULL.
+ *
+ * @see
+ * @arg  COS_FifoRelease(), COS_FifoTryPeek(), COS_FifoBlockingReserve()
+ *
+ * @par Macro Parameter: (CosTask_t *pt, CosFifo_t *q, ptr)
+ *
+ * @param  pt   - IN/OUT, Zeiger auf Task struct
+ * @param  q    - IN/OUT, Zeiger auf Queue struct
+ * @param  ptr  - OUT, Zeiger Variable (static) auf den Slot, NULL falls
+ *                auf dieser Seite schon ein Slot offen ist
+ * @retval void
+ ************************************************************************/
+#define COS_FifoBlockingPeek(pt, q, ptr)      COS_SEM_WAIT(&((q)->rSema),(pt)); \
+                                              (ptr) = _qPeekSlot(q)
+
+
+
 #endif
 
 
@@ -0,0 +1,196 @@
+/*!
+ ********************************************************************
+   @file            cos_defer.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Verschobene Arbeit von ISRs an den COS
+
+   @brief  Ringpuffer mit einem Schreiber (ISR) und einem Leser
+           (Scheduler), ohne Sperren der Interrupts.
+
+   @par Beschreibung
+   Siehe cos_defer.h. wrIndex_g schreibt nur die ISR, rdIndex_g nur der
+   Scheduler. Beide sind 8 Bit gross und werden daher in einem Zugriff
+   gelesen und geschrieben. Die Indizes laufen frei ueber 255 hinaus,
+   die Anzahl belegter Plaetze ist die Differenz modulo 256. Eine
+   Compiler-Barriere sorgt dafuer, dass der Auftrag vollstaendig im
+   Puffer steht, bevor der neue Index sichtbar wird, und gelesen ist,
+   bevor der Platz wieder freigegeben wird. Der RX63N hat nur einen
+   Kern und ordnet Speicherzugriffe nicht um.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include "cos_defer.h"
+#include "cos_systime.h"
+
+
+#if (COS_DEFER_QUEUE_LEN & (COS_DEFER_QUEUE_LEN - 1)) != 0 || COS_DEFER_QUEUE_LEN > 128
+  #error "COS_DEFER_QUEUE_LEN must be a power of two up to 128"
+#endif
+
+/*! der Compiler darf Speicherzugriffe nicht ueber diese Stelle schieben */
+#define _COMPILER_BARRIER()   __asm__ volatile ("" : : : "memory")
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static CosDeferEvent_t queue_g[COS_DEFER_QUEUE_LEN]; /*! Ringpuffer */
+static volatile uint8_t wrIndex_g=0;     /*! naechster freier Platz, nur ISR */
+static volatile uint8_t rdIndex_g=0;     /*! naechster Auftrag, nur Scheduler */
+static volatile uint16_t overflows_g=0;  /*! verlorene Auftraege, nur ISR */
+
+
+
+/*---------------------------------------------------------------*/
+static void _deferSemSignal(void *obj, uint16_t arg)
+{
+    COS_SEM_SIGNAL((CosSema_t *) obj);
+}
+/*---------------------------------------------------------------*/
+static void _deferResumeTask(void *obj, uint16_t arg)
+{
+    CosTask_t *task_pt = (CosTask_t *) obj;
+
+    if(TASK_STATE_SUSPENDED == task_pt->state)
+    {   (void) COS_ResumeTask(task_pt);
+    }
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Traegt einen Auftrag in die Defer-Queue ein, nur aus einer ISR
+       aufrufen. Der Scheduler ruft func(obj, arg) bei seinem naechsten
+       Durchlauf auf, dort sind alle COS Funktionen erlaubt. Ein
+       gerade laufendes _idleWaitTicks() wird dazu beendet.
+
+  @see COS_DeferSemSignalFromISR(), _deferDrain()
+  @param  func - IN, Funktion, laeuft im Scheduler
+  @param  obj  - IN, Objekt fuer func
+  @param  arg  - IN, Argument fuer func
+  @retval 0 fuer ok, -1 falls die Queue voll ist
+
+  @par Code-Beispiel:
+  @verbatim
+  static void _adcDone(void *obj, uint16_t value)
+  {   adcValue_g = value;
+      COS_SEM_SIGNAL(&adcSema_g);
+  }
+
+  void INT_Excep_S12AD0_S12ADI0(void)
+  {   COS_DeferFromISR(_adcDone, NULL, S12AD.ADDR0);
+  }
+  @endverbatim
+ ********************************************************************/
+int8_t COS_DeferFromISR(CosDeferFunc_t func, void *obj, uint16_t arg)
+{
+    uint8_t wr = wrIndex_g;
+    CosDeferEvent_t *e;
+
+    if((uint8_t)(wr - rdIndex_g) >= COS_DEFER_QUEUE_LEN)
+    {   overflows_g++;
+        return -1;
+    }
+    e = &queue_g[wr & (COS_DEFER_QUEUE_LEN - 1)];
+    e->func = func;
+    e->obj  = obj;
+    e->arg  = arg;
+    _COMPILER_BARRIER();   /* the event is complete before it is published */
+    wrIndex_g = (uint8_t)(wr + 1);
+    _idleWakeRequest();
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       COS_SEM_SIGNAL() fuer ISRs: der Semaphor wird beim naechsten
+       Durchlauf des Schedulers signalisiert, eine wartende Task wird
+       dann bereit.
+
+  @see COS_DeferFromISR(), COS_SEM_SIGNAL()
+  @param  s - IN/OUT, Zeiger auf Semaphor
+  @retval 0 fuer ok, -1 falls die Queue voll ist
+ ********************************************************************/
+int8_t COS_DeferSemSignalFromISR(CosSema_t *s)
+{
+    return COS_DeferFromISR(_deferSemSignal, s, 0);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       COS_ResumeTask() fuer ISRs, z.B. fuer eine Task, die sich mit
+       COS_SuspendTask() selbst angehalten hat. Nur eine dann noch
+       suspendierte Task wird fortgesetzt.
+
+  @see COS_DeferFromISR(), COS_ResumeTask()
+  @param  task_pt - IN, Zeiger auf Task-Struktur
+  @retval 0 fuer ok, -1 falls die Queue voll ist
+ ********************************************************************/
+int8_t COS_DeferResumeTaskFromISR(CosTask_t *task_pt)
+{
+    return COS_DeferFromISR(_deferResumeTask, task_pt, 0);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die Anzahl der Auftraege, die wegen voller Queue
+       verloren gingen. Ist der Wert nicht 0, COS_DEFER_QUEUE_LEN
+       vergroessern.
+
+  @param  keine
+  @retval Anzahl verlorener Auftraege
+ ********************************************************************/
+uint16_t COS_DeferGetOverflows(void)
+{
+    return overflows_g;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wird vom Scheduler am Anfang jedes Durchlaufs aufgerufen und
+       fuehrt alle Auftraege der Queue in der Reihenfolge ihres
+       Eintrags aus. Auftraege, die ISRs waehrenddessen eintragen,
+       werden auch noch ausgefuehrt.
+
+  @see COS_DeferFromISR()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void _deferDrain(void)
+{
+    uint8_t rd = rdIndex_g;
+    CosDeferEvent_t e;
+
+    while(rd != wrIndex_g)
+    {   e = queue_g[rd & (COS_DEFER_QUEUE_LEN - 1)];
+        _COMPILER_BARRIER();   /* the event is copied before the slot is freed */
+        rd = (uint8_t)(rd + 1);
+        rdIndex_g = rd;
+        e.func(e.obj, e.arg);
+    }
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,92 @@
+/*!
+ ********************************************************************
+   @file            cos_defer.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Verschobene Arbeit von ISRs an den COS
+
+   @brief  Lock-freie Queue, ueber die ISRs Semaphor-Signale und andere
+           kurze Auftraege an den Scheduler weiterreichen.
+
+
+   @section Wie funktioniert die Defer-Queue?
+                Eine ISR darf COS_SEM_SIGNAL() nicht aufrufen: die Listen
+                der Semaphoren und Queues des Schedulers sind nicht gegen
+                Interrupts geschuetzt. Stattdessen traegt die ISR mit
+                COS_DeferSemSignalFromISR() bzw. COS_DeferFromISR() einen
+                kleinen Auftrag (Funktion, Objekt, 16 Bit Argument) in
+                einen Ringpuffer ein. Der Scheduler arbeitet den Puffer
+                am Anfang jedes Durchlaufs mit _deferDrain() ab und ruft
+                die Funktionen im Kontext der Tasks auf, z.B.
+                COS_SEM_SIGNAL(). Die wartende Task wird dadurch bereit,
+                ohne dass eine Task die Hardware abfragen muss.
+
+                Der Ringpuffer hat genau einen Schreiber (die ISRs) und
+                einen Leser (den Scheduler). Jeder Index wird nur von
+                einer Seite geschrieben, daher braucht keine Seite die
+                Interrupts zu sperren. Das gilt, solange sich die ISRs
+                nicht gegenseitig unterbrechen: auf dem RX63N sperrt die
+                CPU beim Eintritt in eine ISR die Interrupts, eine ISR
+                darf das I-Flag vor COS_DeferFromISR() also nicht wieder
+                setzen. Tasks rufen COS_SEM_SIGNAL() direkt auf.
+
+                Ist der Puffer voll, geht der Auftrag verloren,
+                COS_DeferGetOverflows() zaehlt diese Faelle.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_defer_h_
+#define _cos_defer_h_
+
+
+#include "cos_types.h"
+#include "cos_scheduler.h"
+#include "cos_semaphore.h"
+
+
+/*! 1: der Scheduler arbeitet die Defer-Queue ab, 0: kein Code im Scheduler */
+#define COS_DEFER                1
+/*! Anzahl der Auftraege im Ringpuffer, Zweierpotenz bis 128 */
+#define COS_DEFER_QUEUE_LEN      32
+
+
+/*! Funktion eines Auftrags, laeuft im Scheduler (Kontext der Tasks) */
+typedef void (*CosDeferFunc_t)(void *obj, uint16_t arg);
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Ein Auftrag in der Defer-Queue.
+ ********************************************************************/
+typedef struct {
+        CosDeferFunc_t func;  /*!< aufzurufende Funktion */
+        void *obj;            /*!< z.B. Semaphor oder Task */
+        uint16_t arg;         /*!< Argument */
+} CosDeferEvent_t;
+
+
+int8_t   COS_DeferFromISR(CosDeferFunc_t func, void *obj, uint16_t arg);
+int8_t   COS_DeferSemSignalFromISR(CosSema_t *s);
+int8_t   COS_DeferResumeTaskFromISR(CosTask_t *task_pt);
+uint16_t COS_DeferGetOverflows(void);
+
+/* intern: Scheduler */
+void     _deferDrain(void);
+
+
+#endif
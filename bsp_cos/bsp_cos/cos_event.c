@@ -0,0 +1,350 @@
+/*!
+ ********************************************************************
+   @file            cos_event.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Event-Flags und Mailbox fuer den COS
+
+   @brief  Implementierung von CosEvent_t und CosMailbox_t.
+
+   @par Beschreibung
+   Siehe cos_event.h. Die Flags duerfen auch von ISRs gesetzt werden,
+   daher wird jedes Lesen-Aendern-Schreiben der Flags mit kurz
+   gesperrten Interrupts gemacht. Das Wecken der Task geschieht immer
+   im Kontext der Tasks, aus ISRs ueber die Defer-Queue.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include "cos_event.h"
+#include "cos_defer.h"
+#include "cos_systime.h"
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die erfuellten Flags fuer mask und mode, 0 falls die
+       Bedingung nicht erfuellt ist.
+ ********************************************************************/
+static uint32_t _eventMatch(uint32_t flags, uint32_t mask, uint8_t mode)
+{
+    uint32_t got = flags & mask;
+
+    if((mode & COS_EVENT_ALL) && (got != mask))
+    {   return 0;
+    }
+    return got;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Nimmt die erste Task aus einer Warteliste und macht sie bereit.
+ ********************************************************************/
+static void _wakeFirst(CosTask_t *root_pt)
+{
+    if(NULL != root_pt)
+    {   _unlinkTaskFromWaitList(root_pt);
+        if(TASK_STATE_BLOCKED == root_pt->state)
+        {   _makeTaskReady(root_pt);
+        }
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Weckt in der Reihenfolge der Warteliste jede Task, deren
+       Bedingung jetzt erfuellt ist. Flags, die eine geweckte Task mit
+       COS_EVENT_CLEAR verbrauchen wird, zaehlen fuer die folgenden
+       nicht mehr. Die Tasks pruefen beim Weiterlaufen selbst noch
+       einmal.
+ ********************************************************************/
+static void _eventWakeWaiters(CosEvent_t *e)
+{
+    CosTask_t *task_pt = e->root_pt;
+    CosTask_t *next_pt;
+    uint32_t avail = e->flags;
+    uint32_t got;
+
+    while((NULL != task_pt) && (0 != avail))
+    {   next_pt = task_pt->waitNext_pt;
+        got = _eventMatch(avail, task_pt->eventMask, task_pt->eventMode);
+        if(0 != got)
+        {   if(task_pt->eventMode & COS_EVENT_CLEAR)
+            {   avail &= ~got;
+            }
+            _unlinkTaskFromWaitList(task_pt);
+            if(TASK_STATE_BLOCKED == task_pt->state)
+            {   _makeTaskReady(task_pt);
+            }
+        }
+        task_pt = next_pt;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _eventDeferredWake(void *obj, uint16_t arg)
+{
+    _eventWakeWaiters((CosEvent_t *) obj);
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Initialisiert eine Event-Flag-Gruppe, alle Flags geloescht.
+
+  @param  e - OUT, Zeiger auf CosEvent_t
+  @retval keine
+ ********************************************************************/
+void COS_EventInit(CosEvent_t *e)
+{
+    e->flags = 0;
+    e->root_pt = NULL;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt Flags und weckt die wartenden Tasks, deren Bedingung
+       damit erfuellt ist. Nur aus Tasks aufrufen.
+
+  @see COS_EventSetFromISR(), COS_EVENT_WAIT()
+  @param  e    - IN/OUT, Zeiger auf CosEvent_t
+  @param  bits - IN, zu setzende Flags
+  @retval keine
+ ********************************************************************/
+void COS_EventSet(CosEvent_t *e, uint32_t bits)
+{
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    e->flags |= bits;
+    COS_IRQ_RESTORE(psw);
+    COS_TRACE_EVENT(COS_TRACE_SIGNAL, e, bits);
+    _eventWakeWaiters(e);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt Flags aus einer ISR. Die Flags gelten sofort, die
+       wartenden Tasks werden ueber die Defer-Queue im naechsten Durchlauf
+       des Schedulers geweckt.
+
+  @see COS_EventSet(), COS_DeferFromISR()
+  @param  e    - IN/OUT, Zeiger auf CosEvent_t
+  @param  bits - IN, zu setzende Flags
+  @retval 0 fuer ok, -1 falls die Defer-Queue voll ist (die Flags
+          sind trotzdem gesetzt)
+ ********************************************************************/
+int8_t COS_EventSetFromISR(CosEvent_t *e, uint32_t bits)
+{
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    e->flags |= bits;
+    COS_IRQ_RESTORE(psw);
+    return COS_DeferFromISR(_eventDeferredWake, e, 0);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Loescht Flags.
+
+  @param  e    - IN/OUT, Zeiger auf CosEvent_t
+  @param  bits - IN, zu loeschende Flags
+  @retval keine
+ ********************************************************************/
+void COS_EventClear(CosEvent_t *e, uint32_t bits)
+{
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    e->flags &= ~bits;
+    COS_IRQ_RESTORE(psw);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die gesetzten Flags, ohne sie zu aendern.
+
+  @param  e - IN, Zeiger auf CosEvent_t
+  @retval Flags
+ ********************************************************************/
+uint32_t COS_EventGet(CosEvent_t *e)
+{
+    return e->flags;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Kern von COS_EVENT_WAIT(): ist die Bedingung erfuellt, werden
+       die Flags ggf. geloescht und zurueckgegeben. Sonst wird die Task
+       mit Maske und Modus hinten in die Warteliste eingetragen und
+       blockiert.
+
+  @param  e    - IN/OUT, Zeiger auf CosEvent_t
+  @param  mask - IN, Flags, auf die gewartet wird
+  @param  mode - IN, COS_EVENT_ANY oder COS_EVENT_ALL, evtl. | COS_EVENT_CLEAR
+  @param  pt   - IN, Zeiger auf die laufende Task
+  @retval erfuellte Flags, 0 falls die Task warten muss
+ ********************************************************************/
+uint32_t _eventWait(CosEvent_t *e, uint32_t mask, uint8_t mode, CosTask_t *pt)
+{
+    uint32_t got;
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    got = _eventMatch(e->flags, mask, mode);
+    if(0 != got)
+    {   if(mode & COS_EVENT_CLEAR)
+        {   e->flags &= ~got;
+        }
+        COS_IRQ_RESTORE(psw);
+        _unlinkTaskFromWaitList(pt);   /* no-op unless still queued */
+        return got;
+    }
+    COS_IRQ_RESTORE(psw);
+    pt->eventMask = mask;
+    pt->eventMode = mode;
+    if(NULL == pt->waitRoot_pp)
+    {   _addTaskToWaitList(&e->root_pt, pt);
+    }
+    pt->state = TASK_STATE_BLOCKED;
+    COS_TRACE_EVENT(COS_TRACE_BLOCK, e, 0);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Initialisiert eine leere Mailbox.
+
+  @param  m - OUT, Zeiger auf CosMailbox_t
+  @retval keine
+ ********************************************************************/
+void COS_MboxInit(CosMailbox_t *m)
+{
+    m->msg = NULL;
+    m->full = 0;
+    m->receiverRoot_pt = NULL;
+    m->senderRoot_pt = NULL;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Legt eine Nachricht in die Mailbox, ohne zu blockieren, und
+       weckt den ersten wartenden Empfaenger. Nur aus Tasks aufrufen.
+
+  @see COS_MBOX_POST()
+  @param  m   - IN/OUT, Zeiger auf CosMailbox_t
+  @param  msg - IN, Nachricht
+  @retval 0 fuer ok, -1 falls die Mailbox voll ist
+ ********************************************************************/
+int8_t COS_MboxTryPost(CosMailbox_t *m, void *msg)
+{
+    if(m->full)
+    {   return -1;
+    }
+    m->msg = msg;
+    m->full = 1;
+    COS_TRACE_EVENT(COS_TRACE_SIGNAL, m, 1);
+    _wakeFirst(m->receiverRoot_pt);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Holt eine Nachricht aus der Mailbox, ohne zu blockieren, und
+       weckt den ersten wartenden Sender.
+
+  @see COS_MBOX_PEND()
+  @param  m      - IN/OUT, Zeiger auf CosMailbox_t
+  @param  msg_pp - OUT, Zeiger auf die Variable fuer die Nachricht
+  @retval 0 fuer ok, -1 falls die Mailbox leer ist
+ ********************************************************************/
+int8_t COS_MboxTryPend(CosMailbox_t *m, void **msg_pp)
+{
+    if(!m->full)
+    {   return -1;
+    }
+    *msg_pp = m->msg;
+    m->full = 0;
+    COS_TRACE_EVENT(COS_TRACE_SIGNAL, m, 0);
+    _wakeFirst(m->senderRoot_pt);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Kern von COS_MBOX_POST(): sendet oder traegt die Task hinten in
+       die Warteliste der Sender ein und blockiert sie.
+
+  @retval 1 falls gesendet, 0 falls die Task warten muss
+ ********************************************************************/
+uint8_t _mboxPost(CosMailbox_t *m, void *msg, CosTask_t *pt)
+{
+    if(0 == COS_MboxTryPost(m, msg))
+    {   _unlinkTaskFromWaitList(pt);   /* no-op unless still queued */
+        return 1;
+    }
+    if(NULL == pt->waitRoot_pp)
+    {   _addTaskToWaitList(&m->senderRoot_pt, pt);
+    }
+    pt->state = TASK_STATE_BLOCKED;
+    COS_TRACE_EVENT(COS_TRACE_BLOCK, m, 0);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Kern von COS_MBOX_PEND(): empfaengt oder traegt die Task hinten
+       in die Warteliste der Empfaenger ein und blockiert sie.
+
+  @retval 1 falls empfangen, 0 falls die Task warten muss
+ ********************************************************************/
+uint8_t _mboxPend(CosMailbox_t *m, void **msg_pp, CosTask_t *pt)
+{
+    if(0 == COS_MboxTryPend(m, msg_pp))
+    {   _unlinkTaskFromWaitList(pt);   /* no-op unless still queued */
+        return 1;
+    }
+    if(NULL == pt->waitRoot_pp)
+    {   _addTaskToWaitList(&m->receiverRoot_pt, pt);
+    }
+    pt->state = TASK_STATE_BLOCKED;
+    COS_TRACE_EVENT(COS_TRACE_BLOCK, m, 0);
+    return 0;
+}
+/*---------------------------------------------------------------*/
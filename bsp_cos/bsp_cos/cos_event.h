@@ -0,0 +1,218 @@
+/*!
+ ********************************************************************
+   @file            cos_event.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Event-Flags und Mailbox fuer den COS
+
+   @brief  Event-Flag-Gruppen (32 Bit, auf eines oder alle warten) und
+           eine Mailbox mit einem Platz, ohne Speicher pro Warten.
+
+
+   @section Wie funktionieren Event-Flags und Mailbox?
+                Eine Event-Flag-Gruppe CosEvent_t hat 32 Flags.
+                COS_EVENT_WAIT() wartet, bis eines (COS_EVENT_ANY) oder
+                alle (COS_EVENT_ALL) Flags einer Maske gesetzt sind, mit
+                COS_EVENT_CLEAR werden die erfuellten Flags dabei
+                geloescht. COS_EventSet() setzt Flags, aus einer ISR
+                COS_EventSetFromISR().
+
+                Eine Mailbox CosMailbox_t nimmt genau eine Nachricht
+                (void Zeiger) auf. COS_MBOX_POST() wartet, bis der Platz
+                frei ist, COS_MBOX_PEND() wartet auf eine Nachricht.
+
+                Wartende Tasks stehen in einer Warteliste am Objekt (bei
+                der Mailbox je eine fuer Sender und Empfaenger), in der
+                Reihenfolge ihres Eintreffens. Die Liste benutzt die
+                Zeiger in CosTask_t wie die Semaphoren, ohne malloc().
+                COS_EventSet() prueft nur die Bedingungen der Wartenden
+                und weckt jede, deren Bedingung erfuellt ist; Flags, die
+                eine geweckte Task mit COS_EVENT_CLEAR verbraucht,
+                wecken keine weitere. Die Mailbox weckt beim Senden den
+                ersten wartenden Empfaenger, beim Abholen den ersten
+                wartenden Sender. Eine geweckte Task prueft die
+                Bedingung beim Weiterlaufen noch einmal, hat eine andere
+                Task die Flags bzw. die Nachricht inzwischen genommen,
+                stellt sie sich wieder hinten an.
+
+                Eine wartende Task darf geloescht werden, sie wird dabei
+                aus der Warteliste genommen.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_event_h_
+#define _cos_event_h_
+
+
+#include "cos_scheduler.h"
+#include "cos_linear_task_list.h"
+#include "cos_trace.h"
+
+
+/* Modus fuer COS_EVENT_WAIT(), COS_EVENT_CLEAR darf dazu ge-odert werden */
+#define COS_EVENT_ANY            0  /*!< mindestens ein Flag der Maske */
+#define COS_EVENT_ALL            1  /*!< alle Flags der Maske */
+#define COS_EVENT_CLEAR          2  /*!< erfuellte Flags beim Aufwachen loeschen */
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Event-Flag-Gruppe mit 32 Flags. Maske und Modus einer wartenden
+  Task stehen in ihrem CosTask_t (eventMask, eventMode).
+ ********************************************************************/
+typedef struct {
+        volatile uint32_t flags;  /*!< gesetzte Flags */
+        CosTask_t *root_pt;       /*!< Warteliste, NULL falls niemand wartet */
+} CosEvent_t;
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Mailbox mit einem Platz fuer einen Zeiger.
+ ********************************************************************/
+typedef struct {
+        void *msg;                /*!< Nachricht, gueltig falls full */
+        uint8_t full;             /*!< 1: Nachricht liegt bereit */
+        CosTask_t *receiverRoot_pt; /*!< Warteliste der Empfaenger */
+        CosTask_t *senderRoot_pt;   /*!< Warteliste der Sender */
+} CosMailbox_t;
+
+
+void     COS_EventInit(CosEvent_t *e);
+void     COS_EventSet(CosEvent_t *e, uint32_t bits);
+int8_t   COS_EventSetFromISR(CosEvent_t *e, uint32_t bits);
+void     COS_EventClear(CosEvent_t *e, uint32_t bits);
+uint32_t COS_EventGet(CosEvent_t *e);
+
+void     COS_MboxInit(CosMailbox_t *m);
+int8_t   COS_MboxTryPost(CosMailbox_t *m, void *msg);
+int8_t   COS_MboxTryPend(CosMailbox_t *m, void **msg_pp);
+
+/* intern, nur ueber die Macros benutzen */
+uint32_t _eventWait(CosEvent_t *e, uint32_t mask, uint8_t mode, CosTask_t *pt);
+uint8_t  _mboxPost(CosMailbox_t *m, void *msg, CosTask_t *pt);
+uint8_t  _mboxPend(CosMailbox_t *m, void **msg_pp, CosTask_t *pt);
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro laesst eine Task auf Flags einer Event-Gruppe warten.
+  Ist die Bedingung erfuellt, laeuft die Task sofort weiter, sonst
+  blockiert sie, bis COS_EventSet() die Bedingung erfuellt. Die
+  erfuellten Flags (bei COS_EVENT_ANY evtl. mehrere) stehen danach in
+  result, bei COS_EVENT_CLEAR sind sie in der Gruppe geloescht.
+
+@see COS_EventSet()
+@param e      - IN/OUT, Zeiger auf CosEvent_t
+@param mask   - IN, Flags, auf die gewartet wird, nicht 0
+@param mode   - IN, COS_EVENT_ANY oder COS_EVENT_ALL, evtl. | COS_EVENT_CLEAR
+@param result - OUT, uint32_t Variable (static), erfuellte Flags
+@param pt     - IN, Zeiger auf Task-Struktur
+
+@par Code Beispiel:
+@verbatim
+#define EV_RX    0x01
+#define EV_TIMEOUT 0x02
+CosEvent_t ev;
+...
+void myTask(CosTask_t *pt)
+{   static uint32_t got;
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_EVENT_WAIT(&ev, EV_RX|EV_TIMEOUT, COS_EVENT_ANY|COS_EVENT_CLEAR, got, pt);
+        if(got & EV_RX)
+        {   ...
+        }
+    }
+    COS_TASK_END(pt);
+}
+@endverbatim
+********************************************************************/
+#define COS_EVENT_WAIT(e,mask,mode,result,pt)  (pt)->lineCnt=__LINE__;\
+                            if(0) {\
+                              case __LINE__: ;\
+                            }\
+                            if(0 == ((result) = _eventWait((e),(mask),(mode),(pt)))) {\
+                              return;\
+                            }
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro legt eine Nachricht in die Mailbox. Ist der Platz
+  belegt, blockiert die Task, bis der Empfaenger die alte Nachricht
+  abgeholt hat. msg wird beim Weiterlaufen erneut ausgewertet, muss
+  also z.B. eine static Variable sein.
+
+@see COS_MBOX_PEND(), COS_MboxTryPost()
+@param m   - IN/OUT, Zeiger auf CosMailbox_t
+@param msg - IN, Nachricht (void Zeiger)
+@param pt  - IN, Zeiger auf Task-Struktur
+********************************************************************/
+#define COS_MBOX_POST(m,msg,pt)  (pt)->lineCnt=__LINE__;\
+                            if(0) {\
+                              case __LINE__: ;\
+                            }\
+                            if(0 == _mboxPost((m),(msg),(pt))) {\
+                              return;\
+                            }
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro holt eine Nachricht aus der Mailbox. Ist sie leer,
+  blockiert die Task, bis eine Nachricht kommt. Eine Task, die mit
+  COS_MBOX_POST() auf den freien Platz wartet, wird dabei geweckt.
+
+@see COS_MBOX_POST()
+@param m   - IN/OUT, Zeiger auf CosMailbox_t
+@param msg - OUT, void Zeiger Variable (static) fuer die Nachricht
+@param pt  - IN, Zeiger auf Task-Struktur
+
+@par Code Beispiel:
+@verbatim
+CosMailbox_t mbox;
+...
+void consumer(CosTask_t *pt)
+{   static void *msg;
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_MBOX_PEND(&mbox, msg, pt);
+        _handle((Frame_t *) msg);
+    }
+    COS_TASK_END(pt);
+}
+@endverbatim
+********************************************************************/
+#define COS_MBOX_PEND(m,msg,pt)  (pt)->lineCnt=__LINE__;\
+                            if(0) {\
+                              case __LINE__: ;\
+                            }\
+                            if(0 == _mboxPend((m),&(msg),(pt))) {\
+                              return;\
+                            }
+
+
+#endif
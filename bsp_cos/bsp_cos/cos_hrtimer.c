@@ -0,0 +1,393 @@
+/*!
+ ********************************************************************
+   @file            cos_hrtimer.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : hochaufloesende One-Shot Timer fuer den COS
+
+   @brief  Sortierte Queue der HR-Timer, Ablauf in der ISR von CMT1 und
+           Wecken der Tasks im Scheduler.
+
+   @par Beschreibung
+   Siehe cos_hrtimer.h. Die Queue wird von Tasks und von der ISR
+   geaendert, jeder Zugriff sperrt daher kurz die Interrupts. Der
+   Vergleich zweier Zeitpunkte rechnet mit der Differenz als int32_t und
+   bleibt beim Ueberlauf von _getCycles() richtig.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include "cos_hrtimer.h"
+#include "cos_systime.h"
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static CosHrTimer_t *queue_g=NULL;      /*! laufende Timer, nach Ablauf sortiert */
+static CosHrTimer_t * volatile firedHead_g=NULL; /*! abgelaufene Task-Timer, Anfang */
+static CosHrTimer_t *firedTail_g=NULL;  /*! abgelaufene Task-Timer, Ende */
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Stellt CMT1 auf den Ablauf des ersten Timers der Queue oder
+       haelt CMT1 an, wenn die Queue leer ist. Laufen weitere Timer
+       hoechstens COS_HRTIMER_SLACK_US nach dem ersten ab, wird CMT1
+       auf den letzten davon gestellt: alle laufen dann mit einem
+       Interrupt ab, keiner zu frueh und keiner mehr als die Slack zu
+       spaet. Ein schon abgelaufener Timer loest sofort einen Interrupt
+       aus. Nur bei gesperrten Interrupts aufrufen.
+
+  @param  now - IN, aktuelle Zeit, _getCycles()
+  @retval keine
+ ********************************************************************/
+static void _hrArmHead(uint32_t now)
+{
+    CosHrTimer_t *t;
+    uint32_t slack = _microSecToCycles(COS_HRTIMER_SLACK_US);
+    uint32_t at;
+    int32_t diff;
+
+    if(NULL == queue_g)
+    {   _hrTimerStop();
+        return;
+    }
+    at = queue_g->expiry_Cycles;
+    for(t = queue_g->next_pt; (NULL != t) &&
+        ((t->expiry_Cycles - queue_g->expiry_Cycles) <= slack); t = t->next_pt)
+    {   at = t->expiry_Cycles;   /* coalesce */
+    }
+    diff = (int32_t)(at - now);
+    _hrTimerArm((diff > 0) ? (uint32_t) diff : 1);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Sortiert einen Timer in die Queue ein, hinter alle Timer mit
+       gleichem oder frueherem Ablauf. Nur bei gesperrten Interrupts
+       aufrufen.
+
+  @param  t - IN/OUT, Zeiger auf den Timer
+  @retval keine
+ ********************************************************************/
+static void _hrInsert(CosHrTimer_t *t)
+{
+    CosHrTimer_t **pp = &queue_g;
+
+    while((NULL != *pp) && ((int32_t)((*pp)->expiry_Cycles - t->expiry_Cycles) <= 0))
+    {   pp = &((*pp)->next_pt);
+    }
+    t->next_pt = *pp;
+    *pp = t;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Traegt einen Timer mit der Wartezeit delay_us ein und stellt
+       CMT1 neu, falls er jetzt als erster oder innerhalb der Slack
+       des ersten ablaeuft.
+
+  @param  t        - IN/OUT, Zeiger auf den Timer
+  @param  delay_us - IN, Wartezeit in us
+  @retval 0 fuer ok, -1 falls der Timer schon laeuft oder die Zeit zu
+          lang ist
+ ********************************************************************/
+static int8_t _hrStart(CosHrTimer_t *t, uint32_t delay_us)
+{
+    uint32_t now;
+    uint32_t psw;
+
+    if(delay_us > COS_HRTIMER_MAX_US)
+    {   return -1;
+    }
+    COS_IRQ_SAVE(psw);
+    if(COS_HRTIMER_IDLE != t->state)
+    {   COS_IRQ_RESTORE(psw);
+        return -1;
+    }
+    now = _getCycles();
+    t->expiry_Cycles = now + _microSecToCycles(delay_us);
+    t->state = COS_HRTIMER_ACTIVE;
+    _hrInsert(t);
+    if((queue_g == t) ||
+       ((t->expiry_Cycles - queue_g->expiry_Cycles) <= _microSecToCycles(COS_HRTIMER_SLACK_US)))
+    {   _hrArmHead(now);
+    }
+    COS_IRQ_RESTORE(psw);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Initialisiert einen Timer im Zustand COS_HRTIMER_IDLE. Einmal vor
+       der ersten Benutzung aufrufen, statische Timer sind auch ohne
+       diesen Aufruf richtig initialisiert.
+
+  @param  t - OUT, Zeiger auf den Timer
+  @retval keine
+ ********************************************************************/
+void COS_HrTimerInit(CosHrTimer_t *t)
+{
+    t->next_pt = NULL;
+    t->expiry_Cycles = 0;
+    t->func = NULL;
+    t->arg = NULL;
+    t->task_pt = NULL;
+    t->state = COS_HRTIMER_IDLE;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Startet einen One-Shot Timer, der nach delay_us Mikrosekunden
+       die Funktion func(arg) in der ISR von CMT1 aufruft. Der Timer ist
+       beim Aufruf von func schon wieder COS_HRTIMER_IDLE, func darf ihn
+       also fuer einen periodischen Ablauf neu starten.
+
+  @see COS_HrTimerCancel(), COS_HrTimerWakeTask()
+  @param  t        - IN/OUT, Zeiger auf den Timer
+  @param  delay_us - IN, Wartezeit in us, hoechstens COS_HRTIMER_MAX_US
+  @param  func     - IN, Callback, laeuft in der ISR
+  @param  arg      - IN, Argument fuer func
+  @retval 0 fuer ok, -1 falls der Timer schon laeuft oder die Zeit zu
+          lang ist
+
+  @par Code-Beispiel:
+  @verbatim
+  static CosHrTimer_t strobe;
+
+  static void _strobeOff(void *arg)
+  {   PORTD.PODR.BIT.B0 = 1;
+  }
+  ...
+  PORTD.PODR.BIT.B0 = 0;
+  COS_HrTimerStart(&strobe, 50, _strobeOff, NULL);
+  @endverbatim
+ ********************************************************************/
+int8_t COS_HrTimerStart(CosHrTimer_t *t, uint32_t delay_us,
+                        void (*func)(void *arg), void *arg)
+{
+    if(COS_HRTIMER_IDLE != t->state)
+    {   return -1;
+    }
+    t->func = func;
+    t->arg = arg;
+    t->task_pt = NULL;
+    return _hrStart(t, delay_us);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Blockiert die Task task_pt fuer delay_us Mikrosekunden. Nach dem
+       Ablauf macht der Scheduler die Task bei seinem naechsten
+       Durchlauf wieder bereit. Nur fuer die gerade laufende Task,
+       normalerweise ueber das Macro COS_HRTIMER_SLEEP().
+
+  @see COS_HRTIMER_SLEEP()
+  @param  t        - IN/OUT, Zeiger auf den Timer
+  @param  delay_us - IN, Wartezeit in us, hoechstens COS_HRTIMER_MAX_US
+  @param  task_pt  - IN, Zeiger auf die laufende Task
+  @retval 0 fuer ok, -1 falls der Timer schon laeuft oder die Zeit zu
+          lang ist, die Task bleibt dann bereit
+ ********************************************************************/
+int8_t COS_HrTimerWakeTask(CosHrTimer_t *t, uint32_t delay_us, CosTask_t *task_pt)
+{
+    if(COS_HRTIMER_IDLE != t->state)
+    {   return -1;
+    }
+    t->func = NULL;
+    t->arg = NULL;
+    t->task_pt = task_pt;
+    if(0 != _hrStart(t, delay_us))
+    {   t->task_pt = NULL;
+        return -1;
+    }
+    task_pt->state = TASK_STATE_BLOCKED;
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Haelt einen Timer an. Ein Callback wird nicht mehr aufgerufen,
+       eine wartende Task wird sofort bereit. Nur aus Tasks aufrufen,
+       nicht aus einem Callback. Vor dem Loeschen einer Task mit
+       laufendem Timer muss der Timer angehalten werden.
+
+  @see COS_HrTimerStart()
+  @param  t - IN/OUT, Zeiger auf den Timer
+  @retval 0 fuer ok, -1 falls der Timer nicht lief
+ ********************************************************************/
+int8_t COS_HrTimerCancel(CosHrTimer_t *t)
+{
+    CosHrTimer_t **pp;
+    CosHrTimer_t *prev_pt = NULL;
+    CosTask_t *task_pt;
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    if(COS_HRTIMER_ACTIVE == t->state)
+    {   for(pp = &queue_g; (NULL != *pp) && (*pp != t); pp = &((*pp)->next_pt))
+        {   /* search */
+        }
+        if(NULL != *pp)
+        {   *pp = t->next_pt;
+        }
+        if(pp == &queue_g)
+        {   _hrArmHead(_getCycles());   /* t was the first one */
+        }
+    }
+    else if(COS_HRTIMER_FIRED == t->state)
+    {   for(pp = (CosHrTimer_t **) &firedHead_g; (NULL != *pp) && (*pp != t);
+            pp = &((*pp)->next_pt))
+        {   prev_pt = *pp;
+        }
+        if(NULL != *pp)
+        {   *pp = t->next_pt;
+        }
+        if(firedTail_g == t)
+        {   firedTail_g = prev_pt;
+        }
+    }
+    else
+    {   COS_IRQ_RESTORE(psw);
+        return -1;
+    }
+    task_pt = t->task_pt;
+    t->next_pt = NULL;
+    t->task_pt = NULL;
+    t->state = COS_HRTIMER_IDLE;
+    COS_IRQ_RESTORE(psw);
+    if((NULL != task_pt) && (TASK_STATE_BLOCKED == task_pt->state))
+    {   _makeTaskReady(task_pt);
+    }
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert, ob der Timer laeuft oder seine Task noch geweckt wird.
+
+  @param  t - IN, Zeiger auf den Timer
+  @retval 1 falls aktiv, sonst 0
+ ********************************************************************/
+uint8_t COS_HrTimerIsActive(CosHrTimer_t *t)
+{
+    return (COS_HRTIMER_IDLE != t->state) ? 1 : 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wird von der ISR von CMT1 aufgerufen. Nimmt alle abgelaufenen
+       Timer aus der Queue: Callbacks werden sofort aufgerufen,
+       Task-Timer werden an die Liste fuer _hrTimerWakeTasks()
+       angehaengt. Danach wird CMT1 auf den naechsten Timer gestellt.
+       Ist CMT1 vor dem ersten Timer abgelaufen (Zaehlerbereich von
+       16 Bit), wird nur neu gestellt.
+
+  @see _hrTimerWakeTasks()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void _hrTimerExpired(void)
+{
+    CosHrTimer_t *t;
+    uint32_t now;
+    uint32_t psw;
+    uint8_t  wake = 0;
+
+    COS_IRQ_SAVE(psw);
+    now = _getCycles();
+    while((NULL != queue_g) && ((int32_t)(queue_g->expiry_Cycles - now) <= 0))
+    {   t = queue_g;
+        queue_g = t->next_pt;
+        t->next_pt = NULL;
+        if(NULL != t->task_pt)
+        {   t->state = COS_HRTIMER_FIRED;
+            if(NULL == firedTail_g)
+            {   firedHead_g = t;
+            }
+            else
+            {   firedTail_g->next_pt = t;
+            }
+            firedTail_g = t;
+            wake = 1;
+        }
+        else
+        {   t->state = COS_HRTIMER_IDLE;
+            if(NULL != t->func)
+            {   t->func(t->arg);
+                now = _getCycles();   /* the callback took some time */
+            }
+        }
+    }
+    _hrArmHead(now);
+    COS_IRQ_RESTORE(psw);
+    if(wake)
+    {   _idleWakeRequest();   /* do not sleep on with tasks to wake */
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wird vom Scheduler am Anfang jedes Durchlaufs aufgerufen und
+       macht die Tasks der abgelaufenen Task-Timer bereit. Eine Task,
+       die inzwischen nicht mehr blockiert ist (z.B. suspendiert),
+       bleibt unveraendert.
+
+  @see _hrTimerExpired(), _makeTaskReady()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void _hrTimerWakeTasks(void)
+{
+    CosHrTimer_t *t;
+    CosTask_t *task_pt;
+    uint32_t psw;
+
+    while(NULL != firedHead_g)
+    {   COS_IRQ_SAVE(psw);
+        t = firedHead_g;
+        firedHead_g = t->next_pt;
+        if(NULL == firedHead_g)
+        {   firedTail_g = NULL;
+        }
+        task_pt = t->task_pt;
+        t->next_pt = NULL;
+        t->task_pt = NULL;
+        t->state = COS_HRTIMER_IDLE;
+        COS_IRQ_RESTORE(psw);
+        if(TASK_STATE_BLOCKED == task_pt->state)
+        {   _makeTaskReady(task_pt);
+        }
+    }
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,147 @@
+/*!
+ ********************************************************************
+   @file            cos_hrtimer.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : hochaufloesende One-Shot Timer fuer den COS
+
+   @brief  Timer mit Mikrosekunden-Aufloesung auf CMT1, fuer Callbacks
+           und zum Wecken von Tasks unterhalb eines Ticks.
+
+
+   @section Wie funktionieren die HR-Timer?
+                Der Tick von CMT0 (1 ms) ist die feinste Zeit, nach der
+                COS_TASK_SLEEP() eine Task weckt. Fuer kuerzere Zeiten
+                gibt es die HR-Timer: der Aufrufer stellt eine
+                CosHrTimer_t Struktur bereit, COS_HrTimerStart() bzw.
+                COS_HrTimerWakeTask() sortieren sie nach ihrem Ablauf-
+                zeitpunkt in eine Queue ein. Compare-Match-Timer CMT1
+                wird als One-Shot immer nur auf den ersten Timer der
+                Queue gestellt, die Tick-Rate bleibt unveraendert. Die
+                Zeit zaehlt in den Schritten von _getCycles() (PCLKB/8).
+
+                Ein Timer mit Callback ruft seine Funktion in der ISR von
+                CMT1 auf, sie muss kurz sein und darf nur ISR-feste
+                Funktionen benutzen (COS_HrTimerStart() ist erlaubt).
+                Ein Timer, der eine Task weckt, wird in der ISR nur in
+                eine Liste geweckter Timer umgehaengt: der Scheduler ruft
+                am Anfang jedes Durchlaufs _hrTimerWakeTasks() auf und
+                macht die Tasks dort bereit, denn die Queues des
+                Schedulers sind nicht gegen Interrupts geschuetzt.
+
+                Timer, deren Ablauf hoechstens COS_HRTIMER_SLACK_US nach
+                dem ersten Timer der Queue liegt, laufen mit einem
+                Interrupt ab: CMT1 wird auf den letzten davon gestellt.
+                Ein Timer laeuft dadurch nie frueher, aber bis zu
+                COS_HRTIMER_SLACK_US spaeter ab. Mit 0 wird nur bei
+                gleichem Ablauf zusammengelegt.
+
+                Die Hardware-Funktionen (_hrTimerArm(), _hrTimerStop(),
+                ISR) stehen in cos_systime.c, im Host-Port in cos_host.c.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_hrtimer_h_
+#define _cos_hrtimer_h_
+
+
+#include "cos_types.h"
+#include "cos_scheduler.h"
+
+
+/*! 1: der Scheduler weckt Tasks der HR-Timer, 0: kein Code im Scheduler */
+#define COS_HRTIMER              1
+/*! so viel spaeter darf ein Timer ablaufen, um Interrupts zu sparen, in us */
+#define COS_HRTIMER_SLACK_US     10
+/*! laengste Wartezeit in us, fuer laengere Zeiten COS_TASK_SLEEP() benutzen */
+#define COS_HRTIMER_MAX_US       60000000UL
+
+
+/* Zustand eines Timers */
+#define COS_HRTIMER_IDLE         0  /*!< nicht eingetragen */
+#define COS_HRTIMER_ACTIVE       1  /*!< in der Queue, laeuft */
+#define COS_HRTIMER_FIRED        2  /*!< abgelaufen, Task wird im Scheduler geweckt */
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Ein HR-Timer. Der Speicher gehoert dem Aufrufer und muss gueltig
+  bleiben, solange der Timer nicht COS_HRTIMER_IDLE ist.
+ ********************************************************************/
+typedef struct CosHrTimer_s {
+        struct CosHrTimer_s *next_pt;  /*!< naechster Timer der Queue */
+        uint32_t expiry_Cycles;        /*!< Ablaufzeitpunkt, _getCycles() */
+        void (*func)(void *arg);       /*!< Callback in der ISR oder NULL */
+        void *arg;                     /*!< Argument fuer func */
+        CosTask_t *task_pt;            /*!< zu weckende Task oder NULL */
+        volatile uint8_t state;        /*!< COS_HRTIMER_IDLE ... */
+} CosHrTimer_t;
+
+
+void    COS_HrTimerInit(CosHrTimer_t *t);
+int8_t  COS_HrTimerStart(CosHrTimer_t *t, uint32_t delay_us,
+                         void (*func)(void *arg), void *arg);
+int8_t  COS_HrTimerWakeTask(CosHrTimer_t *t, uint32_t delay_us, CosTask_t *task_pt);
+int8_t  COS_HrTimerCancel(CosHrTimer_t *t);
+uint8_t COS_HrTimerIsActive(CosHrTimer_t *t);
+
+/* intern: ISR von CMT1 bzw. Scheduler */
+void    _hrTimerExpired(void);
+void    _hrTimerWakeTasks(void);
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro ist ein kooperativer Scheduling-Punkt der Task-Funktion.
+  Die Task blockiert fuer us Mikrosekunden, gemessen mit dem HR-Timer t,
+  und wird danach vom Scheduler wieder gestartet. Anders als
+  COS_TASK_SLEEP() ist die Wartezeit nicht an den Tick gebunden. Der
+  Timer muss static oder global sein, z.B. in den Task-Daten.
+  Ist der Timer schon aktiv, gibt die Task nur ab.
+
+@parameter pt - IN, Zeiger auf Task-Stuktur
+@parameter t  - IN, Zeiger auf CosHrTimer_t
+@parameter us - IN, Wartezeit in Mikrosekunden
+
+@returns  nichts
+
+@par Code-Beispiel::
+@verbatim
+void bitBangTask(CosTask_t *pt)
+{   static CosHrTimer_t tmr;
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   _clockHigh();
+        COS_HRTIMER_SLEEP(pt,&tmr,100);
+        _clockLow();
+        COS_HRTIMER_SLEEP(pt,&tmr,100);
+    }
+    COS_TASK_END(pt);
+}
+@endverbatim
+********************************************************************/
+#define COS_HRTIMER_SLEEP(pt,t,us) (pt)->sleepTime_Ticks=0;\
+                          (pt)->lineCnt=__LINE__;\
+                          (void) COS_HrTimerWakeTask((t),(us),(pt));\
+                          return;\
+                          case __LINE__:
+
+
+#endif
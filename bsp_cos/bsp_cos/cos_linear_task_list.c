@@ -25,18 +25,15 @@ Routinen zur Verwaltung einer linearen Task-Liste:
 
   @verbatim
 
-                          node
+                          task
            root          --------      --------           --------
            -----         |      |----->|      |-- ... --->|      |----> NULL
-           |   |-------->|......|      |......|           |......|
-           -----         |      |      |      |           |      |
+           |   |-------->|      |      |      |           |      |
+           -----  NULL<--|      |<-----|      |<-- ... ---|      |
                          --------      --------           --------
-                            |             |                  |
-                            \/            \/                 \/
-                          -----         -----              -----
-                          |   |         |   |              |   |
-                          -----         -----              -----
-                          task
+
+  Die Listen sind doppelt verkettet, die Verkettung steht direkt in der
+  Task-Struktur (siehe cos_linear_task_list.h).
 
   @endverbatim
 
@@ -92,16 +89,79 @@ Routinen zur Verwaltung einer linearen Task-Liste:
 /*---------------------------------------------------------------*/
 
 
+
+/****************************************************************/
+/* private module variables: task pool                          */
+/****************************************************************/
+#if COS_USE_STATIC_POOLS
+/* a free slot stores the link of the free list in its own memory */
+typedef union TaskSlot_t TaskSlot_t;
+union TaskSlot_t {
+    CosTask_t task;
+    TaskSlot_t *next_pt;
+};
+
+static TaskSlot_t taskPool_g[COS_TASK_POOL_SIZE]; /*! Speicher fuer Tasks */
+static TaskSlot_t *taskFree_g = NULL;   /*! Liste der freien Task-Slots */
+static uint8_t poolsInitialized_g = 0;
+#endif
+
+static CosPoolStats_t taskStats_g = {0,0,0,0};
+
+
+
+#if COS_USE_STATIC_POOLS
+/*!
+********************************************************************
+  @par Beschreibung
+  Verkettet alle Slots des Task-Pools zu einer Freispeicher-Liste. Wird
+  beim ersten Anfordern einer Task aufgerufen.
+********************************************************************/
+static void _initPools(void)
+{   uint16_t i;
+
+    taskFree_g = NULL;
+    for(i=0; i<COS_TASK_POOL_SIZE; i++)
+    {   taskPool_g[i].next_pt = taskFree_g;
+        taskFree_g = &taskPool_g[i];
+    }
+    taskStats_g.size = COS_TASK_POOL_SIZE;
+    poolsInitialized_g = 1;
+}
+#endif
+/*---------------------------------------------------------------*/
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Zaehlt eine erfolgreiche oder fehlgeschlagene Anforderung in der
+  Pool-Statistik.
+********************************************************************/
+static void _countAlloc(CosPoolStats_t *stats, void *pt)
+{
+    if(NULL == pt)
+    {   stats->allocFails++;
+        return;
+    }
+    stats->used++;
+    if(stats->used > stats->highWater)
+    {   stats->highWater = stats->used;
+    }
+}
+/*---------------------------------------------------------------*/
+
+
 /*!
 ********************************************************************
   @par Beschreibung
-  Erzeugt einen neuen Lisenknoten, verbindet die Task mit diesem Knoten und
-  fuegt den Konten als erstes Element in die Liste ein. D.h. der root-Zeiger
-  der Liste aendert sich! Der neue root-Zeiger wird mit return zurueckgegeben.
-  Die Task-Struktur, auf die task-Pt zeigt, muss vor dem Aufruf dieser Funktion
-  initialisiert sein.
+  Fuegt die Task als erstes Element in die Task-Liste ein. D.h. der
+  root-Zeiger der Liste aendert sich! Der neue root-Zeiger wird mit
+  return zurueckgegeben. Die Task-Struktur, auf die task_pt zeigt, muss
+  vor dem Aufruf dieser Funktion initialisiert sein. Es wird kein
+  Speicher angefordert, die Verkettung steht in der Task-Struktur.
 
-@see _unlinkTaskFromTaskList(), _newNode()
+@see _unlinkTaskFromTaskList()
 @arg
 
 @param root_pt - IN, Zeiger auf das erste Listenelement
@@ -112,7 +172,7 @@ Routinen zur Verwaltung einer linearen Task-Liste:
 @par Code-Beispiel::
 @verbatim
 int main(void)
-{   Node_t *root_pt=NULL;
+{   CosTask_t *root_pt=NULL;
     CosTask_t *pt=NULL;
 
     ...
@@ -124,12 +184,14 @@ int main(void)
 }
 @endverbatim
 ********************************************************************/
-Node_t *_addTaskAtBeginningOfTaskList(Node_t *root_pt, CosTask_t *task_pt)
-{   Node_t *pt=NULL;
-
-    pt = _newNode(task_pt);    /* init node, connect to existing task */
-    pt->next_pt = root_pt;      /* append old list to new node: new first element */
-    return pt;                  /* new root pointer: address of first element */
+CosTask_t *_addTaskAtBeginningOfTaskList(CosTask_t *root_pt, CosTask_t *task_pt)
+{
+    task_pt->prev_pt = NULL;
+    task_pt->next_pt = root_pt;    /* append old list to task: new first element */
+    if(NULL != root_pt)
+    {   root_pt->prev_pt = task_pt;
+    }
+    return task_pt;                /* new root pointer: address of first element */
 }
 /*---------------------------------------------------------------*/
 
@@ -138,26 +200,24 @@ Node_t *_addTaskAtBeginningOfTaskList(Node_t *root_pt, CosTask_t *task_pt)
 /*!
 ********************************************************************
   @par Beschreibung
-  Diese Routine durchsucht die Task-Liste nach dem Knoten, der auf dieselbe
-  Task zeigt, wie task_pt. Der Knoten wird aus der Liste geloescht, und sein
-  Speicher wird freigegeben. Die Task-Struktur wird aber nicht geloescht, da
-  sie noch Teil einer anderen Liste sein koennte. (Bsp: Auch Semaphoren besitzen eine
-  lineare Liste der an ihnen wartenden Tasks) Der root-Zeiger der Liste
-  wird geaendert, falls der erste Konten der Liste geloescht wurde. Die
-  Funktion gibt den (ggf.) neuen root-Zeiger mit return zurueck.
-
-@see _addTaskAtBeginningOfTaskList(), _newNode()
+  Haengt die Task aus der Task-Liste aus. Da die Liste doppelt verkettet
+  ist, muss dazu nichts gesucht werden. Die Task-Struktur wird nicht
+  geloescht. Der root-Zeiger der Liste wird geaendert, falls die erste
+  Task der Liste ausgehaengt wurde. Die Funktion gibt den (ggf.) neuen
+  root-Zeiger mit return zurueck.
+
+@see _addTaskAtBeginningOfTaskList()
 @arg
 
 @param root_pt - IN, Zeiger auf das erste Listenelement
-@param task_pt - IN, Zeiger auf initialisierte Task-Struktur
+@param task_pt - IN, Zeiger auf eine Task in dieser Liste
 
 @retval neuer Zeiger auf das erste Listenelement
 
 @par Code-Beispiel::
 @verbatim
 int main(void)
-{   Node_t *root_pt=NULL;
+{   CosTask_t *root_pt=NULL;
     CosTask_t *pt=NULL;
 
     ...
@@ -172,31 +232,24 @@ int main(void)
 }
 @endverbatim
 ********************************************************************/
- Node_t *_unlinkTaskFromTaskList(Node_t *root_pt, CosTask_t *task_pt)
-{   Node_t *pt=NULL;
-    Node_t *predecessor_pt=NULL;
-
-    pt = _searchTaskInList(root_pt, task_pt);
-    if(NULL == pt)
-    {   DebugCode(_msg("_unlink...task not found"););
-        return root_pt;  /* don't change the list! */
+CosTask_t *_unlinkTaskFromTaskList(CosTask_t *root_pt, CosTask_t *task_pt)
+{
+    if(NULL == task_pt->prev_pt)
+    {   if(task_pt != root_pt)
+        {   DebugCode(_msg("_unlink...task not found"););
+            return root_pt;  /* don't change the list! */
+        }
+        root_pt = task_pt->next_pt;  /* the old second element now is the first */
     }
-    /* is it the first node in the list? root_pt has to be changed... */
-    if(pt == root_pt)
-    {   pt = pt->next_pt; /* second node in list */
-        free(root_pt); /* free the first node, don't touch the task! */
-        return pt;    /* the old second element now is the first */
+    else
+    {   task_pt->prev_pt->next_pt = task_pt->next_pt;
     }
-    /* node exists, is not the first list element, should have a predecessor... */
-    predecessor_pt = _searchPredecessorTaskInList(root_pt, task_pt);
-    if(NULL == predecessor_pt)
-    {   DebugCode(_msg("_unlink...pred.task not found"););
-        return root_pt;  /* don't change the list! */
+    if(NULL != task_pt->next_pt)
+    {   task_pt->next_pt->prev_pt = task_pt->prev_pt;
     }
-    /* task node and its predecessor have been found. Unlink task node: */
-    predecessor_pt->next_pt = pt->next_pt;
-    free(pt); /* free the node, don't touch the task! */
-    return root_pt; /* old first list element still is the first */
+    task_pt->next_pt = NULL;
+    task_pt->prev_pt = NULL;
+    return root_pt;
 }
 
 /*---------------------------------------------------------------*/
@@ -205,106 +258,91 @@ int main(void)
 /*!
 ********************************************************************
   @par Beschreibung
-  Gegeben ist der Zeiger auf eine Task. Diese Funktion durchsucht die
-  lineare Liste nach dem Knoten, der mit der Task verbunden ist. Die
-  Funktion gibt einen Zeiger auf diesen Knoten zurueck, oder NULL, falls
-  nichts gefunden wurde.
-
-@see _unlinkTaskFromTaskList()
+  Haengt eine Task am Ende einer Warteliste an, z.B. der Liste der an
+  einem Semaphor wartenden Tasks. Die Tasks werden so in der
+  Reihenfolge ihres Eintrags bedient. Die erste Task der Liste zeigt
+  mit waitPrev_pt auf die letzte, das Anhaengen ist daher O(1). Die
+  Task merkt sich den root-Zeiger der Liste, dadurch kann sie spaeter
+  mit _unlinkTaskFromWaitList() ohne Suche wieder ausgehaengt werden.
+  Eine Task kann nur in einer Warteliste stehen.
+
+@see _unlinkTaskFromWaitList()
 @arg
 
-@param root_pt - IN, Zeiger auf das erste Listenelement
+@param root_pp - IN/OUT, Zeiger auf den root-Zeiger der Warteliste
 @param task_pt - IN, Zeiger auf initialisierte Task-Struktur
 
-@retval Zeiger auf den Konten, der mit Task *task_pt verbunden ist
+@retval keiner
 
 @par Code-Beispiel::
 @verbatim
-int main(void)
-{   Node_t *root_pt=NULL;
-    Node_t *npt=NULL;
-    CosTask_t *pt=NULL;
-
-    ...
-    pt = _newTask(...);
-    root_pt = _addTaskAtBeginningOfTaskList(root_pt, pt);
+    CosTask_t *waitRoot_pt = NULL;
     ...
-    npt = _searchTaskInList(root_pt, pt);
+    _addTaskToWaitList(&waitRoot_pt, pt);
     ...
-
-    return 0;
-}
+    _unlinkTaskFromWaitList(pt);
 @endverbatim
 ********************************************************************/
-Node_t *_searchTaskInList(Node_t *root_pt, CosTask_t *task_pt)
-{   Node_t *pt=NULL;
+void _addTaskToWaitList(CosTask_t **root_pp, CosTask_t *task_pt)
+{
+    CosTask_t *head_pt = *root_pp;
 
-    pt = root_pt;
-    while(pt != NULL)
-    {   if((pt->task_pt) == task_pt)
-        {   return pt;
-        }
-        pt = pt->next_pt;
+    task_pt->waitNext_pt = NULL;
+    if(NULL == head_pt)
+    {   task_pt->waitPrev_pt = task_pt;  /* the only task is its own tail */
+        *root_pp = task_pt;
     }
-    DebugCode(_msg("Task not found"););
-    return NULL;
+    else
+    {   task_pt->waitPrev_pt = head_pt->waitPrev_pt;
+        head_pt->waitPrev_pt->waitNext_pt = task_pt;
+        head_pt->waitPrev_pt = task_pt;
+    }
+    task_pt->waitRoot_pp = root_pp;
 }
 /*---------------------------------------------------------------*/
 
+
 /*!
 ********************************************************************
   @par Beschreibung
-  Gegeben ist der Zeiger auf eine Task. Diese Funktion durchsucht die Liste
-  nach dem Vorgaengerknoten der Task. Die Funktion gibt den Zeiger auf den
-  Vorgaengerknoten zurueck, oder NULL, falls nichts gefunden wurde.
+  Fuegt eine Task nach ihrer Prioritaet in eine Warteliste ein, die
+  Task mit der hoechsten Prioritaet steht vorne. Hinter Tasks gleicher
+  Prioritaet wird angehaengt, diese werden also in der Reihenfolge
+  ihres Eintrags bedient. Aufwand O(Anzahl wartender Tasks).
 
-@see _searchTaskInList(), _unlinkTaskFromTaskList()
+@see _addTaskToWaitList(), _unlinkTaskFromWaitList()
 @arg
 
-@param root_pt - IN, Zeiger auf das erste Listenelement
+@param root_pp - IN/OUT, Zeiger auf den root-Zeiger der Warteliste
 @param task_pt - IN, Zeiger auf initialisierte Task-Struktur
 
-@retval Zeiger auf den Vorgaengerknoten der Task
-
-@par Code-Beispiel::
-@verbatim
-int main(void)
-{   Node_t *root_pt=NULL;
-    Node_t *npt=NULL;
-    CosTask_t *pt=NULL;
-
-    ...
-    pt = _newTask(...);
-    root_pt = _addTaskAtBeginningOfTaskList(root_pt, pt);
-    ...
-    npt = _searchPredecessorTaskInList(root_pt, pt);
-    ...
-
-    return 0;
-}
-@endverbatim
+@retval keiner
 ********************************************************************/
-Node_t *_searchPredecessorTaskInList(Node_t *root_pt, CosTask_t *task_pt)
-{   Node_t *pt=NULL;
+void _insertTaskToWaitListByPrio(CosTask_t **root_pp, CosTask_t *task_pt)
+{
+    CosTask_t *head_pt = *root_pp;
+    CosTask_t *prev_pt = NULL;
+    CosTask_t *next_pt = head_pt;
 
-    /* list empty? */
-    if(NULL==root_pt)
-    {   DebugCode(_msg("_searchPred...empty list"););
-        return NULL;
+    while((NULL != next_pt) && (next_pt->prio >= task_pt->prio))
+    {   prev_pt = next_pt;
+        next_pt = next_pt->waitNext_pt;
+    }
+    if(NULL == next_pt)
+    {   _addTaskToWaitList(root_pp, task_pt);  /* new tail */
+        return;
     }
-    /* task connected to first node?  no predecessor...*/
-    pt = root_pt;
-    if(pt->task_pt == task_pt)
-    {   DebugCode(_msg("_searchPred...nothing found"););
-        return NULL;
+    task_pt->waitNext_pt = next_pt;
+    if(NULL == prev_pt)
+    {   task_pt->waitPrev_pt = head_pt->waitPrev_pt;  /* new head keeps the tail */
+        *root_pp = task_pt;
     }
-    /* ok, list has at least one node */
-    while(pt->next_pt != NULL)
-    {   if((pt->next_pt->task_pt) == task_pt) return pt;  /* the predecessor! */
-        pt = pt->next_pt;
+    else
+    {   task_pt->waitPrev_pt = prev_pt;
+        prev_pt->waitNext_pt = task_pt;
     }
-    DebugCode(_msg("Pred. Task not found"););
-    return NULL;
+    next_pt->waitPrev_pt = task_pt;
+    task_pt->waitRoot_pp = root_pp;
 }
 /*---------------------------------------------------------------*/
 
@@ -312,40 +350,39 @@ Node_t *_searchPredecessorTaskInList(Node_t *root_pt, CosTask_t *task_pt)
 /*!
 ********************************************************************
   @par Beschreibung
-  Gegeben ist der Zeiger auf eine Task. Diese Funktion erzeugt einen neuen
-  Knoten und verbindet ihn mit der Task. Der Zeiger auf den neuen Knoten
-  wird zurueck gegeben.
+  Haengt eine Task aus der Warteliste aus, in der sie steht. Steht die
+  Task in keiner Warteliste, passiert nichts.
 
-@see _addTaskAtBeginningOfTaskList()
+@see _addTaskToWaitList()
 @arg
 
-@param task_pt - IN, Zeiger auf initialisierte Task-Struktur
-
-@retval Zeiger auf den neuen Knoten
-
-@par Code-Beispiel::
-@verbatim
-int main(void)
-{   Node_t *npt=NULL;
-    CosTask_t *pt=NULL;
-
-    ...
-    pt  = _newTask(...);
-    npt = _newNode(pt);
-    ...
+@param task_pt - IN, Zeiger auf Task-Struktur
 
-    return 0;
-}
-@endverbatim
+@retval keiner
 ********************************************************************/
-Node_t *_newNode(CosTask_t *task_pt)
-{   Node_t *pt;
-    pt = (Node_t *) malloc(sizeof(Node_t));
-    if(pt!=NULL)
-    {   pt->task_pt = task_pt;
-        pt->next_pt = NULL;
+void _unlinkTaskFromWaitList(CosTask_t *task_pt)
+{
+    CosTask_t *head_pt;
+
+    if(NULL == task_pt->waitRoot_pp)
+    {   return;  /* not waiting */
+    }
+    head_pt = *(task_pt->waitRoot_pp);
+    if(task_pt == head_pt)
+    {   *(task_pt->waitRoot_pp) = task_pt->waitNext_pt;
+    }
+    else
+    {   task_pt->waitPrev_pt->waitNext_pt = task_pt->waitNext_pt;
+    }
+    if(NULL != task_pt->waitNext_pt)
+    {   task_pt->waitNext_pt->waitPrev_pt = task_pt->waitPrev_pt;
+    }
+    else if(task_pt != head_pt)
+    {   head_pt->waitPrev_pt = task_pt->waitPrev_pt;  /* new tail */
     }
-    return pt;
+    task_pt->waitNext_pt = NULL;
+    task_pt->waitPrev_pt = NULL;
+    task_pt->waitRoot_pp = NULL;
 }
 /*---------------------------------------------------------------*/
 
@@ -353,9 +390,10 @@ Node_t *_newNode(CosTask_t *task_pt)
 ********************************************************************
   @par Beschreibung
   Alloziert Speicher fuer eine Task-Struktur und initialisiert ihn.
-  Der Zeiger auf die Struktur wird zurueck gegeben.
+  Der Zeiger auf die Struktur wird zurueck gegeben. Mit
+  COS_USE_STATIC_POOLS kommt der Speicher aus dem Task-Pool.
 
-@see _addTaskAtBeginningOfTaskList(), _newNode()
+@see _addTaskAtBeginningOfTaskList(), _freeTask()
 @arg
 
 @param  prio - IN Prioritaet der Task (min) 1..254 (max)
@@ -368,12 +406,12 @@ Node_t *_newNode(CosTask_t *task_pt)
 @par Code-Beispiel::
 @verbatim
 int main(void)
-{   Node_t *npt=NULL;
+{   CosTask_t *root_pt=NULL;
     CosTask_t *pt=NULL;
 
     ...
     pt  = _newTask(...);
-    npt = _newNode(pt);
+    root_pt = _addTaskAtBeginningOfTaskList(root_pt, pt);
     ...
 
     return 0;
@@ -382,71 +420,222 @@ int main(void)
 ********************************************************************/
 CosTask_t *_newTask(uint8_t prio, void * pData, void (*func) (CosTask_t *))
 {  CosTask_t *pt;
+#if COS_USE_STATIC_POOLS
+   if(!poolsInitialized_g)
+   {   _initPools();
+   }
+   pt = (CosTask_t *) taskFree_g;
+   if(NULL != taskFree_g)
+   {   taskFree_g = taskFree_g->next_pt;
+   }
+#else
    pt = (CosTask_t *)malloc(sizeof(CosTask_t));
+#endif
+   _countAlloc(&taskStats_g, pt);
 
    if(pt!=NULL)
-   {  pt->lastActivationTime_Ticks  = _gettime_Ticks();
+   {  pt->lastActivationTime_Ticks  = _gettime_Ticks32();
       pt->sleepTime_Ticks           = 0;  /* run asap */
       pt->state                     = TASK_STATE_READY;
       pt->prio                      = prio;
+      pt->basePrio                  = prio;
       pt->lineCnt                   = 0;    /* re-entry at start of function */
       pt->pData                     = pData;
       pt->func                      = func;
+      pt->queue                     = TASK_QUEUE_NONE;
+      pt->next_pt                   = NULL;
+      pt->prev_pt                   = NULL;
+      pt->rqNext_pt                 = NULL;
+      pt->rqPrev_pt                 = NULL;
+      pt->sleepDelta_Ticks          = 0;
+      pt->waitNext_pt               = NULL;
+      pt->waitPrev_pt               = NULL;
+      pt->waitRoot_pp               = NULL;
+      pt->eventMask                 = 0;
+      pt->eventMode                 = 0;
+      pt->deadline_Ticks            = 0;    /* no deadline */
+      pt->absDeadline_Ticks         = 0;
+      pt->heapIdx                   = 0;
+      pt->edfSeq                    = 0;
+      pt->release_Ticks             = 0;
+      pt->period_Ticks              = 0;    /* not periodic (yet) */
+      pt->overruns                  = 0;
+      pt->overrunPolicy             = TASK_OVERRUN_SKIP;
+      pt->prof.runs                 = 0;
+      pt->prof.totalCycles          = 0;
+      pt->prof.minCycles            = 0xFFFFFFFFUL;
+      pt->prof.maxCycles            = 0;
+      pt->prof.maxLatencyCycles     = 0;
+      pt->prof.readyCycles          = 0;
+      pt->mutexHeld_pt              = NULL;
+      pt->mutexWait_pt              = NULL;
    }
    return pt;
 }
 
 /*---------------------------------------------------------------*/
 
+/*!
+********************************************************************
+  @par Beschreibung
+  Gibt den Speicher einer Task-Struktur frei, je nach
+  COS_USE_STATIC_POOLS zurueck in den Pool oder mit free(). Eine Task im
+  Pool behaelt den Zustand TASK_STATE_DELETED, bis der Slot neu vergeben
+  wird (der Link der Freispeicher-Liste liegt am Anfang der Struktur).
+
+@see _newTask()
+@arg
+
+@param task_pt - IN, Zeiger auf die Task-Struktur
+
+@retval keiner
+********************************************************************/
+void _freeTask(CosTask_t *task_pt)
+{
+    if(NULL == task_pt)
+    {   return;
+    }
+    task_pt->state = TASK_STATE_DELETED;
+#if COS_USE_STATIC_POOLS
+    ((TaskSlot_t *) task_pt)->next_pt = taskFree_g;
+    taskFree_g = (TaskSlot_t *) task_pt;
+#else
+    free(task_pt);
+#endif
+    taskStats_g.used--;
+}
+/*---------------------------------------------------------------*/
+
 
 /*!
 ********************************************************************
   @par Beschreibung
-  Sortiert die lineare Liste nach Task Prioritaet. Die Task mit der hoechsten
-  Prioritaet steht vorne in der Liste. Der root-Zeiger der Liste bleibt
-  unveraendert, da hier nur die 'Nutzlast' der Knoten getauscht wird, und nicht
-  die Knotenreihenfolge geaendert wird.
+  Traegt eine Task so in die Task-Liste ein, dass die Liste nach
+  Prioritaet sortiert bleibt: die Task mit der hoechsten Prioritaet
+  steht vorne. Die neue Task wird vor allen Tasks gleicher Prioritaet
+  eingetragen. Statt die ganze Liste neu zu sortieren, wird nur die
+  Einfuegestelle gesucht, der Aufwand ist O(n). Der root-Zeiger der
+  Liste kann sich aendern, der neue root-Zeiger wird zurueckgegeben.
 
-@see
+@see _unlinkTaskFromTaskList()
 @arg
 
 @param root_pt - IN, Zeiger auf das erste Listenelement
+@param task_pt - IN, Zeiger auf initialisierte Task-Struktur, die in
+                 keiner Liste steht
 
-@retval none
+@retval neuer Zeiger auf das erste Listenelement
 
 @par Code-Beispiel::
 @verbatim
 int main(void)
 {   ...
-    _sortLinearListPrio(root_pt);
+    pt = _newTask(...);
+    root_pt = _insertTaskSortedByPrio(root_pt, pt);
+    ...
+    root_pt = _unlinkTaskFromTaskList(root_pt, pt);
+    pt->prio = 7;
+    root_pt = _insertTaskSortedByPrio(root_pt, pt);
     ...
 
     return 0;
 }
 @endverbatim
 ********************************************************************/
-void _sortLinearListPrio(Node_t *root_pt)
+CosTask_t *_insertTaskSortedByPrio(CosTask_t *root_pt, CosTask_t *task_pt)
 {
+    CosTask_t *pos_pt = root_pt;   /* insert in front of this task */
+    CosTask_t *prev_pt = NULL;     /* last task with higher priority */
 
-    int noOfSwaps;
-    CosTask_t *temp_pt;
-    Node_t *pt;
-
-    if (root_pt==NULL) return;  /* empty list */
-
-    /* bubblesort */
-    do
-    {   noOfSwaps=0;
-        pt = root_pt;
-        while(pt->next_pt != NULL)  // run through linear list
-        {   if((pt->task_pt)->prio < ((pt->next_pt)->task_pt)->prio)
-            {   /* swap the 'payloads' of the nodes*/
-                noOfSwaps++;
-                temp_pt = pt->task_pt;  /* swap payload of nodes */
-                pt->task_pt = (pt->next_pt)->task_pt;
-                (pt->next_pt)->task_pt = temp_pt;
-            }
-            pt = pt->next_pt;
-        }
-    } while(noOfSwaps >0);
+    while((pos_pt != NULL) && (pos_pt->prio > task_pt->prio))
+    {   prev_pt = pos_pt;
+        pos_pt = pos_pt->next_pt;
+    }
+    task_pt->prev_pt = prev_pt;
+    task_pt->next_pt = pos_pt;
+    if(NULL != pos_pt)
+    {   pos_pt->prev_pt = task_pt;
+    }
+    if(NULL == prev_pt)
+    {   return task_pt;            /* new first element */
+    }
+    prev_pt->next_pt = task_pt;
+    return root_pt;
+}
+/*---------------------------------------------------------------*/
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Haengt eine Task hinter die letzte Task gleicher Prioritaet um. Die
+  Liste bleibt nach Prioritaet sortiert, innerhalb einer Prioritaet
+  rotieren die Tasks. Damit kommt jede Task einer Prioritaetsstufe an
+  die Reihe, bevor eine andere Task derselben Stufe erneut laeuft.
+  Der Aufwand ist proportional zur Anzahl der Tasks gleicher Prioritaet.
+  Der root-Zeiger der Liste kann sich aendern, der neue root-Zeiger
+  wird zurueckgegeben.
+
+@see _insertTaskSortedByPrio()
+@arg
+
+@param root_pt - IN, Zeiger auf das erste Listenelement
+@param task_pt - IN, Zeiger auf eine Task in dieser Liste
+
+@retval neuer Zeiger auf das erste Listenelement
+********************************************************************/
+CosTask_t *_moveTaskBehindEqualPrio(CosTask_t *root_pt, CosTask_t *task_pt)
+{
+    CosTask_t *last_pt = task_pt->next_pt;  /* last task of the same prio */
+
+    if((NULL == last_pt) || (last_pt->prio != task_pt->prio))
+    {   return root_pt;   /* already the last one of its prio */
+    }
+    while((NULL != last_pt->next_pt) && (last_pt->next_pt->prio == task_pt->prio))
+    {   last_pt = last_pt->next_pt;
+    }
+    root_pt = _unlinkTaskFromTaskList(root_pt, task_pt);
+    task_pt->prev_pt = last_pt;
+    task_pt->next_pt = last_pt->next_pt;
+    if(NULL != last_pt->next_pt)
+    {   last_pt->next_pt->prev_pt = task_pt;
+    }
+    last_pt->next_pt = task_pt;
+    return root_pt;
+}
+/*---------------------------------------------------------------*/
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Liefert die Statistik der Task-Strukturen: Groesse des Pools,
+  aktuell belegte Elemente, Hochwassermarke und die Anzahl der
+  fehlgeschlagenen Anforderungen. Damit laesst sich COS_TASK_POOL_SIZE
+  im Betrieb ueberpruefen.
+
+@see _newTask()
+@arg
+
+@param stats - OUT, Zeiger auf die Statistik-Struktur
+
+@retval keiner
+
+@par Code-Beispiel::
+@verbatim
+    CosPoolStats_t st;
+
+    COS_GetTaskPoolStats(&st);
+    serPuts("\r\ntasks used/max:");
+    serOutUint16Dec(st.used); serPutc('/'); serOutUint16Dec(st.highWater);
+@endverbatim
+********************************************************************/
+void COS_GetTaskPoolStats(CosPoolStats_t *stats)
+{
+#if COS_USE_STATIC_POOLS
+    if(!poolsInitialized_g)
+    {   _initPools();
+    }
+#endif
+    *stats = taskStats_g;
 }
@@ -26,18 +26,21 @@ Routinen zur Verwaltung einer linearen Task-Liste:
 
   @verbatim
 
-                          node
+                          task
            root          --------      --------           --------
            -----         |      |----->|      |-- ... --->|      |----> NULL
-           |   |-------->|......|      |......|           |......|
-           -----         |      |      |      |           |      |
+           |   |-------->|      |      |      |           |      |
+           -----  NULL<--|      |<-----|      |<-- ... ---|      |
                          --------      --------           --------
-                            |             |                  |
-                            \/            \/                 \/
-                          -----         -----              -----
-                          |   |         |   |              |   |
-                          -----         -----              -----
-                          task
+
+  Die Verkettung steht direkt in der Task-Struktur, es gibt keine
+  separaten Listenknoten. Jede Task besitzt drei Verkettungen:
+  next_pt/prev_pt fuer die Task-Liste des Schedulers,
+  rqNext_pt/rqPrev_pt fuer Ready- und Sleep-Queue und
+  waitNext_pt/waitPrev_pt fuer die Warteliste eines Semaphors. Ein
+  Wechsel zwischen diesen Listen braucht keinen Speicher, und das
+  Aushaengen einer Task ist O(1). In der Warteliste zeigt waitPrev_pt
+  der ersten Task auf die letzte, Anhaengen am Ende ist damit auch O(1).
 
   @endverbatim
 
@@ -72,9 +75,30 @@ Routinen zur Verwaltung einer linearen Task-Liste:
 #include <stdlib.h>
 
 
+/*! 1: Task-Strukturen kommen aus einem statischen Pool fester Groesse
+    (O(1), keine Fragmentierung des Heap), 0: malloc() und free() */
+#ifndef COS_USE_STATIC_POOLS
+#define COS_USE_STATIC_POOLS     0
+#endif
+/*! Anzahl der Task-Strukturen im Pool (inkl. cpu-load-Task) */
+#ifndef COS_TASK_POOL_SIZE
+#define COS_TASK_POOL_SIZE       32
+#endif
+
+
 #define TASK_STATE_READY         0
 #define TASK_STATE_SUSPENDED     1
 #define TASK_STATE_BLOCKED       2
+#define TASK_STATE_DELETED       3  /*!< freigegeben, siehe _freeTask() */
+
+/* In welcher Queue des Schedulers steht die Task? (nur READY_QUEUE_SCHEDULING) */
+#define TASK_QUEUE_NONE          0
+#define TASK_QUEUE_READY         1
+#define TASK_QUEUE_SLEEP         2
+
+/* Verhalten von COS_TASK_PERIODIC() bei verpassten Startzeitpunkten */
+#define TASK_OVERRUN_SKIP        0  /*!< verpasste Starts auslassen, Phase bleibt */
+#define TASK_OVERRUN_CATCH_UP    1  /*!< verpasste Starts sofort nachholen */
 
 
 
@@ -115,38 +139,96 @@ dann privat fuer jede Task (Instanz).
 
   @see
  ********************************************************************/
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Laufzeit-Statistik einer Task, gemessen vom Scheduler um jeden Aufruf
+  der Task-Funktion (nur mit COS_TASK_PROFILING 1 in cos_scheduler.c).
+  Alle Zeiten in Zaehlschritten von _getCycles(), Umrechnung mit
+  _cyclesToMicroSec(). Die Latenz ist die Zeit vom Bereitwerden der
+  Task (Ablauf der Sleep-Zeit, Semaphor, Resume) bis zu ihrem Start.
+
+  @see COS_GetTaskProfile(), COS_PrintTaskList()
+ ********************************************************************/
+typedef struct {
+        uint32_t runs;             /*!< Anzahl der Aufrufe der Task-Funktion */
+        uint64_t totalCycles;      /*!< Summe aller Laufzeiten */
+        uint32_t minCycles;        /*!< kuerzeste Laufzeit, 0xFFFFFFFF vor dem ersten Lauf */
+        uint32_t maxCycles;        /*!< laengste Laufzeit */
+        uint32_t maxLatencyCycles; /*!< laengste Verzoegerung bis zum Start */
+        uint32_t readyCycles;      /*!< intern: seit wann ist die Task bereit? */
+} CosTaskProfile_t;
+
+
 typedef struct CosTask_t CosTask_t;
+struct CosMutex_s;  /* cos_semaphore.h */
 struct CosTask_t
-{   uint16_t lastActivationTime_Ticks; /*!< letzter Startzeitpunkt in Ticks */
-    uint16_t sleepTime_Ticks;          /*!< laesst die Task blockieren.
+{   CosTicks_t lastActivationTime_Ticks; /*!< letzter Startzeitpunkt in Ticks */
+    CosTicks_t sleepTime_Ticks;        /*!< laesst die Task blockieren.
                                             0 == sleepTime_Ticks bedeutet:
                                             sofort starten */
     uint8_t  state;     /*!< Task Zustaende:  TASK_STATE_READY,
                              TASK_STATE_SUSPENDED, TASK_STATE_BLOCKED */
     uint8_t  prio;      /*!< 1 ist minimal, 254 ist maximal. 0 und 255 sind reserviert */
+    uint8_t  basePrio;  /*!< Prioritaet ohne Vererbung durch Mutexe, prio >= basePrio */
     uint16_t lineCnt;   /*!< speichert Programmzeile fuer re-entry */
     void * pData;       /*!< Zeiger auf Nutzer-Daten, moelicher Speicherplatz fuer
                              lokale Task-Variable */
     void (*func)(CosTask_t*); /*!< Name der Task-Funktion */
+    uint8_t  queue;     /*!< TASK_QUEUE_NONE, TASK_QUEUE_READY oder TASK_QUEUE_SLEEP */
+    CosTask_t *next_pt;   /*!< naechste Task in der Task-Liste */
+    CosTask_t *prev_pt;   /*!< vorherige Task in der Task-Liste */
+    CosTask_t *rqNext_pt; /*!< naechste Task in Ready- bzw. Sleep-Queue des Schedulers */
+    CosTask_t *rqPrev_pt; /*!< vorherige Task in Ready- bzw. Sleep-Queue des Schedulers */
+    CosTicks_t sleepDelta_Ticks; /*!< Sleep-Queue: Weckzeit relativ zum Vorgaenger */
+    CosTask_t *waitNext_pt;    /*!< naechste Task in der Warteliste */
+    CosTask_t *waitPrev_pt;    /*!< vorherige Task in der Warteliste */
+    CosTask_t **waitRoot_pp;   /*!< root-Zeiger der Warteliste, NULL falls die
+                                    Task in keiner Warteliste steht */
+    uint32_t eventMask;        /*!< COS_EVENT_WAIT(): Flags, auf die die Task wartet */
+    uint8_t  eventMode;        /*!< COS_EVENT_WAIT(): Modus der wartenden Task */
+    CosTicks_t deadline_Ticks;  /*!< EDF: relative Deadline, 0 == keine Deadline */
+    CosTicks_t absDeadline_Ticks; /*!< EDF: absolute Deadline des aktuellen Laufs */
+    uint16_t heapIdx;           /*!< EDF: Index im Ready-Heap des Schedulers */
+    uint16_t edfSeq;            /*!< EDF: Reihenfolge bei gleichem Schluessel */
+    CosTicks_t release_Ticks;   /*!< COS_TASK_PERIODIC: letzter Soll-Startzeitpunkt */
+    CosTicks_t period_Ticks;    /*!< COS_TASK_PERIODIC: Periode, 0 == nicht periodisch */
+    uint16_t overruns;          /*!< COS_TASK_PERIODIC: Anzahl verpasster Starts */
+    uint8_t  overrunPolicy;     /*!< TASK_OVERRUN_SKIP oder TASK_OVERRUN_CATCH_UP */
+    CosTaskProfile_t prof;      /*!< Laufzeit-Statistik, siehe COS_TASK_PROFILING */
+    struct CosMutex_s *mutexHeld_pt; /*!< erster Mutex, den die Task haelt */
+    struct CosMutex_s *mutexWait_pt; /*!< Mutex, auf den die Task wartet, oder NULL */
 };
 
 
 
-typedef struct Node_t Node_t;
-struct Node_t {
-    CosTask_t *task_pt;  /*!<  Pointer auf Task-Struktur */
-    Node_t *next_pt;  /*!<  Pointer auf naechsten Knoten der Ringliste */
-};
+CosTask_t *_addTaskAtBeginningOfTaskList(CosTask_t *root_pt, CosTask_t *task_pt);
+CosTask_t *_unlinkTaskFromTaskList(CosTask_t *root_pt, CosTask_t *task_pt);
+void _addTaskToWaitList(CosTask_t **root_pp, CosTask_t *task_pt);
+void _insertTaskToWaitListByPrio(CosTask_t **root_pp, CosTask_t *task_pt);
+void _unlinkTaskFromWaitList(CosTask_t *task_pt);
+CosTask_t *_insertTaskSortedByPrio(CosTask_t *root_pt, CosTask_t *task_pt);
+CosTask_t *_moveTaskBehindEqualPrio(CosTask_t *root_pt, CosTask_t *task_pt);
+CosTask_t *_newTask(uint8_t prio, void * pData, void (*func) (CosTask_t *));
+void _freeTask(CosTask_t *task_pt);
 
 
 
-Node_t *_addTaskAtBeginningOfTaskList(Node_t *root_pt, CosTask_t *task_pt);
-Node_t *_unlinkTaskFromTaskList(Node_t *root_pt, CosTask_t *task_pt);
-Node_t *_searchTaskInList(Node_t *root_pt, CosTask_t *task_pt);
-Node_t *_searchPredecessorTaskInList(Node_t *root_pt, CosTask_t *task_pt);
-Node_t *_newNode(CosTask_t *task_pt);
-void _sortLinearListPrio(Node_t *root_pt);
-CosTask_t *_newTask(uint8_t prio, void * pData, void (*func) (CosTask_t *));
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Statistik des Task-Pools, siehe COS_GetTaskPoolStats().
+  Ohne COS_USE_STATIC_POOLS wird ueber malloc() und free() gezaehlt,
+  'size' ist dann 0.
+ ********************************************************************/
+typedef struct {
+    uint16_t size;        /*!< Anzahl der Elemente im Pool, 0 fuer Heap */
+    uint16_t used;        /*!< aktuell belegte Elemente */
+    uint16_t highWater;   /*!< maximal gleichzeitig belegte Elemente */
+    uint16_t allocFails;  /*!< Anzahl fehlgeschlagener Anforderungen */
+} CosPoolStats_t;
+
+void COS_GetTaskPoolStats(CosPoolStats_t *stats);
 
 
 
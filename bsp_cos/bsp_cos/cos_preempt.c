@@ -0,0 +1,426 @@
+/*!
+ ********************************************************************
+   @file            cos_preempt.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : preemptive Tasks mit eigenem Stack fuer den COS
+
+   @brief  Auswahl der P-Task, Tick und Warten, ohne Hardware.
+
+   @par Beschreibung
+   Siehe cos_preempt.h. Fuer jede Prioritaet gibt es hoechstens eine
+   P-Task, readyMask_g und sleepMask_g haben je ein Bit pro Prioritaet.
+   Die bereite Task mit der hoechsten Prioritaet ist damit ein 'count
+   leading zeros', wie in der Ready-Queue des Schedulers. Beide Masken
+   werden auch von ISRs geaendert, jeder Zugriff der Tasks geschieht
+   daher mit kurz gesperrten Interrupts. Der Hintergrund (Scheduler der
+   kooperativen Tasks) ist bgTask_g und laeuft, wenn readyMask_g leer
+   ist.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include "cos_preempt.h"
+#include "cos_defer.h"
+#include "cos_trace.h"
+
+
+#if COS_PREEMPT
+
+#if COS_PREEMPT_MAX_TASKS > 32
+  #error "COS_PREEMPT_MAX_TASKS must not exceed 32"
+#endif
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static CosPTask_t *tasks_g[COS_PREEMPT_MAX_TASKS]; /*! P-Task je Prioritaet */
+static volatile uint32_t readyMask_g=0;   /*! Bit prio: Task bereit */
+static volatile uint32_t sleepMask_g=0;   /*! Bit prio: Task schlaeft */
+static CosPTask_t bgTask_g = { NULL, NULL, NULL, 0, 0, COS_PREEMPT_MAX_TASKS,
+                               COS_PTASK_READY };  /*! kooperative Stufe */
+
+/*! laufende P-Task oder &bgTask_g, wird von SWINT gelesen und geschrieben */
+CosPTask_t *_preemptCurrent_pt = &bgTask_g;
+
+
+
+/*---------------------------------------------------------------*/
+static CosPTask_t *_highestReady(void)
+{
+    if(0 == readyMask_g)
+    {   return &bgTask_g;
+    }
+    return tasks_g[31 - __builtin_clz((unsigned int) readyMask_g)];
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Loest den Taskwechsel aus, falls eine andere Task als die
+       laufende die hoechste bereite ist. Bei gesperrten Interrupts
+       aufrufen, der Wechsel geschieht dann beim Freigeben.
+ ********************************************************************/
+static void _reschedule(void)
+{
+    if(_highestReady() != _preemptCurrent_pt)
+    {   _preemptRequestSwitch();
+    }
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Legt eine P-Task an und macht sie bereit. Hat sie eine hoehere
+       Prioritaet als der Aufrufer, laeuft sie sofort.
+
+  @param  t          - OUT, Zeiger auf CosPTask_t
+  @param  prio       - IN, 0 ... COS_PREEMPT_MAX_TASKS-1, noch frei
+  @param  func       - IN, Funktion der Task, kehrt normalerweise nie zurueck
+  @param  arg        - IN, Argument fuer func
+  @param  stack_p    - IN, Stack der Task, 32 Bit ausgerichtet
+  @param  stackWords - IN, Groesse des Stacks in 32 Bit Worten,
+                       mindestens COS_PREEMPT_MIN_STACK
+  @retval 0 fuer ok, -1 falls prio belegt oder ein Parameter falsch ist
+
+  @par Code-Beispiel:
+  @verbatim
+  static CosPTask_t ctrl;
+  static uint32_t ctrlStack[256];
+
+  static void _ctrlLoop(void *arg)
+  {   CosTicks_t last = _gettime_Ticks32();
+      while(1)
+      {   COS_PTaskSleepUntil(&last, 1);   // 1 kHz
+          _controlStep();
+      }
+  }
+  ...
+  COS_PTaskCreate(&ctrl, 7, _ctrlLoop, NULL, ctrlStack, 256);
+  @endverbatim
+ ********************************************************************/
+int8_t COS_PTaskCreate(CosPTask_t *t, uint8_t prio, void (*func)(void *arg),
+                       void *arg, uint32_t *stack_p, uint16_t stackWords)
+{
+    uint32_t psw;
+
+    if((prio >= COS_PREEMPT_MAX_TASKS) || (NULL != tasks_g[prio]) ||
+       (NULL == func) || (stackWords < COS_PREEMPT_MIN_STACK))
+    {   return -1;
+    }
+    t->func = func;
+    t->arg = arg;
+    t->wake_Ticks = 0;
+    t->notifyCnt = 0;
+    t->prio = prio;
+    t->state = COS_PTASK_READY;
+    _preemptInitContext(t, stack_p, stackWords);
+
+    COS_IRQ_SAVE(psw);
+    tasks_g[prio] = t;
+    readyMask_g |= 1UL << prio;
+    _reschedule();
+    COS_IRQ_RESTORE(psw);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Die laufende P-Task schlaeft t_Ticks Ticks, andere Tasks laufen
+       solange. Nur aus einer P-Task aufrufen.
+
+  @see COS_PTaskSleepUntil()
+  @param  t_Ticks - IN, Schlafzeit in Ticks, 0 kehrt sofort zurueck
+  @retval keine
+ ********************************************************************/
+void COS_PTaskSleep(CosTicks_t t_Ticks)
+{
+    CosPTask_t *t = _preemptCurrent_pt;
+    uint32_t psw;
+
+    if((0 == t_Ticks) || (&bgTask_g == t))
+    {   return;
+    }
+    COS_IRQ_SAVE(psw);
+    t->wake_Ticks = _gettime_Ticks32() + t_Ticks;
+    t->state = COS_PTASK_SLEEPING;
+    readyMask_g &= ~(1UL << t->prio);
+    sleepMask_g |= 1UL << t->prio;
+    _idleWakeRequest();   /* a tickless idle must see the new wake time */
+    _reschedule();
+    COS_IRQ_RESTORE(psw);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Schlaeft bis *last_pTicks + period_Ticks und traegt diesen
+       Zeitpunkt in *last_pTicks ein. Eine Schleife damit laeuft mit
+       fester Periode, ohne dass sich die Laufzeit der Task aufaddiert.
+       Ist der Zeitpunkt schon vorbei, kehrt die Funktion sofort
+       zurueck. Nur aus einer P-Task aufrufen.
+
+  @param  last_pTicks  - IN/OUT, letzter Weckzeitpunkt
+  @param  period_Ticks - IN, Periode in Ticks
+  @retval keine
+ ********************************************************************/
+void COS_PTaskSleepUntil(CosTicks_t *last_pTicks, CosTicks_t period_Ticks)
+{
+    CosPTask_t *t = _preemptCurrent_pt;
+    CosTicks_t wake = *last_pTicks + period_Ticks;
+    uint32_t psw;
+
+    *last_pTicks = wake;
+    if(&bgTask_g == t)
+    {   return;
+    }
+    COS_IRQ_SAVE(psw);
+    if((int32_t)(wake - _gettime_Ticks32()) > 0)
+    {   t->wake_Ticks = wake;
+        t->state = COS_PTASK_SLEEPING;
+        readyMask_g &= ~(1UL << t->prio);
+        sleepMask_g |= 1UL << t->prio;
+        _idleWakeRequest();
+        _reschedule();
+    }
+    COS_IRQ_RESTORE(psw);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wartet auf COS_PTaskNotify() fuer die laufende P-Task. Jeder
+       Aufruf verbraucht eine Benachrichtigung, sind noch welche offen,
+       kehrt die Funktion sofort zurueck. Nur aus einer P-Task aufrufen.
+
+  @see COS_PTaskNotify()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void COS_PTaskWait(void)
+{
+    CosPTask_t *t = _preemptCurrent_pt;
+    uint32_t psw;
+
+    if(&bgTask_g == t)
+    {   return;
+    }
+    COS_IRQ_SAVE(psw);
+    while(0 == t->notifyCnt)
+    {   t->state = COS_PTASK_WAITING;
+        readyMask_g &= ~(1UL << t->prio);
+        _reschedule();
+        COS_IRQ_RESTORE(psw);   /* the switch happens here */
+        COS_IRQ_SAVE(psw);
+    }
+    t->notifyCnt--;
+    COS_IRQ_RESTORE(psw);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Benachrichtigt eine P-Task, eine wartende wird bereit. Hat sie
+       eine hoehere Prioritaet als die laufende Task, wird sofort bzw.
+       am Ende der ISR gewechselt. Aus ISRs, kooperativen Tasks und
+       P-Tasks erlaubt.
+
+  @see COS_PTaskWait()
+  @param  t - IN/OUT, Zeiger auf CosPTask_t
+  @retval keine
+ ********************************************************************/
+void COS_PTaskNotify(CosPTask_t *t)
+{
+    uint32_t psw;
+
+    COS_IRQ_SAVE(psw);
+    if(t->notifyCnt < 0xFFFF)
+    {   t->notifyCnt++;
+    }
+    if(COS_PTASK_WAITING == t->state)
+    {   t->state = COS_PTASK_READY;
+        readyMask_g |= 1UL << t->prio;
+        _reschedule();
+    }
+    COS_IRQ_RESTORE(psw);
+}
+/*---------------------------------------------------------------*/
+#if COS_DEFER
+/*!
+ ********************************************************************
+  @par Beschreibung
+       COS_DeferFromISR() fuer P-Tasks: func(obj, arg) laeuft spaeter
+       in der kooperativen Stufe, z.B. um dort einen Semaphor zu
+       signalisieren. Die Interrupts sind dabei kurz gesperrt, weil
+       die Defer-Queue nur einen Schreiber zur Zeit erlaubt.
+
+  @see COS_DeferFromISR()
+  @retval 0 fuer ok, -1 falls die Queue voll ist
+ ********************************************************************/
+int8_t COS_PTaskDefer(void (*func)(void *obj, uint16_t arg), void *obj, uint16_t arg)
+{
+    uint32_t psw;
+    int8_t ret;
+
+    COS_IRQ_SAVE(psw);
+    ret = COS_DeferFromISR(func, obj, arg);
+    COS_IRQ_RESTORE(psw);
+    return ret;
+}
+/*---------------------------------------------------------------*/
+#endif
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die laufende P-Task, NULL in der kooperativen Stufe.
+
+  @param  keine
+  @retval Zeiger auf CosPTask_t oder NULL
+ ********************************************************************/
+CosPTask_t *COS_PTaskSelf(void)
+{
+    return (&bgTask_g == _preemptCurrent_pt) ? NULL : _preemptCurrent_pt;
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wird von der Tick-ISR aufgerufen und weckt alle P-Tasks, deren
+       Schlafzeit abgelaufen ist. Die Schleife laeuft nur ueber die
+       Bits von sleepMask_g.
+
+  @param  now_Ticks - IN, aktuelle Systemzeit in Ticks
+  @retval keine
+ ********************************************************************/
+void _preemptTick(CosTicks_t now_Ticks)
+{
+    uint32_t m = sleepMask_g;
+    uint8_t p;
+    CosPTask_t *t;
+
+    while(0 != m)
+    {   p = (uint8_t)(31 - __builtin_clz((unsigned int) m));
+        m &= ~(1UL << p);
+        t = tasks_g[p];
+        if((int32_t)(now_Ticks - t->wake_Ticks) >= 0)
+        {   t->state = COS_PTASK_READY;
+            sleepMask_g &= ~(1UL << p);
+            readyMask_g |= 1UL << p;
+        }
+    }
+    _reschedule();
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wird vom Taskwechsel (SWINT) bei gesperrten Interrupts
+       aufgerufen, nachdem der Kontext der laufenden Task gesichert
+       ist, und stellt _preemptCurrent_pt auf die naechste Task.
+
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void _preemptSelectNext(void)
+{
+    CosPTask_t *next = _highestReady();
+
+    if(next != _preemptCurrent_pt)
+    {   COS_TRACE_EVENT(COS_TRACE_SWITCH, next, next->prio);
+    }
+    _preemptCurrent_pt = next;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Erster Code jeder P-Task, steht im Anfangs-Kontext von
+       _preemptInitContext(). Kehrt die Funktion der Task zurueck,
+       wird die Task COS_PTASK_DORMANT und laeuft nie wieder.
+
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void _preemptTaskStart(void)
+{
+    CosPTask_t *t = _preemptCurrent_pt;
+    uint32_t psw;
+
+    t->func(t->arg);
+
+    COS_IRQ_SAVE(psw);
+    t->state = COS_PTASK_DORMANT;
+    readyMask_g &= ~(1UL << t->prio);
+    _reschedule();
+    COS_IRQ_RESTORE(psw);
+    while(1)
+    {   /* not reached */
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die Ticks bis zur naechsten Weckzeit einer schlafenden
+       P-Task, fuer TICKLESS_IDLE im Scheduler.
+
+  @param  now_Ticks - IN, aktuelle Systemzeit in Ticks
+  @retval Ticks, mindestens 1, 0xFFFFFFFF falls keine P-Task schlaeft
+ ********************************************************************/
+CosTicks_t _preemptTicksUntilWake(CosTicks_t now_Ticks)
+{
+    CosTicks_t best = 0xFFFFFFFFUL;
+    int32_t d;
+    uint32_t m = sleepMask_g;
+    uint8_t p;
+
+    while(0 != m)
+    {   p = (uint8_t)(31 - __builtin_clz((unsigned int) m));
+        m &= ~(1UL << p);
+        d = (int32_t)(tasks_g[p]->wake_Ticks - now_Ticks);
+        if(d < 1)
+        {   d = 1;   /* due: the next tick wakes it */
+        }
+        if((CosTicks_t) d < best)
+        {   best = (CosTicks_t) d;
+        }
+    }
+    return best;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert 1, falls gerade die kooperative Stufe laeuft.
+ ********************************************************************/
+uint8_t _preemptInBackground(void)
+{
+    return (&bgTask_g == _preemptCurrent_pt) ? 1 : 0;
+}
+/*---------------------------------------------------------------*/
+
+#endif  // COS_PREEMPT
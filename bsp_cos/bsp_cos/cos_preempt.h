@@ -0,0 +1,134 @@
+/*!
+ ********************************************************************
+   @file            cos_preempt.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : preemptive Tasks mit eigenem Stack fuer den COS
+
+   @brief  Optionale preemptive Stufe ueber den kooperativen Tasks,
+           fuer Regelschleifen mit begrenzter Latenz.
+
+
+   @section Wie funktioniert die preemptive Stufe?
+                Eine kooperative Task (Protothread) gibt die CPU erst ab,
+                wenn sie zurueckkehrt, eine lange Task verzoegert also
+                jede hoeher priorisierte. Fuer wenige Tasks mit harten
+                Zeitgrenzen gibt es daher P-Tasks (CosPTask_t): normale
+                C-Funktionen mit eigenem Stack, die jede kooperative Task
+                unterbrechen. Der Scheduler mit allen kooperativen Tasks
+                laeuft als Hintergrund auf dem Stack von main() und kommt
+                nur dran, wenn keine P-Task bereit ist.
+
+                Jede P-Task hat eine eigene Prioritaet von 0 bis
+                COS_PREEMPT_MAX_TASKS-1, die hoehere Zahl gewinnt. Es
+                laeuft immer die bereite P-Task mit der hoechsten
+                Prioritaet. Eine P-Task wartet mit COS_PTaskSleep(),
+                COS_PTaskSleepUntil() oder COS_PTaskWait(), geweckt wird
+                sie vom Tick (ISR von CMT0) bzw. von COS_PTaskNotify(),
+                auch aus ISRs und kooperativen Tasks.
+
+                Der Taskwechsel selbst laeuft im Software-Interrupt
+                SWINT mit der niedrigsten Interrupt-Prioritaet: er
+                beginnt, sobald die ISR, die eine P-Task bereit gemacht
+                hat, zurueckkehrt. Die Latenz ist damit die Laufzeit
+                der ISRs plus ein Taskwechsel.
+
+                P-Tasks duerfen keine Funktionen der kooperativen Stufe
+                (COS_SEM_SIGNAL(), COS_EventSet(), ...) aufrufen, deren
+                Listen sind nur untereinander konsistent. Daten gehen
+                mit COS_PTaskDefer() ueber die Defer-Queue an die
+                kooperativen Tasks, wie aus einer ISR.
+
+                Fuer das Target muss COS_PREEMPT_IS_PRESENT in bsp.h 1
+                sein: das Programm laeuft dann im Supervisor-Mode auf
+                dem USP, die ISRs auf dem ISP. Mit TICKLESS_IDLE wartet
+                der Scheduler hoechstens bis zur naechsten Weckzeit einer
+                P-Task. Die Hardware-Funktionen (_preemptInitContext(),
+                _preemptRequestSwitch(), ISR von SWINT) stehen in
+                cos_systime.c, im Host-Port in cos_host.c.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_preempt_h_
+#define _cos_preempt_h_
+
+
+#include "cos_types.h"
+#include "cos_systime.h"
+
+/*! 1: preemptive Stufe vorhanden, 0: kein Code im Tick und kein SWINT */
+#if defined(COS_HOST)
+  #define COS_PREEMPT            1   /* host port: ucontext, see cos_host.c */
+#else
+  #include "bsp.h"
+  #define COS_PREEMPT            COS_PREEMPT_IS_PRESENT
+#endif
+/*! Anzahl der Prioritaeten und damit der P-Tasks, hoechstens 32 */
+#define COS_PREEMPT_MAX_TASKS    8
+/*! kleinster Stack einer P-Task in 32 Bit Worten (Kontext plus Reserve) */
+#define COS_PREEMPT_MIN_STACK    64
+
+
+/* Zustand einer P-Task */
+#define COS_PTASK_READY          0  /*!< bereit oder laufend */
+#define COS_PTASK_SLEEPING       1  /*!< wartet auf wake_Ticks */
+#define COS_PTASK_WAITING        2  /*!< wartet auf COS_PTaskNotify() */
+#define COS_PTASK_DORMANT        3  /*!< Funktion ist zurueckgekehrt */
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Eine P-Task. Der Speicher gehoert dem Aufrufer und muss gueltig
+  bleiben, solange die Task existiert.
+ ********************************************************************/
+typedef struct {
+        uint32_t *sp;                  /*!< gesicherter Stackpointer, muss
+                                            erstes Element sein (SWINT) */
+        void (*func)(void *arg);       /*!< Funktion der Task */
+        void *arg;                     /*!< Argument fuer func */
+        CosTicks_t wake_Ticks;         /*!< Weckzeit bei COS_PTASK_SLEEPING */
+        volatile uint16_t notifyCnt;   /*!< Anzahl offener COS_PTaskNotify() */
+        uint8_t prio;                  /*!< Prioritaet, eindeutig */
+        volatile uint8_t state;        /*!< COS_PTASK_READY ... */
+} CosPTask_t;
+
+
+int8_t  COS_PTaskCreate(CosPTask_t *t, uint8_t prio, void (*func)(void *arg),
+                        void *arg, uint32_t *stack_p, uint16_t stackWords);
+void    COS_PTaskSleep(CosTicks_t t_Ticks);
+void    COS_PTaskSleepUntil(CosTicks_t *last_pTicks, CosTicks_t period_Ticks);
+void    COS_PTaskWait(void);
+void    COS_PTaskNotify(CosPTask_t *t);
+int8_t  COS_PTaskDefer(void (*func)(void *obj, uint16_t arg), void *obj, uint16_t arg);
+CosPTask_t *COS_PTaskSelf(void);
+
+/* intern: Tick-ISR, SWINT bzw. Host-Port */
+extern CosPTask_t *_preemptCurrent_pt;
+void    _preemptTick(CosTicks_t now_Ticks);
+void    _preemptSelectNext(void);
+void    _preemptTaskStart(void);
+uint8_t _preemptInBackground(void);
+CosTicks_t _preemptTicksUntilWake(CosTicks_t now_Ticks);
+
+/* intern: Hardware, cos_systime.c bzw. cos_host.c */
+void    _preemptInitContext(CosPTask_t *t, uint32_t *stack_p, uint16_t stackWords);
+void    _preemptRequestSwitch(void);
+
+
+#endif
@@ -105,8 +105,8 @@ sleepTime_Ticks auf 0, d.h. die Task-Funktion muss explizit ihre
 gewuenschte sleepTime_Ticks bei jedem Aufruf erneut selbst setzen,
 siehe Beispiel weiter unten!
 
-Es gibt immer mindestens eine Task: die idle-Task mit ihrer callback-
-Funktion static void idleTask(CosTask_t *task_pt);
+Es gibt immer mindestens eine Task: die cpu-load-Task mit ihrer callback-
+Funktion static void _cpuLoadMeasureTask(CosTask_t *task_pt);
 
 Alle anderen Task-Funktionen haben ebenfalls keinen Rueckgabewert und
 besitzen den einzigen Parameter CosTask_t*.
@@ -116,38 +116,80 @@ wird nicht geloescht und es gibt kein regulaeres Programmende (auf den
 Atmel uC darf die main() Funktion nie enden).
 
 Als erstes ist die Funktion int COS_InitTaskList(void); aufzurufen, die
-die idle-Task in die Task-Liste eintraegt.
+die cpu-load-Task in die Task-Liste eintraegt.
 
 Der Scheduler hat zwei moegliche Modi: prioritaetsbasiert oder
 'round-robin'.
 
 Das prioritaetsbasierte Scheduling erfordert eine nach Prioritaeten
-sortierte Task-Liste. Im prioritaetsbasierten Modus kann eine Schaetzung
-der CPU-Auslastung mit zwei Tasks erreicht werden: Die cpu-load-Task
-hat die maximale Prioritaet und setzt einen Zaehler auf den Wert 100.
-Die idle-Task mit niedrigster Prioritaet dekrementiert den Zaehler.
-Die Task-Perioden sind so einzustellen, das die cpu-load-Task einmal
-laeuft, waehrend die idle-Task 100 Aufrufe schafft, dies ohne weitere
-CPU-Last durch andere Tasks. Der Zaehlerstand ist dann ein Mass fuer
-die Auslastung: bei wachsender Last kommt die idle-Task nicht oft genug
-dran, um den Zaehler bis auf 0 zu verringern.
-
-Wird der Scheduler im round-robin Modus betrieben, so funktioniert die
-Lastabschaetzung nicht, sie richtet aber auch keinen Schaden an.
+sortierte Task-Liste.
+
+Die CPU-Last wird in allen Modi gemessen: der Scheduler summiert mit
+_getCycles() die Laufzeit aller Task-Funktionen (busy). Die cpu-load-Task
+vergleicht alle 100 ms diese Summe mit der vergangenen Zeit. Daraus
+entstehen die Last der letzten 100 ms, 1 s und 10 s (Fenster einstellbar
+mit CPU_LOAD_WINDOW_MID_SAMPLES und CPU_LOAD_WINDOW_LONG_SAMPLES), ein
+gleitender Mittelwert (EMA) und die hoechste 100 ms Last seit dem letzten
+COS_ResetCPULoadPeak(). Die Zeit im Scheduler selbst und im WAIT-Zustand
+gilt als idle. Siehe COS_GetCPULoadPermille().
+
+Nach jedem Lauf faengt der prioritaetsbasierte Scheduler wieder vorne in
+der Task-Liste an. Ohne weitere Massnahme gewinnt unter mehreren
+bereiten Tasks gleicher Prioritaet immer die vordere. Mit
+FAIR_EQUAL_PRIO_SCHEDULING 1 (Vorgabe 0) wird eine Task nach ihrem Lauf hinter die
+anderen Tasks ihrer Prioritaet gehaengt. Bei k bereiten Tasks einer
+Prioritaet kommt jede Task spaetestens nach k-1 Laeufen ihrer Stufe
+(plus der Laufzeit hoeher priorisierter Tasks) wieder an die Reihe.
+
+Im prioritaetsbasierten Modus kann mit READY_QUEUE_SCHEDULING 1 eine
+Ready-Queue benutzt werden: fuer jede Prioritaet gibt es eine Liste der
+lauffaehigen Tasks, ein Bitmap merkt sich, welche dieser Listen nicht
+leer sind. Die Task mit der hoechsten Prioritaet wird mit 'count leading
+zeros' im Bitmap gefunden, die Kosten dafuer sind unabhaengig von der
+Anzahl der Tasks. Schlafende Tasks stehen in einer nach Weckzeit
+sortierten Sleep-Queue (Delta-Liste). Bei einem neuen Tick werden nur die
+Tasks am Anfang dieser Queue angefasst, deren Sleep-Zeit abgelaufen ist.
+Blockierte und suspendierte Tasks
+stehen in keiner Queue des Schedulers.
+
+Mit TICKLESS_IDLE 1 (nur zusammen mit der Ready-Queue) laeuft der
+Scheduler nicht mehr mit 100% CPU-Last im Kreis, wenn keine Task bereit
+ist. Er liest die naechste Weckzeit am Anfang der Sleep-Queue ab und
+haelt die CPU mit _idleWaitTicks() bis dahin an, siehe cos_systime.c.
+Die CPU-Lastmessung funktioniert hier genauso wie in den anderen Modi.
+
+Mit EDF_SCHEDULING 1 (nur zusammen mit der Ready-Queue) laeuft statt der
+Task mit der hoechsten Prioritaet die bereite Task mit der naechsten
+absoluten Deadline ('earliest deadline first'). Jede Task kann mit
+COS_SetTaskDeadline() eine relative Deadline bekommen, die Ready-Queue
+ist dann ein Min-Heap mit O(log n) fuer Einfuegen und Entnehmen. Tasks
+ohne Deadline (z.B. die cpu-load-Task) laufen nach Prioritaet, wenn keine
+Task mit Deadline bereit ist.
+
+Mit COS_HRTIMER 1 (cos_hrtimer.h) ruft jeder Scheduler-Modus am Anfang
+jedes Durchlaufs _hrTimerWakeTasks() auf: Tasks, die mit
+COS_HRTIMER_SLEEP() auf einen HR-Timer warten, werden dort bereit
+gemacht, nicht in der ISR von CMT1. Ebenso arbeitet er mit COS_DEFER 1
+(cos_defer.h) die Auftraege ab, die ISRs mit COS_DeferFromISR() bzw.
+COS_DeferSemSignalFromISR() eingetragen haben.
+
+Mit COS_PREEMPT 1 (cos_preempt.h) laeuft der ganze Scheduler als
+unterste Stufe unter preemptiven P-Tasks mit eigenem Stack. Er merkt
+davon nichts, nur TICKLESS_IDLE wartet hoechstens bis zur Weckzeit der
+ersten schlafenden P-Task.
+
+Neben den Semaphoren gibt es Event-Flags und eine Mailbox mit einem
+Platz (cos_event.h). Die wartende Task steht direkt im Objekt und wird
+mit _makeTaskReady() geweckt, ohne eine Liste zu durchsuchen.
 
   @verbatim
-  list of tasks:
-                    node
+  list of tasks (Verkettung direkt in der Task-Struktur):
+                    task
     root          --------      --------           --------
     -----         |      |----->|      |-- ... --->|      |----> NULL
     |   |-------->|      |      |      |           |      |
-    -----         --------      --------           --------
-                     |             |                  |
-                     \/            \/                 \/
-                   -----         -----              -----
-                   |   |         |   |              |   |
-                   -----         -----              -----
-                   task
+    -----  NULL<--|      |<-----|      |<-- ... ---|      |
+                  --------      --------           --------
   @endverbatim
 
 
@@ -156,16 +198,78 @@ Lastabschaetzung nicht, sie richtet aber auch keinen Schaden an.
 #include "cos_scheduler.h"
 #include <stdlib.h>
 #include "cos_ser.h"
+#include "cos_trace.h"
+#include "cos_hrtimer.h"
+#include "cos_semaphore.h"
+#include "cos_defer.h"
+#include "cos_preempt.h"
 
 
 
+/* Die folgenden Schalter lassen sich beim Uebersetzen mit -D setzen, die
+   Host-Tests uebersetzen so jeden Scheduler-Modus (host/Makefile). */
+
 /*! 0 fuer round robin Tasking, 1 fuer prio-basierten Scheduler */
+#ifndef PRIO_BASED_SCHEDULING
 #define PRIO_BASED_SCHEDULING 1
+#endif
 
-#define IDLE_TASK_PERIOD_TICKS      _milliSecToTicks(10)
-#define IDLE_TASK_PRIO              0
-#define LOAD_MEASURE_TASK_PERIOD_TICKS (100*IDLE_TASK_PERIOD_TICKS)
+/*! nur bei PRIO_BASED_SCHEDULING 1: 0 fuer Suche in der linearen Task-Liste,
+    1 fuer O(1) Ready-Queue mit Prioritaets-Bitmap */
+#ifndef READY_QUEUE_SCHEDULING
+#define READY_QUEUE_SCHEDULING 0
+#endif
+
+/*! nur bei READY_QUEUE_SCHEDULING 1: 1 fuer 'tickless idle'. Ist keine Task
+    bereit, wartet der Scheduler mit _idleWaitTicks() bis zur naechsten
+    Weckzeit, statt die CPU mit Abfragen voll auszulasten */
+#ifndef TICKLESS_IDLE
+#define TICKLESS_IDLE 0
+#endif
+
+/*! nur bei PRIO_BASED_SCHEDULING 1 und READY_QUEUE_SCHEDULING 0: 1 fuer
+    faire Rotation unter Tasks gleicher Prioritaet. Eine Task wird nach
+    ihrem Lauf hinter die letzte Task ihrer Prioritaet umgehaengt, so dass
+    die Tasks weiter hinten in der Liste nicht verhungern. Die Ready-Queue
+    rotiert ohnehin, dort hat der Schalter keine Wirkung. Vorgabe 0: die
+    Reihenfolge in der Task-Liste bleibt wie bisher. */
+#ifndef FAIR_EQUAL_PRIO_SCHEDULING
+#define FAIR_EQUAL_PRIO_SCHEDULING 0
+#endif
+
+/*! nur bei READY_QUEUE_SCHEDULING 1: 1 fuer 'earliest deadline first'.
+    Die Ready-Queue ist dann ein Min-Heap nach absoluter Deadline, siehe
+    COS_SetTaskDeadline(). Tasks ohne Deadline laufen nach Prioritaet,
+    wenn keine Task mit Deadline bereit ist. */
+#ifndef EDF_SCHEDULING
+#define EDF_SCHEDULING 0
+#endif
+/*! nur bei EDF_SCHEDULING 1: maximale Anzahl Tasks = Groesse des Heap */
+#ifndef EDF_MAX_TASKS
+#define EDF_MAX_TASKS 64
+#endif
+
+/*! 1: der Scheduler misst Laufzeit und Start-Latenz jeder Task mit
+    _getCycles(), siehe COS_GetTaskProfile() und COS_PrintTaskList().
+    Kostet zwei Zeitmessungen pro Aufruf einer Task-Funktion. */
+#ifndef COS_TASK_PROFILING
+#define COS_TASK_PROFILING 1
+#endif
+
+#if TICKLESS_IDLE && !(PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING)
+  #error "TICKLESS_IDLE needs PRIO_BASED_SCHEDULING 1 and READY_QUEUE_SCHEDULING 1"
+#endif
+#if EDF_SCHEDULING && !(PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING)
+  #error "EDF_SCHEDULING needs PRIO_BASED_SCHEDULING 1 and READY_QUEUE_SCHEDULING 1"
+#endif
+
+#define LOAD_MEASURE_TASK_PERIOD_TICKS _milliSecToTicks(100)
 #define LOAD_MEASURE_TASK_PRIO      255
+/*! CPU-Last Fenster in Vielfachen der Messperiode (100 ms): 1 s und 10 s */
+#define CPU_LOAD_WINDOW_MID_SAMPLES   10
+#define CPU_LOAD_WINDOW_LONG_SAMPLES  100
+/*! Gewicht eines neuen 100 ms Wertes im gleitenden Mittel: 1/2^n */
+#define CPU_LOAD_EMA_SHIFT            3
 
 
 
@@ -211,19 +315,39 @@ static void _toggle_PD(uint8_t bit)
 /****************************************************************/
 /* private module variables */
 /****************************************************************/
-static Node_t *root_g=NULL;           /*! root Pointer der Task-Liste */
-static uint8_t cpuLoadPerCent_g=100;  /*! fuer CPU-Lastmessung */
-static uint8_t cpuLoadCounter_g=100;  /*! fuer CPU-Lastmessung */
+static CosTask_t *root_g=NULL;        /*! root Pointer der Task-Liste */
+static uint32_t busyCycles_g=0;       /*! Summe der Laufzeiten aller Task-Funktionen */
+static uint16_t cpuLoad_g[3];         /*! Last in Promille: 100 ms, mittleres, langes Fenster */
+static uint32_t cpuLoadEma_g=0;       /*! gleitendes Mittel, Promille << CPU_LOAD_EMA_SHIFT */
+static uint16_t cpuLoadPeak_g=0;      /*! hoechste 100 ms Last in Promille */
+static CosTask_t *running_pt_g=NULL;  /*! gerade laufende Task, NULL falls geloescht */
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+#if EDF_SCHEDULING
+static CosTask_t *edfHeap_g[EDF_MAX_TASKS]; /*! Ready-Queue als Min-Heap */
+static uint16_t edfHeapSize_g=0;      /*! Anzahl Tasks im Heap */
+static uint16_t edfSeq_g=0;           /*! Zaehler fuer die Einfuegereihenfolge */
+#else
+static uint32_t readyGroup_g=0;       /*! Bit i gesetzt: readyMap_g[i] != 0 */
+static uint32_t readyMap_g[8];        /*! Bit (prio & 31) in Wort (prio >> 5) */
+static CosTask_t *readyHead_g[256];   /*! Ready-Liste je Prioritaet, Anfang */
+static CosTask_t *readyTail_g[256];   /*! Ready-Liste je Prioritaet, Ende */
+#endif
+static CosTask_t *sleepRoot_g=NULL;   /*! Sleep-Queue, nach Weckzeit sortiert */
+static CosTicks_t sleepRef_g=0;         /*! Bezugszeit fuer das Delta der ersten Task */
+#endif
 /****************************************************************/
 
 /****************************************************************/
 /* private function prototypes */
 /****************************************************************/
 
-static void _idleTask(CosTask_t *pt);
 static void _cpuLoadMeasureTask(CosTask_t *pt);
-static CosTask_t *_idleTask_pt_g = NULL;
 static CosTask_t *_cpuLoadMeasureTask_pt_g = NULL;
+static void _enqueueTask(CosTask_t *t_pt, CosTicks_t t_Ticks);
+static void _dequeueTask(CosTask_t *t_pt);
+static void _releaseJob(CosTask_t *t_pt, CosTicks_t release_Ticks);
+static void _runTask(CosTask_t *t_pt, CosTicks_t t_Ticks);
+static uint8_t _isInTaskList(CosTask_t *t_pt);
 
 
 /****************************************************************/
@@ -240,59 +364,693 @@ static CosTask_t *_cpuLoadMeasureTask_pt_g = NULL;
 /*!
  ********************************************************************
   @par Beschreibung
-       Die Task-Ringliste besteht aus mindestens aus der idle-Task.
-       Diese Task hat die niedrigste Prioritaet.
-       Sie dekrementiert den internen Zaehler fuer die CPU-Lastmessung.
-       Bei geringer Auslastung der CPU laeuft sie 100 mal bevor die
-       cpu-load Task den Zaehler auf 100 zuruecksetzt. Der Zaehler kann
-       also nur bis auf 0 heruntergezaehlt werden, falls genug Zeit fuer
-       die idle-Task vorhanden ist.
+       Rechnet busy/total in Promille um, ohne 64 Bit Division: beide
+       Werte werden verkleinert, bis busy*1000 in 32 Bit passt.
 
-  @see
+  @param  busy  - IN, belegte Zeit
+  @param  total - IN, gesamte Zeit in derselben Einheit
+  @retval Last in Promille, 0..1000
+ ********************************************************************/
+static uint16_t _loadPermille(uint32_t busy, uint32_t total)
+{
+    if(busy >= total)
+    {   return (0 == total) ? 0 : 1000;
+    }
+    while(total > 4000000UL)
+    {   busy  >>= 1;
+        total >>= 1;
+    }
+    return (uint16_t)((busy * 1000UL) / total);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Diese Task misst die CPU-Last. Sie hat die hoechste Prioritaet
+       und laeuft alle LOAD_MEASURE_TASK_PERIOD_TICKS (100 ms). Sie
+       vergleicht die von _runTask() gezaehlte Laufzeit aller
+       Task-Funktionen mit der vergangenen Zeit, beides gemessen mit
+       _getCycles(). Eine lange laufende Task verfaelscht das Ergebnis
+       deshalb nicht, sie verschiebt nur den Messzeitpunkt. Der 100 ms
+       Wert geht in das gleitende Mittel und den Spitzenwert ein und
+       wird fuer das mittlere und das lange Fenster aufsummiert.
+
+  @see  COS_GetCPULoadPermille(), COS_GetCPULoadInPercent()
   @arg
 
   @param  keine
+
   @retval keine
  ********************************************************************/
-static void _idleTask(CosTask_t *pt)
+static void _cpuLoadMeasureTask(CosTask_t *pt)
 {
+    static uint32_t lastCycles, lastBusy;   /* values of the last run */
+    static uint32_t midBusy, midTotal, longBusy, longTotal;
+    static uint16_t midCount, longCount;
+    uint32_t now, busy, total;
+
     COS_TASK_BEGIN(pt);
+    lastCycles = _getCycles();
+    lastBusy   = busyCycles_g;
+    midBusy  = midTotal  = midCount  = 0;
+    longBusy = longTotal = longCount = 0;
     while(1)
-    {     if(cpuLoadCounter_g > 0)
-          {   cpuLoadCounter_g--;
+    {     COS_TASK_PERIODIC(pt,LOAD_MEASURE_TASK_PERIOD_TICKS);
+          now   = _getCycles();
+          busy  = busyCycles_g - lastBusy;
+          total = now - lastCycles;
+          lastCycles = now;
+          lastBusy   = busyCycles_g;
+
+          cpuLoad_g[COS_LOAD_SHORT] = _loadPermille(busy, total);
+          cpuLoadEma_g = cpuLoadEma_g - (cpuLoadEma_g >> CPU_LOAD_EMA_SHIFT)
+                         + cpuLoad_g[COS_LOAD_SHORT];
+          if(cpuLoad_g[COS_LOAD_SHORT] > cpuLoadPeak_g)
+          {   cpuLoadPeak_g = cpuLoad_g[COS_LOAD_SHORT];
+          }
+
+          midBusy += busy;   midTotal += total;
+          if(++midCount >= CPU_LOAD_WINDOW_MID_SAMPLES)
+          {   cpuLoad_g[COS_LOAD_MID] = _loadPermille(midBusy, midTotal);
+              midBusy = midTotal = midCount = 0;
+          }
+          longBusy += busy;  longTotal += total;
+          if(++longCount >= CPU_LOAD_WINDOW_LONG_SAMPLES)
+          {   cpuLoad_g[COS_LOAD_LONG] = _loadPermille(longBusy, longTotal);
+              longBusy = longTotal = longCount = 0;
           }
-          //DebugCode(_toggle_PD(5););
-          COS_TASK_SLEEP(pt,IDLE_TASK_PERIOD_TICKS);
     }
     COS_TASK_END(pt);
 }
 /*---------------------------------------------------------------*/
+
+
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+#if EDF_SCHEDULING
 /*!
  ********************************************************************
   @par Beschreibung
-       Diese Task ist optional. Sie hat die hoechste Prioritaet und
-       setzt den internen Zaehler auf 100. Der Zaehler wird durch die
-       idle-Task dekrementiert. Wenn die Auslastung gering ist, schafft
-       es die idle-Task 100 zu laufen bevor diese Task erneut laeuft.
-       Wenn der Rechner ausgelastet ist, kommt die idle-Task nie dran
-       und der Zaehler bleibt bei 100 stehen: die Last ist 100 Prozent.
+       Vergleichsfunktion des EDF-Heap. Tasks mit Deadline kommen vor
+       Tasks ohne Deadline, unter ihnen gewinnt die fruehere absolute
+       Deadline (Ueberlauf-sicher, Deadlines < 2^31 Ticks). Bei
+       gleicher Deadline und fuer Tasks ohne Deadline entscheidet die
+       Prioritaet, danach die Reihenfolge des Einfuegens.
+
+  @param  a_pt - IN, Zeiger auf Task-Struktur
+  @param  b_pt - IN, Zeiger auf Task-Struktur
+  @retval 1 falls a_pt vor b_pt laufen soll, sonst 0
+ ********************************************************************/
+static uint8_t _edfBefore(CosTask_t *a_pt, CosTask_t *b_pt)
+{
+    int32_t d;
 
-  @see  _idleTask(), COS_GetCPULoadInPercent()
-  @arg
+    if((0 != a_pt->deadline_Ticks) != (0 != b_pt->deadline_Ticks))
+    {   return (uint8_t)(0 != a_pt->deadline_Ticks);
+    }
+    if(0 != a_pt->deadline_Ticks)
+    {   d = (int32_t)(a_pt->absDeadline_Ticks - b_pt->absDeadline_Ticks);
+        if(0 != d)
+        {   return (uint8_t)(d < 0);
+        }
+    }
+    if(a_pt->prio != b_pt->prio)
+    {   return (uint8_t)(a_pt->prio > b_pt->prio);
+    }
+    return (uint8_t)((int16_t)(a_pt->edfSeq - b_pt->edfSeq) < 0);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Schiebt die Task an Position i im Heap nach oben, bis ihr
+       Vorgaenger nicht mehr nach ihr laufen soll. Jede Task merkt sich
+       ihren Index in heapIdx.
+
+  @param  i - IN, Index im Heap
+  @retval keine
+ ********************************************************************/
+static void _edfSiftUp(uint16_t i)
+{
+    CosTask_t *t_pt = edfHeap_g[i];
+    uint16_t parent;
+
+    while(i > 0)
+    {   parent = (uint16_t)((i - 1) >> 1);
+        if(!_edfBefore(t_pt, edfHeap_g[parent]))
+        {   break;
+        }
+        edfHeap_g[i] = edfHeap_g[parent];
+        edfHeap_g[i]->heapIdx = i;
+        i = parent;
+    }
+    edfHeap_g[i] = t_pt;
+    t_pt->heapIdx = i;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Schiebt die Task an Position i im Heap nach unten, bis keiner
+       ihrer Nachfolger vor ihr laufen soll.
+
+  @param  i - IN, Index im Heap
+  @retval keine
+ ********************************************************************/
+static void _edfSiftDown(uint16_t i)
+{
+    CosTask_t *t_pt = edfHeap_g[i];
+    uint16_t child;
+
+    while(1)
+    {   child = (uint16_t)(2 * i + 1);
+        if(child >= edfHeapSize_g)
+        {   break;
+        }
+        if((child + 1 < edfHeapSize_g) &&
+            _edfBefore(edfHeap_g[child + 1], edfHeap_g[child]))
+        {   child++;
+        }
+        if(!_edfBefore(edfHeap_g[child], t_pt))
+        {   break;
+        }
+        edfHeap_g[i] = edfHeap_g[child];
+        edfHeap_g[i]->heapIdx = i;
+        i = child;
+    }
+    edfHeap_g[i] = t_pt;
+    t_pt->heapIdx = i;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       EDF-Version: traegt eine lauffaehige Task in den Heap ein,
+       Aufwand O(log n). Die absolute Deadline muss vorher mit
+       _releaseJob() gesetzt sein.
 
+  @see _rqRemove(), _rqPopHighest()
+  @param  t_pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _rqInsert(CosTask_t *t_pt)
+{
+    t_pt->edfSeq = edfSeq_g++;
+    edfHeap_g[edfHeapSize_g] = t_pt;
+    t_pt->heapIdx = edfHeapSize_g;
+    edfHeapSize_g++;
+    _edfSiftUp(t_pt->heapIdx);
+    t_pt->queue = TASK_QUEUE_READY;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       EDF-Version: entfernt eine beliebige Task aus dem Heap. Die
+       letzte Task des Heap nimmt ihren Platz ein und wird nach oben
+       oder unten verschoben, Aufwand O(log n).
+
+  @see _rqInsert()
+  @param  t_pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _rqRemove(CosTask_t *t_pt)
+{
+    uint16_t i = t_pt->heapIdx;
+    CosTask_t *last_pt;
+
+    edfHeapSize_g--;
+    if(i != edfHeapSize_g)
+    {   last_pt = edfHeap_g[edfHeapSize_g];
+        edfHeap_g[i] = last_pt;
+        last_pt->heapIdx = i;
+        _edfSiftUp(i);
+        _edfSiftDown(last_pt->heapIdx);
+    }
+    t_pt->queue = TASK_QUEUE_NONE;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       EDF-Version: entnimmt die Task mit der naechsten Deadline, sie
+       steht an der Wurzel des Heap.
+
+  @see _rqInsert()
   @param  keine
+  @retval Zeiger auf die Task oder NULL, falls keine Task bereit ist
+ ********************************************************************/
+static CosTask_t *_rqPopHighest(void)
+{
+    CosTask_t *t_pt;
+
+    if(0 == edfHeapSize_g)
+    {   return NULL;
+    }
+    t_pt = edfHeap_g[0];
+    _rqRemove(t_pt);
+    return t_pt;
+}
+/*---------------------------------------------------------------*/
+#else
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Zaehlt die fuehrenden Nullen eines 32 Bit Wortes, x darf nicht
+       0 sein. Der gcc setzt __builtin_clz() auf den schnellsten fuer
+       den Controller verfuegbaren Code um.
+
+  @param  x - IN, Wort ungleich 0
+  @retval Anzahl der fuehrenden Nullbits, 0..31
+ ********************************************************************/
+static uint8_t _clz32(uint32_t x)
+{
+#if defined(__GNUC__)
+    return (uint8_t) __builtin_clz((unsigned int) x);
+#else
+    uint8_t n = 0;
+    if((x & 0xFFFF0000UL) == 0) { n += 16; x <<= 16; }
+    if((x & 0xFF000000UL) == 0) { n +=  8; x <<=  8; }
+    if((x & 0xF0000000UL) == 0) { n +=  4; x <<=  4; }
+    if((x & 0xC0000000UL) == 0) { n +=  2; x <<=  2; }
+    if((x & 0x80000000UL) == 0) { n +=  1; }
+    return n;
+#endif
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Haengt eine lauffaehige Task an das Ende der Ready-Liste ihrer
+       Prioritaet und setzt das zugehoerige Bit im Prioritaets-Bitmap.
+
+  @see _rqRemove(), _rqPopHighest()
+  @param  t_pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _rqInsert(CosTask_t *t_pt)
+{
+    uint8_t p = t_pt->prio;
+
+    t_pt->rqNext_pt = NULL;
+    t_pt->rqPrev_pt = readyTail_g[p];
+    if(NULL == readyTail_g[p])
+    {   readyHead_g[p] = t_pt;
+    }
+    else
+    {   readyTail_g[p]->rqNext_pt = t_pt;
+    }
+    readyTail_g[p] = t_pt;
+    t_pt->queue = TASK_QUEUE_READY;
+
+    readyMap_g[p >> 5] |= (1UL << (p & 31));
+    readyGroup_g |= (1UL << (p >> 5));
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Entfernt eine Task aus der Ready-Liste ihrer Prioritaet. Wird
+       die Liste dadurch leer, so wird das Bit im Bitmap geloescht.
+
+  @see _rqInsert()
+  @param  t_pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _rqRemove(CosTask_t *t_pt)
+{
+    uint8_t p = t_pt->prio;
+
+    if(NULL == t_pt->rqPrev_pt)
+    {   readyHead_g[p] = t_pt->rqNext_pt;
+    }
+    else
+    {   t_pt->rqPrev_pt->rqNext_pt = t_pt->rqNext_pt;
+    }
+    if(NULL == t_pt->rqNext_pt)
+    {   readyTail_g[p] = t_pt->rqPrev_pt;
+    }
+    else
+    {   t_pt->rqNext_pt->rqPrev_pt = t_pt->rqPrev_pt;
+    }
+    t_pt->rqNext_pt = NULL;
+    t_pt->rqPrev_pt = NULL;
+    t_pt->queue = TASK_QUEUE_NONE;
+
+    if(NULL == readyHead_g[p])
+    {   readyMap_g[p >> 5] &= ~(1UL << (p & 31));
+        if(0 == readyMap_g[p >> 5])
+        {   readyGroup_g &= ~(1UL << (p >> 5));
+        }
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Sucht ueber das Bitmap die hoechste Prioritaet mit lauffaehigen
+       Tasks und entnimmt die erste Task dieser Ready-Liste. Der Aufwand
+       ist konstant, zwei 'count leading zeros' Operationen.
+
+  @see _rqInsert()
+  @param  keine
+  @retval Zeiger auf die Task oder NULL, falls keine Task bereit ist
+ ********************************************************************/
+static CosTask_t *_rqPopHighest(void)
+{
+    uint8_t w, p;
+    CosTask_t *t_pt;
+
+    if(0 == readyGroup_g)
+    {   return NULL;
+    }
+    w = 31 - _clz32(readyGroup_g);
+    p = (uint8_t)((w << 5) | (31 - _clz32(readyMap_g[w])));
+    t_pt = readyHead_g[p];
+    _rqRemove(t_pt);
+    return t_pt;
+}
+/*---------------------------------------------------------------*/
+#endif /* EDF_SCHEDULING */
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Sortiert eine schlafende Task nach ihrer Weckzeit in die
+       Sleep-Queue ein. Die Sleep-Queue ist eine Delta-Liste: jede Task
+       speichert in sleepDelta_Ticks nur die Differenz ihrer Weckzeit
+       zur Weckzeit ihres Vorgaengers, die erste Task die Differenz zu
+       sleepRef_g. Dadurch gibt es keine Probleme mit dem Ueberlauf der
+       32 Bit Systemzeit (CosTicks_t).
+
+  @verbatim
+    sleepRef_g   sleepRoot_g
+        |          ------     ------     ------
+        +--- 3 --->|    |-2-->|    |-0-->|    |----> NULL
+                   ------     ------     ------
+        Weckzeiten: ref+3      ref+5      ref+5
+  @endverbatim
+
+  @see _sleepRemove(), _wakeSleepingTasks()
+  @param  t_pt - IN, Zeiger auf Task-Struktur, Sleep-Zeit nicht abgelaufen
+  @retval keine
+ ********************************************************************/
+static void _sleepInsert(CosTask_t *t_pt)
+{
+    CosTask_t *prev_pt = NULL;
+    CosTask_t *pt = sleepRoot_g;
+    CosTicks_t delta;
+
+    /* remaining time relative to the reference of the list head */
+    delta = (CosTicks_t)(t_pt->lastActivationTime_Ticks +
+                         t_pt->sleepTime_Ticks - sleepRef_g);
+    /* tasks with equal wake-up time keep their FIFO order */
+    while((NULL != pt) && (pt->sleepDelta_Ticks <= delta))
+    {   delta -= pt->sleepDelta_Ticks;
+        prev_pt = pt;
+        pt = pt->rqNext_pt;
+    }
+    t_pt->sleepDelta_Ticks = delta;
+    t_pt->rqPrev_pt = prev_pt;
+    t_pt->rqNext_pt = pt;
+    if(NULL == prev_pt)
+    {   sleepRoot_g = t_pt;
+    }
+    else
+    {   prev_pt->rqNext_pt = t_pt;
+    }
+    if(NULL != pt)
+    {   pt->rqPrev_pt = t_pt;
+        pt->sleepDelta_Ticks -= delta;  /* successor is relative to us now */
+    }
+    t_pt->queue = TASK_QUEUE_SLEEP;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Entfernt eine Task aus der Sleep-Queue. Ihr Delta wird dem
+       Nachfolger gutgeschrieben, dessen Weckzeit bleibt unveraendert.
+
+  @see _sleepInsert()
+  @param  t_pt - IN, Zeiger auf Task-Struktur
+  @retval keine
+ ********************************************************************/
+static void _sleepRemove(CosTask_t *t_pt)
+{
+    if(NULL == t_pt->rqPrev_pt)
+    {   sleepRoot_g = t_pt->rqNext_pt;
+    }
+    else
+    {   t_pt->rqPrev_pt->rqNext_pt = t_pt->rqNext_pt;
+    }
+    if(NULL != t_pt->rqNext_pt)
+    {   t_pt->rqNext_pt->rqPrev_pt = t_pt->rqPrev_pt;
+        t_pt->rqNext_pt->sleepDelta_Ticks += t_pt->sleepDelta_Ticks;
+    }
+    t_pt->rqNext_pt = NULL;
+    t_pt->rqPrev_pt = NULL;
+    t_pt->queue = TASK_QUEUE_NONE;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Verschiebt alle Tasks, deren Sleep-Zeit abgelaufen ist, vom
+       Anfang der Sleep-Queue in die Ready-Queue und verschiebt den
+       Bezugszeitpunkt sleepRef_g auf die aktuelle Zeit. Es werden nur
+       die abgelaufenen Tasks angefasst, der Aufwand haengt also nicht
+       von der Anzahl der schlafenden Tasks ab.
+
+  @see _sleepInsert()
+  @param  t_Ticks - IN, aktuelle Zeit in Ticks
+  @retval keine
+ ********************************************************************/
+static void _wakeSleepingTasks(CosTicks_t t_Ticks)
+{
+    CosTask_t *t_pt;
+    CosTicks_t elapsed;
+
+    elapsed = (CosTicks_t)(t_Ticks - sleepRef_g);
+    sleepRef_g = t_Ticks;
+    while((NULL != sleepRoot_g) && (sleepRoot_g->sleepDelta_Ticks <= elapsed))
+    {   t_pt = sleepRoot_g;
+        elapsed -= t_pt->sleepDelta_Ticks;
+        t_pt->sleepDelta_Ticks = 0;
+        _sleepRemove(t_pt);
+        /* new job, released at its nominal wake-up time */
+        _releaseJob(t_pt, (CosTicks_t)(t_pt->lastActivationTime_Ticks +
+                                       t_pt->sleepTime_Ticks));
+        _rqInsert(t_pt);
+    }
+    if(NULL != sleepRoot_g)
+    {   sleepRoot_g->sleepDelta_Ticks -= elapsed;
+    }
+}
+/*---------------------------------------------------------------*/
+#if TICKLESS_IDLE
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Berechnet die Zeit bis zur naechsten Weckzeit in der Sleep-Queue.
+       Das ist die erste Task der Queue, es muss nichts gesucht werden.
+
+  @see _idleWaitTicks()
+  @param  t_Ticks - IN, aktuelle Zeit in Ticks
+  @retval Ticks bis zur naechsten Weckzeit, 0xFFFFFFFF falls keine Task schlaeft
+ ********************************************************************/
+static CosTicks_t _ticksUntilNextWakeup(CosTicks_t t_Ticks)
+{
+    CosTicks_t elapsed;
+
+    if(NULL == sleepRoot_g)
+    {   return 0xFFFFFFFFUL;  /* only an interrupt can make a task ready */
+    }
+    elapsed = (CosTicks_t)(t_Ticks - sleepRef_g);
+    if(sleepRoot_g->sleepDelta_Ticks <= elapsed)
+    {   return 0;
+    }
+    return (CosTicks_t)(sleepRoot_g->sleepDelta_Ticks - elapsed);
+}
+#endif
+#endif
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Prueft ohne Suche, ob eine Task in der Task-Liste steht: nur die
+       erste Task der Liste hat keinen Vorgaenger. Dazu wird die
+       Task-Struktur gelesen. Mit COS_USE_STATIC_POOLS 1 bleibt sie nach
+       COS_DeleteTask() im Pool, _freeTask() markiert sie mit
+       TASK_STATE_DELETED. Ein alter Zeiger wird so erkannt, bis der
+       Slot fuer eine neue Task vergeben wird. Mit COS_USE_STATIC_POOLS 0
+       ist der Speicher freigegeben, der Zeiger auf eine geloeschte Task
+       darf dann nicht mehr uebergeben werden.
+
+  @param  t_pt - IN, Zeiger auf eine Task-Struktur, die noch nicht mit
+                 free() freigegeben ist
+  @retval 1 falls die Task in der Liste steht, sonst 0
+ ********************************************************************/
+static uint8_t _isInTaskList(CosTask_t *t_pt)
+{
+    if((NULL == t_pt) || (TASK_STATE_DELETED == t_pt->state))
+    {   return 0;
+    }
+    return (uint8_t)((NULL != t_pt->prev_pt) || (root_g == t_pt));
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Beginnt einen neuen Lauf ('job') der Task zum Zeitpunkt
+       release_Ticks: bei EDF_SCHEDULING wird daraus die absolute
+       Deadline berechnet. Ein COS_TASK_SCHEDULE() setzt denselben Lauf
+       fort, die Deadline bleibt dann erhalten. Ohne EDF tut diese
+       Funktion nichts.
+
+  @param  t_pt          - IN, Zeiger auf Task-Struktur
+  @param  release_Ticks - IN, Startzeitpunkt des Laufs in Ticks
+  @retval keine
+ ********************************************************************/
+static void _releaseJob(CosTask_t *t_pt, CosTicks_t release_Ticks)
+{
+#if EDF_SCHEDULING
+    t_pt->absDeadline_Ticks = (CosTicks_t)(release_Ticks + t_pt->deadline_Ticks);
+#else
+    (void) t_pt;
+    (void) release_Ticks;
+#endif
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Startet die Task-Funktion, gemeinsam fuer alle Scheduler-Modi.
+       Setzt den Startzeitpunkt, loescht die Sleep-Zeit und merkt sich
+       die laufende Task in running_pt_g. Die Laufzeit wird fuer die
+       CPU-Lastmessung aufsummiert. Mit COS_TASK_PROFILING werden
+       die Start-Latenz und die Laufzeit der Task gemessen. Die Latenz
+       zaehlt ab dem spaeteren der beiden Zeitpunkte: Ende der
+       Sleep-Zeit (Beginn des Ticks) oder Bereitwerden der Task.
+       Hat sich die Task selbst geloescht, ist running_pt_g danach NULL.
+
+  @param  t_pt    - IN, Zeiger auf Task-Struktur
+  @param  t_Ticks - IN, aktuelle Zeit in Ticks
+  @retval keine
+ ********************************************************************/
+static void _runTask(CosTask_t *t_pt, CosTicks_t t_Ticks)
+{
+    uint32_t start, end;
+#if COS_TASK_PROFILING
+    CosTaskProfile_t *p = &(t_pt->prof);
+    uint32_t due, wake;
+#endif
+
+    start = _getCycles();
+#if COS_TASK_PROFILING
+    due = p->readyCycles;
+    if(0 != t_pt->sleepTime_Ticks)
+    {   wake = _cyclesAtTick((CosTicks_t)(t_pt->lastActivationTime_Ticks +
+                                          t_pt->sleepTime_Ticks));
+        if((int32_t)(wake - due) > 0)
+        {   due = wake;
+        }
+    }
+    if(((int32_t)(start - due) > 0) && ((start - due) > p->maxLatencyCycles))
+    {   p->maxLatencyCycles = start - due;
+    }
+#endif
+    t_pt->lastActivationTime_Ticks = t_Ticks;
+    /*  when the task function runs to its very end, the task will be deleted:
+        it will be removed from the list, and the task struct will be freed,
+        i.e. t_pt is no longer valid.
+    */
+    t_pt->sleepTime_Ticks = 0;  // Bugfix 22.10.2015: must be specified by task!
+    running_pt_g = t_pt;
+    COS_TRACE_EVENT(COS_TRACE_DISPATCH, t_pt, t_pt->prio);
+    t_pt->func(t_pt);  /* call task function, must not block! */
+    end = _getCycles();
+    busyCycles_g += (end - start);   /* for the cpu load */
+#if COS_TRACE
+    if(NULL != running_pt_g)
+    {   if(0 != t_pt->sleepTime_Ticks)
+        {   COS_TRACE_EVENT(COS_TRACE_SLEEP, t_pt, (t_pt->sleepTime_Ticks > 0xFFFFUL) ?
+                            0xFFFF : t_pt->sleepTime_Ticks);
+        }
+        else
+        {   COS_TRACE_EVENT(COS_TRACE_RETURN, t_pt, 0);
+        }
+    }
+#endif
+#if COS_TASK_PROFILING
+    if(NULL != running_pt_g)
+    {   p->runs++;
+        p->totalCycles += (end - start);
+        if((end - start) < p->minCycles) p->minCycles = end - start;
+        if((end - start) > p->maxCycles) p->maxCycles = end - start;
+        p->readyCycles = end;   /* ready again now, unless it sleeps */
+    }
+#endif
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Traegt eine Task im Zustand TASK_STATE_READY in die passende
+       Queue des Schedulers ein: in die Ready-Queue, falls ihre
+       Sleep-Zeit abgelaufen ist, sonst in die Sleep-Liste. Ohne
+       READY_QUEUE_SCHEDULING tut diese Funktion nichts, dort steht
+       jede Task immer in der linearen Task-Liste.
+
+  @see _dequeueTask()
+  @param  t_pt    - IN, Zeiger auf Task-Struktur
+  @param  t_Ticks - IN, aktuelle Zeit in Ticks
+  @retval keine
+ ********************************************************************/
+static void _enqueueTask(CosTask_t *t_pt, CosTicks_t t_Ticks)
+{
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+    if(t_pt->state != TASK_STATE_READY)
+    {   return;  /* blocked or suspended tasks are not queued */
+    }
+    if((CosTicks_t)(t_Ticks - t_pt->lastActivationTime_Ticks) >=
+        t_pt->sleepTime_Ticks)
+    {   if(0 != t_pt->sleepTime_Ticks)
+        {   /* sleep time already over: new job, no detour via sleep queue */
+            _releaseJob(t_pt, (CosTicks_t)(t_pt->lastActivationTime_Ticks +
+                                           t_pt->sleepTime_Ticks));
+        }
+        _rqInsert(t_pt);
+    }
+    else
+    {   _sleepInsert(t_pt);
+    }
+#else
+    (void) t_pt;
+    (void) t_Ticks;
+#endif
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Entfernt eine Task aus der Ready-Queue bzw. der Sleep-Liste,
+       falls sie dort eingetragen ist.
 
+  @see _enqueueTask()
+  @param  t_pt    - IN, Zeiger auf Task-Struktur
   @retval keine
  ********************************************************************/
-static void _cpuLoadMeasureTask(CosTask_t *pt)
+static void _dequeueTask(CosTask_t *t_pt)
 {
-    COS_TASK_BEGIN(pt);
-    while(1)
-    {     cpuLoadPerCent_g = cpuLoadCounter_g;  // remains constant for the period
-          cpuLoadCounter_g = 100;
-          COS_TASK_SLEEP(pt,LOAD_MEASURE_TASK_PERIOD_TICKS);
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+    if(TASK_QUEUE_READY == t_pt->queue)
+    {   _rqRemove(t_pt);
     }
-    COS_TASK_END(pt);
+    else if(TASK_QUEUE_SLEEP == t_pt->queue)
+    {   _sleepRemove(t_pt);
+    }
+#else
+    (void) t_pt;
+#endif
 }
 /*---------------------------------------------------------------*/
 
@@ -310,7 +1068,7 @@ static void _cpuLoadMeasureTask(CosTask_t *pt)
   @par Beschreibung
        Initialisiert die Task-Liste. Tasks werden in einer linearen
        Liste
-       gehalten, die mindestens aus der idle-Task besteht. Die Liste
+       gehalten, die mindestens aus der cpu-load-Task besteht. Die Liste
        wird nach Prioritaet sortiert. Die Task mit der hoechsten
        Prioritaet steht vorne in der Liste.
 
@@ -340,16 +1098,25 @@ int8_t COS_InitTaskList(void)
 {
     //DebugCode(_msg("InitTaskList\r\n"););
     root_g = NULL;  /* empty task list */
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+    {
+#if EDF_SCHEDULING
+        edfHeapSize_g = 0;
+#else
+        uint16_t i;
+        readyGroup_g = 0;
+        for(i=0; i<8; i++)   readyMap_g[i] = 0;
+        for(i=0; i<256; i++) readyHead_g[i] = readyTail_g[i] = NULL;
+#endif
+        sleepRoot_g = NULL;
+        sleepRef_g = _gettime_Ticks32();
+    }
+#endif
     /* task functions are kept in a linear list, that always has at least
-       one element: the idle task.
+       one element: the cpu load task.
     */
-
-    _idleTask_pt_g = COS_CreateTask(IDLE_TASK_PRIO, NULL, _idleTask);
-
-    /* add optional cpu load estimation task to list */
     _cpuLoadMeasureTask_pt_g = COS_CreateTask(LOAD_MEASURE_TASK_PRIO, NULL, _cpuLoadMeasureTask);
 
-    _sortLinearListPrio(root_g);
     return 0;
 }
 
@@ -431,6 +1198,15 @@ CosTask_t* COS_CreateTask(uint8_t prio, void * pData, void (*func) (CosTask_t *)
 
     //DebugCode(_msg("CreateTask\r\n"););
 
+#if EDF_SCHEDULING
+    {   CosPoolStats_t st;
+        COS_GetTaskPoolStats(&st);
+        if(st.used >= EDF_MAX_TASKS)  /* heap must hold every task */
+        {   DebugCode(_msg("CreateTask:EDF_MAX_TASKS!\r\n"););
+            return NULL;
+        }
+    }
+#endif
     /* allocate and init task struct */
     t_pt = _newTask(prio, pData, func);
     if(t_pt==NULL)
@@ -438,8 +1214,13 @@ CosTask_t* COS_CreateTask(uint8_t prio, void * pData, void (*func) (CosTask_t *)
         return NULL;
     }
 
-    root_g = _addTaskAtBeginningOfTaskList(root_g, t_pt);
-    _sortLinearListPrio(root_g);
+    root_g = _insertTaskSortedByPrio(root_g, t_pt);
+    _releaseJob(t_pt, t_pt->lastActivationTime_Ticks);
+#if COS_TASK_PROFILING
+    t_pt->prof.readyCycles = _getCycles();
+#endif
+    _enqueueTask(t_pt, t_pt->lastActivationTime_Ticks);
+    COS_TRACE_EVENT(COS_TRACE_CREATE, t_pt, prio);
 
     return t_pt;  /* pointer to task struct */
 }
@@ -455,7 +1236,12 @@ CosTask_t* COS_CreateTask(uint8_t prio, void * pData, void (*func) (CosTask_t *)
   @par Beschreibung
        Loescht eine Task aus der Task-Liste und gibt dynamischen
        Speicher frei. Die Task-Liste enthaelt mindestens eine Task:
-       die idle-Task darf nicht geloescht werden.
+       die cpu-load-Task darf nicht geloescht werden. Danach ist task_pt
+       ungueltig, mit COS_USE_STATIC_POOLS 0 darf er keiner Funktion des
+       COS mehr uebergeben werden, siehe _isInTaskList().
+       Mutexe der Task gehen an die naechste wartende Task, wartet sie
+       selbst an einem Mutex, verliert der Besitzer die geerbte
+       Prioritaet, siehe _mutexTaskDeleted().
 
   @see COS_CreateTask()
   @arg
@@ -466,12 +1252,22 @@ CosTask_t* COS_CreateTask(uint8_t prio, void * pData, void (*func) (CosTask_t *)
  ********************************************************************/
 int8_t COS_DeleteTask(CosTask_t* task_pt)
 {
-    /* remove from list, i.e. free the corresponding node,
-       task struct will not be freed here */
+    if(!_isInTaskList(task_pt))
+    {   DebugCode(_msg("Delete:task not found\r\n"););
+        return -1;
+    }
+    COS_TRACE_EVENT(COS_TRACE_DELETE, task_pt, 0);
+    _mutexTaskDeleted(task_pt);   /* may still change its prio in the lists */
+    /* unlink from all lists, no memory is freed here */
     root_g = _unlinkTaskFromTaskList(root_g, task_pt);
+    _dequeueTask(task_pt);
+    _unlinkTaskFromWaitList(task_pt);
+    if(task_pt == running_pt_g)
+    {   running_pt_g = NULL;  /* tell the scheduler: task struct is gone */
+    }
 
     /* free memory of task struct */
-    free(task_pt);
+    _freeTask(task_pt);
     return 0;
 }
 
@@ -495,14 +1291,12 @@ int8_t COS_DeleteTask(CosTask_t* task_pt)
 /*---------------------------------------------------------------*/
 int8_t COS_SuspendTask(CosTask_t* task_pt)
 {
-    Node_t *pt=NULL;
-
-    pt = _searchTaskInList(root_g, task_pt);
-    if(NULL == pt)
+    if(!_isInTaskList(task_pt))
     {   DebugCode(_msg("Suspend:task not found\r\n"););
         return -1;
     }
-    pt->task_pt->state = TASK_STATE_SUSPENDED;
+    task_pt->state = TASK_STATE_SUSPENDED;
+    _dequeueTask(task_pt);
     return 0;
 }
 /*---------------------------------------------------------------*/
@@ -524,14 +1318,11 @@ int8_t COS_SuspendTask(CosTask_t* task_pt)
  ********************************************************************/
 int8_t COS_ResumeTask(CosTask_t* task_pt)
 {
-    Node_t *pt=NULL;
-
-    pt = _searchTaskInList(root_g, task_pt);
-    if(NULL == pt)
+    if(!_isInTaskList(task_pt))
     {   DebugCode(_msg("Resume:task not found\r\n"););
         return -1;
     }
-    pt->task_pt->state = TASK_STATE_READY;
+    _makeTaskReady(task_pt);
     return 0;
 }
 /*---------------------------------------------------------------*/
@@ -539,7 +1330,10 @@ int8_t COS_ResumeTask(CosTask_t* task_pt)
  ********************************************************************
   @par Beschreibung
        Setzt die Prioritaet einer Task auf einen neuen Wert, 1 ist
-       minimal, 254 maximal, 0 und 255 sind reserviert.
+       minimal, 254 maximal, 0 und 255 sind reserviert. Haelt die Task
+       einen Mutex, auf den eine hoeher priorisierte Task wartet, bleibt
+       sie bis zur Freigabe auf deren Prioritaet (Vererbung, siehe
+       COS_MUTEX_LOCK()).
 
   @see
   @arg
@@ -551,18 +1345,298 @@ int8_t COS_ResumeTask(CosTask_t* task_pt)
 ********************************************************************/
 int8_t COS_SetTaskPrio(CosTask_t* task_pt,uint8_t taskPrio)
 {
-    Node_t *pt=NULL;
-
-    pt = _searchTaskInList(root_g, task_pt);
-    if(NULL == pt)
+    if(!_isInTaskList(task_pt))
     {   DebugCode(_msg("SetTaskPrio:task not found\r\n"););
         return -1;
     }
-    pt->task_pt->prio = taskPrio;
-    _sortLinearListPrio(root_g);
+    task_pt->basePrio = taskPrio;
+    _setTaskPrio(task_pt, _mutexInheritedPrio(task_pt));
+    _mutexWaiterPrioChanged(task_pt);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt die wirksame Prioritaet einer Task, ohne basePrio zu
+       aendern, z.B. fuer die Vererbung durch Mutexe. Nur die Task
+       selbst wird in Task-Liste und Ready-Queue umgehaengt.
+
+  @param  task_pt -  IN, Pointer auf Task-Struktur.
+  @param  taskPrio - IN, neue wirksame Prioritaet
+
+@retval keiner
+********************************************************************/
+void _setTaskPrio(CosTask_t* task_pt, uint8_t taskPrio)
+{
+    if(task_pt->prio == taskPrio)
+    {   return;
+    }
+    if(TASK_QUEUE_READY == task_pt->queue)
+    {   _dequeueTask(task_pt);
+        task_pt->prio = taskPrio;
+        _enqueueTask(task_pt, _gettime_Ticks32());
+    }
+    else
+    {   task_pt->prio = taskPrio;
+    }
+    /* keep the task list ordered: move only this task */
+    root_g = _unlinkTaskFromTaskList(root_g, task_pt);
+    root_g = _insertTaskSortedByPrio(root_g, task_pt);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt die relative Deadline einer Task fuer EDF_SCHEDULING. Jeder
+       Lauf der Task ('job') beginnt mit dem Ablauf ihrer Sleep-Zeit bzw.
+       mit ihrer Freigabe durch Semaphor oder COS_ResumeTask(), seine
+       absolute Deadline ist Startzeitpunkt + deadline_Ticks. Der
+       Scheduler laesst die bereite Task mit der naechsten absoluten
+       Deadline laufen. 0 bedeutet: keine Deadline, die Task laeuft nach
+       ihrer Prioritaet, wenn keine Task mit Deadline bereit ist.
+       Ohne EDF_SCHEDULING wird der Wert nur gespeichert.
+
+  @see COS_SetTaskPrio()
+  @arg
+
+  @param  task_pt        - IN, Pointer auf Task-Struktur.
+  @param  deadline_Ticks - IN, relative Deadline in Ticks, < 0x80000000
+
+@retval 0 fuer ok, negativ bei Fehler
+@par Code-Beispiel:
+@verbatim
+    pt = COS_CreateTask(10, NULL, controlLoopTask);
+    COS_SetTaskDeadline(pt, _milliSecToTicks(5));
+@endverbatim
+********************************************************************/
+int8_t COS_SetTaskDeadline(CosTask_t* task_pt, CosTicks_t deadline_Ticks)
+{
+    if(!_isInTaskList(task_pt))
+    {   DebugCode(_msg("SetTaskDeadline:task not found\r\n"););
+        return -1;
+    }
+    if(deadline_Ticks >= 0x80000000UL)
+    {   DebugCode(_msg("SetTaskDeadline:deadline too long\r\n"););
+        return -2;
+    }
+    if(TASK_QUEUE_READY == task_pt->queue)
+    {   /* the key of a queued task must not change */
+        _dequeueTask(task_pt);
+        task_pt->deadline_Ticks = deadline_Ticks;
+        _releaseJob(task_pt, task_pt->lastActivationTime_Ticks);
+        _enqueueTask(task_pt, _gettime_Ticks32());
+    }
+    else
+    {   task_pt->deadline_Ticks = deadline_Ticks;
+    }
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Legt fest, wie COS_TASK_PERIODIC() mit verpassten Startzeitpunkten
+       umgeht. TASK_OVERRUN_SKIP (Voreinstellung): die verpassten Starts
+       entfallen, die Task laeuft wieder im urspruenglichen Raster.
+       TASK_OVERRUN_CATCH_UP: jeder verpasste Start wird ohne Sleep-Zeit
+       nachgeholt, bis die Task das Raster wieder erreicht hat.
+
+  @see COS_GetTaskOverruns()
+  @arg
+
+  @param  task_pt - IN, Pointer auf Task-Struktur.
+  @param  policy  - IN, TASK_OVERRUN_SKIP oder TASK_OVERRUN_CATCH_UP
+
+@retval 0 fuer ok, negativ bei Fehler
+********************************************************************/
+int8_t COS_SetTaskOverrunPolicy(CosTask_t* task_pt, uint8_t policy)
+{
+    if(!_isInTaskList(task_pt))
+    {   DebugCode(_msg("SetTaskOverrunPolicy:task not found\r\n"););
+        return -1;
+    }
+    if((TASK_OVERRUN_SKIP != policy) && (TASK_OVERRUN_CATCH_UP != policy))
+    {   return -2;
+    }
+    task_pt->overrunPolicy = policy;
     return 0;
 }
 /*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die Anzahl der Startzeitpunkte, die eine periodische Task
+       seit ihrer Erzeugung verpasst hat. Der Zaehler bleibt bei 0xFFFF
+       stehen.
+
+  @see COS_TASK_PERIODIC(), COS_SetTaskOverrunPolicy()
+  @arg
+
+  @param  task_pt - IN, Pointer auf Task-Struktur.
+
+@retval Anzahl der Overruns, 0 falls die Task nicht existiert
+********************************************************************/
+uint16_t COS_GetTaskOverruns(CosTask_t* task_pt)
+{
+    if(!_isInTaskList(task_pt))
+    {   return 0;
+    }
+    return task_pt->overruns;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Intern, nur fuer COS_TASK_PERIODIC(). Rechnet den naechsten
+       Soll-Start aus dem letzten Soll-Start plus Periode, nicht aus dem
+       tatsaechlichen Startzeitpunkt lastActivationTime_Ticks. Ist dieser
+       Zeitpunkt schon vorbei, wird je nach overrunPolicy ausgelassen
+       oder nachgeholt und der Overrun-Zaehler erhoeht.
+
+  @see COS_TASK_PERIODIC()
+  @param  task_pt      - IN/OUT, Pointer auf die laufende Task
+  @param  period_Ticks - IN, Periode in Ticks, < 0x80000000
+  @retval Sleep-Zeit relativ zu lastActivationTime_Ticks
+ ********************************************************************/
+CosTicks_t _nextPeriodicRelease(CosTask_t* task_pt, CosTicks_t period_Ticks)
+{
+    CosTicks_t now_Ticks;
+    CosTicks_t late_Ticks;
+    CosTicks_t missed;
+
+    if(0 == period_Ticks)
+    {   return 0;     /* like COS_TASK_SCHEDULE() */
+    }
+    if(0 == task_pt->period_Ticks)
+    {   /* first call: this run is the reference */
+        task_pt->release_Ticks = task_pt->lastActivationTime_Ticks;
+    }
+    task_pt->period_Ticks = period_Ticks;
+    task_pt->release_Ticks += period_Ticks;
+
+    now_Ticks = _gettime_Ticks32();
+    if((int32_t)(now_Ticks - task_pt->release_Ticks) > 0)
+    {   /* the next release is already over */
+        late_Ticks = (CosTicks_t)(now_Ticks - task_pt->release_Ticks);
+        if(TASK_OVERRUN_CATCH_UP == task_pt->overrunPolicy)
+        {   missed = 1;   /* run again at once, the next call counts again */
+        }
+        else
+        {   /* skip all releases that are over, keep the phase */
+            missed = (CosTicks_t)((late_Ticks + period_Ticks - 1) / period_Ticks);
+            task_pt->release_Ticks += (CosTicks_t)(missed * period_Ticks);
+        }
+        if(missed >= (CosTicks_t)(0xFFFFUL - task_pt->overruns))
+        {   task_pt->overruns = 0xFFFF;
+        }
+        else
+        {   task_pt->overruns += (uint16_t) missed;
+        }
+    }
+    if((int32_t)(task_pt->release_Ticks - task_pt->lastActivationTime_Ticks) <= 0)
+    {   return 0;     /* catch up: due now */
+    }
+    return (CosTicks_t)(task_pt->release_Ticks - task_pt->lastActivationTime_Ticks);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt den Task-Zustand auf TASK_STATE_READY und traegt die Task
+       wieder in die Queue des Schedulers ein. Diese Funktion ist fuer
+       die anderen COS Module gedacht (z.B. COS_SEM_SIGNAL()), die eine
+       blockierte Task aufwecken. Die gerade laufende Task wird erst vom
+       Scheduler eingetragen, wenn ihre Task-Funktion zurueckkehrt.
+
+  @see COS_ResumeTask(), COS_SEM_SIGNAL()
+  @arg
+
+  @param  task_pt -     IN, Pointer auf Task-Struktur.
+
+  @retval keine
+ ********************************************************************/
+void _makeTaskReady(CosTask_t* task_pt)
+{
+    task_pt->state = TASK_STATE_READY;
+    COS_TRACE_EVENT(COS_TRACE_READY, task_pt, 0);
+#if COS_TASK_PROFILING
+    task_pt->prof.readyCycles = _getCycles();
+#endif
+    if((task_pt != running_pt_g) && (TASK_QUEUE_NONE == task_pt->queue))
+    {   _releaseJob(task_pt, _gettime_Ticks32());
+        _enqueueTask(task_pt, _gettime_Ticks32());
+    }
+}
+/*---------------------------------------------------------------*/
+#if defined(COS_HOST)
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Nur fuer die Host-Tests: prueft die Queues des Schedulers. In der
+       Ready-Queue steht jede Task in der Liste ihrer Prioritaet und im
+       Bitmap sind genau die Bits der nicht leeren Listen gesetzt, bei
+       EDF_SCHEDULING kennt jede Task ihren Index im Heap und laeuft
+       nicht vor ihrem Vorgaenger. In der Sleep-Queue ergibt sleepRef_g
+       plus die Summe der Deltas bis zu einer Task deren Weckzeit. Ohne
+       READY_QUEUE_SCHEDULING gibt es nichts zu pruefen.
+
+  @param  keine
+  @retval 1 falls die Queues stimmen, sonst 0
+ ********************************************************************/
+uint8_t _checkSchedulerQueues(void)
+{
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+    CosTask_t *t_pt, *prev_pt;
+    CosTicks_t wake_Ticks;
+    uint16_t i;
+
+#if EDF_SCHEDULING
+    for(i = 0; i < edfHeapSize_g; i++)
+    {   t_pt = edfHeap_g[i];
+        if((t_pt->heapIdx != i) || (TASK_QUEUE_READY != t_pt->queue) ||
+           ((i > 0) && _edfBefore(t_pt, edfHeap_g[(i - 1) >> 1])))
+        {   return 0;
+        }
+    }
+#else
+    for(i = 0; i < 256; i++)
+    {   if((0 != (readyMap_g[i >> 5] & (1UL << (i & 31)))) != (NULL != readyHead_g[i]))
+        {   return 0;
+        }
+        prev_pt = NULL;
+        for(t_pt = readyHead_g[i]; NULL != t_pt; t_pt = t_pt->rqNext_pt)
+        {   if((t_pt->prio != i) || (t_pt->rqPrev_pt != prev_pt) ||
+               (TASK_QUEUE_READY != t_pt->queue))
+            {   return 0;
+            }
+            prev_pt = t_pt;
+        }
+        if(readyTail_g[i] != prev_pt)
+        {   return 0;
+        }
+    }
+    for(i = 0; i < 32; i++)
+    {   if((0 != ((i < 8) ? readyMap_g[i] : 0)) != (0 != (readyGroup_g & (1UL << i))))
+        {   return 0;
+        }
+    }
+#endif
+    wake_Ticks = sleepRef_g;
+    prev_pt = NULL;
+    for(t_pt = sleepRoot_g; NULL != t_pt; t_pt = t_pt->rqNext_pt)
+    {   wake_Ticks += t_pt->sleepDelta_Ticks;
+        if((t_pt->rqPrev_pt != prev_pt) || (TASK_QUEUE_SLEEP != t_pt->queue) ||
+           (wake_Ticks != (CosTicks_t)(t_pt->lastActivationTime_Ticks + t_pt->sleepTime_Ticks)))
+        {   return 0;
+        }
+        prev_pt = t_pt;
+    }
+#endif
+    return 1;
+}
+/*---------------------------------------------------------------*/
+#endif
 
 /*---------------------------------------------------------------*/
 /*---------------------------------------------------------------*/
@@ -582,7 +1656,99 @@ int8_t COS_SetTaskPrio(CosTask_t* task_pt,uint8_t taskPrio)
  */
 
 
-#if PRIO_BASED_SCHEDULING
+#if PRIO_BASED_SCHEDULING && READY_QUEUE_SCHEDULING
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Prioritaetsbasierter Scheduler mit Ready-Queue. Der Scheduler
+       entnimmt die Task mit der hoechsten Prioritaet aus der
+       Ready-Queue, Tasks gleicher Prioritaet kommen der Reihe nach dran.
+       Nur wenn sich die Systemzeit geaendert hat, werden schlafende
+       Tasks mit abgelaufener Sleep-Zeit in die Ready-Queue verschoben.
+       Nach dem Lauf wird die Task je nach Zustand und Sleep-Zeit wieder
+       in die Ready-Queue oder die Sleep-Liste eingetragen, blockierte
+       und suspendierte Tasks werden nicht eingetragen.
+       Der Scheduler laeuft in einer Endlosschleife.
+
+  @see _makeTaskReady()
+  @arg
+
+  @param  keine
+
+  @retval 0 fuer ok, negativ bei Fehler (sollte nie zurueck kommen,
+          Endlosschleife)
+  @par Code-Beispiel:
+
+  @verbatim
+int main(void)
+{   ...
+    if(0!=COS_InitTaskList())
+    {   serPuts("COS_InitScheduler has crashed...");
+    }
+    COS_PrintTaskList();
+    ...
+    if(0!=COS_RunScheduler())
+    {   serPuts("COS_RunScheduler has crashed...");
+    }
+    getchar();
+    return 0;
+}
+  @endverbatim
+ ********************************************************************/
+int8_t COS_RunScheduler(void)
+{
+    CosTask_t *t_pt=NULL;
+    CosTicks_t t_Ticks;
+    CosTicks_t lastTicks;
+#if TICKLESS_IDLE
+    CosTicks_t idle_Ticks;
+#if COS_PREEMPT
+    CosTicks_t p_Ticks;
+#endif
+#endif
+
+    //DebugCode(_msg("RunScheduler,ready queue\r\n"););
+
+    lastTicks = _gettime_Ticks32();
+    while(1) /* loop forever */
+    {
+#if COS_DEFER
+        _deferDrain();         /* work left by ISRs */
+#endif
+#if COS_HRTIMER
+        _hrTimerWakeTasks();   /* tasks of expired HR timers */
+#endif
+        t_Ticks = _gettime_Ticks32();
+        if(t_Ticks != lastTicks)  /* new tick: wake up sleeping tasks */
+        {   _wakeSleepingTasks(t_Ticks);
+            lastTicks = t_Ticks;
+        }
+        t_pt = _rqPopHighest();
+        if(NULL == t_pt)
+        {
+#if TICKLESS_IDLE
+            /* sleep until the first task in the sleep queue wakes up,
+               a long sleep takes several scheduler passes */
+            idle_Ticks = _ticksUntilNextWakeup(t_Ticks);
+#if COS_PREEMPT
+            p_Ticks = _preemptTicksUntilWake(t_Ticks);   /* sleeping P-tasks */
+            if(p_Ticks < idle_Ticks)
+            {   idle_Ticks = p_Ticks;
+            }
+#endif
+            (void) _idleWaitTicks((idle_Ticks > 0xFFFFUL) ? 0xFFFF : (uint16_t) idle_Ticks);
+#endif
+            continue;  /* nothing to do */
+        }
+        _runTask(t_pt, t_Ticks);
+        /* the task function may have deleted its own task struct */
+        if(NULL != running_pt_g)
+        {   running_pt_g = NULL;
+            _enqueueTask(t_pt, t_Ticks);
+        }
+    }return 0;
+}
+#elif PRIO_BASED_SCHEDULING
 /*!
  ********************************************************************
   @par Beschreibung
@@ -621,26 +1787,34 @@ int8_t COS_RunScheduler(void)
 {
 
 
-    Node_t *pt=NULL;
-    uint16_t t_Ticks;
+    CosTask_t *pt=NULL;
+    CosTicks_t t_Ticks;
 
     //DebugCode(_msg("RunScheduler,prio based\r\n"););
 
     pt = root_g; /* first task, highest prio */
     while(1) /* loop forever */
-    {   /* time to run? */
-        t_Ticks = _gettime_Ticks();
+    {
+#if COS_DEFER
+        _deferDrain();         /* work left by ISRs */
+#endif
+#if COS_HRTIMER
+        _hrTimerWakeTasks();   /* tasks of expired HR timers */
+#endif
+        /* time to run? */
+        t_Ticks = _gettime_Ticks32();
         /* time wrap around is ok, time difference will be right... */
-        if(((uint16_t)(t_Ticks - pt->task_pt->lastActivationTime_Ticks) >=
-             pt->task_pt->sleepTime_Ticks)&&
-            (pt->task_pt->state == TASK_STATE_READY))
-        {  pt->task_pt->lastActivationTime_Ticks = t_Ticks;
-           /*  when the task function runs to its very end, the task will be deleted:
-               it will be removed from the list, and the task struct will be freed,
-               i.e. pt->task_pt is no longer valid.
-           */
-           pt->task_pt->sleepTime_Ticks = 0;  // Bugfix 22.10.2015: must be specified by task!
-           pt->task_pt->func(pt->task_pt);  /* call task function, must not block! */
+        if(((CosTicks_t)(t_Ticks - pt->lastActivationTime_Ticks) >=
+             pt->sleepTime_Ticks)&&
+            (pt->state == TASK_STATE_READY))
+        {  _runTask(pt, t_Ticks);  /* pt may be deleted afterwards */
+#if FAIR_EQUAL_PRIO_SCHEDULING
+           if(NULL != running_pt_g)  /* task still exists? */
+           {   /* next time, the other tasks of this prio come first */
+               root_g = _moveTaskBehindEqualPrio(root_g, pt);
+           }
+#endif
+           running_pt_g = NULL;
            pt = root_g; /* next: check task with highest prio */
         }
         else
@@ -688,25 +1862,31 @@ int main(void)
   @endverbatim
  ********************************************************************/
 int8_t COS_RunScheduler(void)
-{   Node_t *pt=NULL;
-    uint16_t t_Ticks;
+{   CosTask_t *pt=NULL;
+    CosTicks_t t_Ticks;
 
     //DebugCode(_msg("RunScheduler, round robin\r\n"););
 
     pt = root_g; /* first task */
     while(1) /* run forever */
-    {   /* time to run? */
-        t_Ticks = _gettime_Ticks();
-        if(((uint16_t)(t_Ticks - pt->task_pt->lastActivationTime_Ticks) >=
-             pt->task_pt->sleepTime_Ticks)&&
-            (pt->task_pt->state == TASK_STATE_READY))
-        {  pt->task_pt->lastActivationTime_Ticks = t_Ticks;
-           /*  when the task function runs to its very end, the task will be deleted:
-               it will be removed from the list, and the task struct will be freed,
-               i.e. pt->task_pt is no longer valid.
-           */
-           pt->task_pt->sleepTime_Ticks = 0;  // Bugfix 22.10.2015: must be specified by task!
-           pt->task_pt->func(pt->task_pt);  /* call task function, must not block! */
+    {
+#if COS_DEFER
+        _deferDrain();         /* work left by ISRs */
+#endif
+#if COS_HRTIMER
+        _hrTimerWakeTasks();   /* tasks of expired HR timers */
+#endif
+        /* time to run? */
+        t_Ticks = _gettime_Ticks32();
+        if(((CosTicks_t)(t_Ticks - pt->lastActivationTime_Ticks) >=
+             pt->sleepTime_Ticks)&&
+            (pt->state == TASK_STATE_READY))
+        {  _runTask(pt, t_Ticks);  /* pt may be deleted afterwards */
+           if(NULL == running_pt_g)
+           {   pt = root_g;  /* task has deleted itself, start again */
+               continue;
+           }
+           running_pt_g = NULL;
         }
         pt = pt->next_pt;  /* next task in list */
         if(NULL==pt)
@@ -723,8 +1903,13 @@ int8_t COS_RunScheduler(void)
  ********************************************************************
   @par Beschreibung
        Diese Funktion wird fuer Testzwecke benutzt.
-       Sie gibt die aktuelle Task-Liste am Terminal aus.
-  @see
+       Sie gibt die aktuelle Task-Liste am Terminal aus, eine Zeile pro
+       Task mit durch ';' getrennten Spalten, damit sich die Ausgabe
+       z.B. mit 'sort -t';' -k6 -n' nach einer Spalte sortieren laesst.
+       Mit COS_TASK_PROFILING folgen die Laufzeit-Statistiken: Anzahl
+       der Aufrufe, Summe der Laufzeiten in ms, kuerzeste, laengste
+       und mittlere Laufzeit sowie die laengste Start-Latenz in us.
+  @see COS_GetTaskProfile()
   @arg
 
   @param  nichts
@@ -732,12 +1917,28 @@ int8_t COS_RunScheduler(void)
  ********************************************************************/
 void COS_PrintTaskList(void)
 {
-    Node_t *pt=root_g;
+    CosTask_t *pt=root_g;
+#if COS_TASK_PROFILING
+    uint32_t avg;
 
+    serPuts("\r\ntask;state;prio;runs;total_ms;min_us;max_us;avg_us;maxlat_us");
+#else
+    serPuts("\r\ntask;state;prio");
+#endif
     while(NULL != pt)
-    {   serPuts("\r\ntask:");  serOutUint32Hex((uint32_t) pt->task_pt);
-        serPuts("\r\nState:"); serOutUint8Hex(pt->task_pt->state);
-        serPuts("\r\nPrio:");  serOutUint8Hex(pt->task_pt->prio);
+    {   serPuts("\r\n");  serOutUint32Hex((uint32_t)(unsigned long) pt);
+        serPutc(';');     serOutUint8Hex(pt->state);
+        serPutc(';');     serOutUint16Dec(pt->prio);
+#if COS_TASK_PROFILING
+        avg = (pt->prof.runs) ? (uint32_t)(pt->prof.totalCycles / pt->prof.runs) : 0;
+        serPutc(';'); serOutUint32Dec(pt->prof.runs);
+        serPutc(';'); serOutUint32Dec((uint32_t)((pt->prof.totalCycles /
+                          _cyclesPerMilliSec()) & 0xFFFFFFFFUL));
+        serPutc(';'); serOutUint32Dec(pt->prof.runs ? _cyclesToMicroSec(pt->prof.minCycles) : 0);
+        serPutc(';'); serOutUint32Dec(_cyclesToMicroSec(pt->prof.maxCycles));
+        serPutc(';'); serOutUint32Dec(_cyclesToMicroSec(avg));
+        serPutc(';'); serOutUint32Dec(_cyclesToMicroSec(pt->prof.maxLatencyCycles));
+#endif
         pt = pt->next_pt;
     }
 }
@@ -745,13 +1946,60 @@ void COS_PrintTaskList(void)
 /*!
  ********************************************************************
   @par Beschreibung
-       Eine einfache Lastmessung benutzt zwei Tasks, die automatisch
-       in der Funktion COS_InitTaskList() erzeugt werden. Die Task
-       _cpuLoadMeasureTask() hat maximale Prioritaet und setzt einen
-       Zaehler auf 100, der durch die idle-Task dekrementiert wird.
-       Der Zaehlerstand kann als Mass fuer die CPU-Auslastung dienen.
+       Kopiert die Laufzeit-Statistik einer Task, siehe
+       CosTaskProfile_t. Ohne COS_TASK_PROFILING bleibt sie leer.
 
-  @see
+  @see COS_ResetTaskProfiles(), COS_PrintTaskList()
+  @arg
+
+  @param  task_pt - IN, Pointer auf Task-Struktur
+  @param  prof    - OUT, Zeiger auf die Statistik-Struktur
+  @retval 0 fuer ok, negativ bei Fehler
+ ********************************************************************/
+int8_t COS_GetTaskProfile(CosTask_t* task_pt, CosTaskProfile_t *prof)
+{
+    if(!_isInTaskList(task_pt))
+    {   DebugCode(_msg("GetTaskProfile:task not found\r\n"););
+        return -1;
+    }
+    *prof = task_pt->prof;
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt die Laufzeit-Statistik aller Tasks zurueck, z.B. um nur
+       ein bestimmtes Zeitfenster zu messen.
+
+  @see COS_GetTaskProfile()
+  @arg
+
+  @param  nichts
+  @retval nichts
+ ********************************************************************/
+void COS_ResetTaskProfiles(void)
+{
+    CosTask_t *pt=root_g;
+
+    while(NULL != pt)
+    {   pt->prof.runs             = 0;
+        pt->prof.totalCycles      = 0;
+        pt->prof.minCycles        = 0xFFFFFFFFUL;
+        pt->prof.maxCycles        = 0;
+        pt->prof.maxLatencyCycles = 0;
+        pt = pt->next_pt;
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die CPU-Last des mittleren Fensters (1 s) in Prozent,
+       gerundet. Die Funktion bleibt aus Kompatibilitaetsgruenden,
+       genauere Werte liefert COS_GetCPULoadPermille().
+
+  @see COS_GetCPULoadPermille()
   @arg
 
   @param  keine
@@ -759,7 +2007,49 @@ void COS_PrintTaskList(void)
   @retval cpu Load in Prozent
  ********************************************************************/
 int8_t COS_GetCPULoadInPercent(void)
-{   return cpuLoadPerCent_g;
+{   return (int8_t)((cpuLoad_g[COS_LOAD_MID] + 5) / 10);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die gemessene CPU-Last in Promille. Die Werte der Fenster
+       werden am Ende jedes Fensters aktualisiert, vorher sind sie 0.
+
+  @see COS_ResetCPULoadPeak(), _cpuLoadMeasureTask()
+  @arg
+
+  @param  window - IN, COS_LOAD_SHORT (100 ms), COS_LOAD_MID (1 s),
+                   COS_LOAD_LONG (10 s), COS_LOAD_EMA (gleitendes
+                   Mittel) oder COS_LOAD_PEAK (Spitzenwert)
+
+  @retval Last in Promille, 0..1000
+ ********************************************************************/
+uint16_t COS_GetCPULoadPermille(uint8_t window)
+{
+    switch(window)
+    {   case COS_LOAD_SHORT:
+        case COS_LOAD_MID:
+        case COS_LOAD_LONG:  return cpuLoad_g[window];
+        case COS_LOAD_EMA:   return (uint16_t)(cpuLoadEma_g >> CPU_LOAD_EMA_SHIFT);
+        case COS_LOAD_PEAK:  return cpuLoadPeak_g;
+        default:             return 0;
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt den Spitzenwert der CPU-Last (COS_LOAD_PEAK) zurueck.
+
+  @see COS_GetCPULoadPermille()
+  @arg
+
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void COS_ResetCPULoadPeak(void)
+{   cpuLoadPeak_g = 0;
 }
 /*---------------------------------------------------------------*/
 /*---------------------------------------------------------------*/
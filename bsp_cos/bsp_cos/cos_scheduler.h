@@ -63,11 +63,33 @@ int8_t COS_DeleteTask(CosTask_t* task_pt);
 int8_t COS_SuspendTask(CosTask_t* task_pt);
 int8_t COS_ResumeTask(CosTask_t* task_pt);
 int8_t COS_SetTaskPrio(CosTask_t* task_pt,uint8_t taskPrio);
+int8_t COS_SetTaskDeadline(CosTask_t* task_pt, CosTicks_t deadline_Ticks);
+int8_t COS_SetTaskOverrunPolicy(CosTask_t* task_pt, uint8_t policy);
+uint16_t COS_GetTaskOverruns(CosTask_t* task_pt);
 int8_t COS_RunScheduler(void);
 
 
 void COS_PrintTaskList(void);
+int8_t COS_GetTaskProfile(CosTask_t* task_pt, CosTaskProfile_t *prof);
+void COS_ResetTaskProfiles(void);
 int8_t COS_GetCPULoadInPercent(void);
+uint16_t COS_GetCPULoadPermille(uint8_t window);
+void COS_ResetCPULoadPeak(void);
+
+/* Messfenster fuer COS_GetCPULoadPermille() */
+#define COS_LOAD_SHORT   0   /*!< letzte 100 ms */
+#define COS_LOAD_MID     1   /*!< letzte Sekunde */
+#define COS_LOAD_LONG    2   /*!< letzte 10 Sekunden */
+#define COS_LOAD_EMA     3   /*!< gleitendes Mittel der 100 ms Werte */
+#define COS_LOAD_PEAK    4   /*!< hoechster 100 ms Wert seit COS_ResetCPULoadPeak() */
+
+/* intern, fuer andere COS Module (Semaphoren) */
+void _makeTaskReady(CosTask_t* task_pt);
+void _setTaskPrio(CosTask_t* task_pt, uint8_t taskPrio);
+CosTicks_t _nextPeriodicRelease(CosTask_t* task_pt, CosTicks_t period_Ticks);
+#if defined(COS_HOST)
+uint8_t _checkSchedulerQueues(void);   /* nur fuer die Host-Tests */
+#endif
 
 
 /*-------------- macros for task start, end, scheduling ------------*/
@@ -138,7 +160,9 @@ void my_cos_task_func(CosTask_t* task_pt)
   @par Beschreibung
   Dieses Macro ist ein kooperativer Scheduling-Punkt der Task-Funktion.
   Die Task wird fuer eine gewisse Zeit blockieren, der Scheduler wird
-  aufgerufen und startet eine andere Task-Funktion.
+  aufgerufen und startet eine andere Task-Funktion. Die Zeit ist ein
+  CosTicks_t, moeglich sind bis zu 2^31 - 1 Ticks (ueber 24 Tage bei
+  1 ms pro Tick).
 
 @parameter pt - IN, Zeiger auf Task-Stuktur
 
@@ -167,6 +191,46 @@ void my_cos_task_func(CosTask_t* task_pt)
 
 
 
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro ist ein kooperativer Scheduling-Punkt fuer periodische
+  Tasks. Anders als bei COS_TASK_SLEEP() wird der naechste Start nicht
+  vom tatsaechlichen Startzeitpunkt aus gerechnet, sondern vom letzten
+  Soll-Startzeitpunkt: Startverzoegerungen durch andere Tasks fuehren
+  nicht zu einer Drift der Phase. Beim ersten Aufruf ist der aktuelle
+  Start der Bezugspunkt. Ist der naechste Soll-Start bereits vorbei,
+  so wird ein Overrun gezaehlt, siehe COS_SetTaskOverrunPolicy() und
+  COS_GetTaskOverruns(). Die Periode muss kleiner als 2^31 Ticks sein.
+
+@parameter pt - IN, Zeiger auf Task-Stuktur
+@parameter period_Ticks - IN, Periode in Ticks
+
+@returns  nichts
+
+@par Code-Beispiel::
+@verbatim
+void my_control_task(CosTask_t* task_pt)
+{
+    COS_TASK_BEGIN(task_pt);
+
+    while(1)
+    {   ...
+        COS_TASK_PERIODIC(task_pt,_milliSecToTicks(10));
+    }
+    COS_TASK_END(task_pt);
+}
+@endverbatim
+********************************************************************/
+#define COS_TASK_PERIODIC(pt,period_Ticks) \
+                          (pt)->sleepTime_Ticks=_nextPeriodicRelease((pt),(period_Ticks));\
+                          (pt)->lineCnt=__LINE__;\
+                          return;\
+                          case __LINE__:
+
+
+
+
 
 
 
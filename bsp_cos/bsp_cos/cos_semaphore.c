@@ -30,9 +30,9 @@ Der Zustand der Task wird dann auf TASK_STATE_BLOCKED gesetzt, der
 Scheduler wird diese Task nicht mehr starten. Die Task wird in die
 Liste der an diesem Sema wartenden Tasks eingetragen.
 
-Eventuell sollte man die Liste nach Task-Prio sortieren.
-Zunaechst wird das Problem von
-Prioritaetsinversionen hier komplett ignoriert.
+Die Liste wird in der Reihenfolge des Wartens (COS_SEM_FIFO) oder
+nach Task-Prio (COS_SEM_PRIO) gefuehrt. Prioritaetsinversionen
+vermeidet erst CosMutex_t.
 
 
 Erst wenn eine andere Task mit COS_SEM_SIGNAL()
@@ -42,18 +42,14 @@ und aus der Liste der wartenden Tasks entfernt.
 
   @verbatim
 
-                          node
+                          task
            root_pt       --------      --------           --------
            -----         |      |----->|      |-- ... --->|      |----> NULL
            |   |-------->|......|      |......|           |......|
            -----         |      |      |      |           |      |
                          --------      --------           --------
-                            |             |                  |
-                            \/            \/                 \/
-                          -----         -----              -----
-                          |   |         |   |              |   |
-                          -----         -----              -----
-                          task
+           Die Verkettung (waitNext_pt) steht direkt in der Task-Struktur,
+           es wird kein Speicher fuer Listenknoten benoetigt.
 
   @endverbatim
 
@@ -94,7 +90,8 @@ und aus der Liste der wartenden Tasks entfernt.
 @arg
 
 @param s       - IN/OUT, Zeiger auf Semaphore
-@param n_start - IN, Zaehlerstand des Semaphore nach Initialisierung
+@param n_start - IN, Zaehlerstand des Semaphore nach Initialisierung,
+                  hoechstens COS_SEM_COUNT_MAX
 
 @retval 0 fuer ok, negativ bei Fehler.
 
@@ -127,9 +124,46 @@ int main(void)
 }
 @endverbatim
 ********************************************************************/
-uint8_t COS_SemCreate(CosSema_t *s, int8_t n_start)
+uint8_t COS_SemCreate(CosSema_t *s, CosSemCount_t n_start)
 {
+    return COS_SemCreateOrdered(s, n_start, COS_SEM_FIFO);
+}
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Wie COS_SemCreate(), legt zusaetzlich die Reihenfolge fest, in der
+  wartende Tasks bedient werden. COS_SEM_FIFO bedient die am
+  laengsten wartende Task zuerst, COS_SEM_PRIO die mit der hoechsten
+  Prioritaet beim Eintrag in die Warteliste.
+
+@see COS_SemCreate()
+@arg
+
+@param s       - IN/OUT, Zeiger auf Semaphore
+@param n_start - IN, Zaehlerstand des Semaphore nach Initialisierung,
+                  hoechstens COS_SEM_COUNT_MAX
+@param order   - IN, COS_SEM_FIFO oder COS_SEM_PRIO
+
+@retval 0 fuer ok, 1 bei unbekannter Reihenfolge
+
+@par Code-Beispiel:
+@verbatim
+CosSema_t spiSema;
+...
+    COS_SemCreateOrdered(&spiSema, 1, COS_SEM_PRIO);
+@endverbatim
+********************************************************************/
+uint8_t COS_SemCreateOrdered(CosSema_t *s, CosSemCount_t n_start, uint8_t order)
+{
+    if((COS_SEM_FIFO != order) && (COS_SEM_PRIO != order))
+    {   return 1;
+    }
     s->count = n_start;
+    s->order = order;
     s->root_pt = NULL;
     return 0;
 }
@@ -177,13 +211,9 @@ int main(void)
 ********************************************************************/
 uint8_t COS_SemDestroy(CosSema_t *s)
 {
-    /* free memory of all list elements, but don't destroy the tasks! */
-    Node_t *pt = s->root_pt;
-
+    /* unlink all waiting tasks, but don't destroy the tasks! */
     while(s->root_pt != NULL)
-    {   pt = s->root_pt;                    // node to be freed
-        s->root_pt = s->root_pt->next_pt;  // next node in list
-        free(pt);
+    {   _unlinkTaskFromWaitList(s->root_pt);
     }
     return 0;
 }
@@ -197,13 +227,15 @@ uint8_t COS_SemDestroy(CosSema_t *s)
   Inkrementiert den Zaehler des Semaphor. Die Liste der wartenden Tasks wird
   untersucht und die erste Task in der Liste wird in den Zustand
   TASK_STATE_READY gesetzt und aus der Liste der wartenden Tasks geloescht.
+  Steht der Zaehler schon auf COS_SEM_COUNT_MAX, bleibt er dort und das
+  Ereignis geht verloren.
 
 @see
 @arg
 
 @param s       - IN/OUT, Zeiger auf Semaphore
 
-@retval none
+@retval 0 fuer ok, -1 falls der Zaehler voll ist
 
 @par Code-Beispiel::
 @verbatim
@@ -228,15 +260,365 @@ void myTask2(CosTask_t *pt)
 }
 @endverbatim
 ********************************************************************/
-void COS_SEM_SIGNAL(CosSema_t *s)
+int8_t COS_SEM_SIGNAL(CosSema_t *s)
 {
   CosTask_t *task_pt=NULL;  /*!<  pointer to task structure */
 
+  if(s->count >= COS_SEM_COUNT_MAX)  // no task can be waiting
+  { return -1;
+  }
   (s->count)++;
+  COS_TRACE_EVENT(COS_TRACE_SIGNAL, s, s->count);
   if(s->root_pt != NULL)  // any task waiting on this sema?
-  { task_pt = s->root_pt->task_pt;  // first waiting task
-    task_pt->state = TASK_STATE_READY;  // make it ready to run
-    s->root_pt = _unlinkTaskFromTaskList(s->root_pt, task_pt); // remove it from sema-list
+  { task_pt = s->root_pt;  // first waiting task
+    _unlinkTaskFromWaitList(task_pt); // remove it from sema-list
+    _makeTaskReady(task_pt);  // make it ready to run
   }
+  return 0;
+}
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Wie n mal COS_SEM_SIGNAL(), aber mit einer Aenderung des Zaehlers:
+  der Zaehler steigt um n, bis zu n wartende Tasks werden bereit.
+  Ueber COS_SEM_COUNT_MAX steigt er nicht, was darueber hinausgeht,
+  geht verloren. Die wartenden Tasks werden trotzdem bereit, ihre
+  Ereignisse sind im Zaehler schon abgezogen.
+
+@see COS_SEM_SIGNAL()
+@param s - IN/OUT, Zeiger auf Semaphore
+@param n - IN, Anzahl Ereignisse, 0 aendert nichts
+@retval 0 fuer ok, -1 falls der Zaehler begrenzt wurde
+********************************************************************/
+int8_t COS_SemSignalMany(CosSema_t *s, CosSemCount_t n)
+{
+    CosTask_t *task_pt;
+    int8_t ret = 0;
+
+    if(n <= 0)
+    {   return 0;
+    }
+    if(s->count > COS_SEM_COUNT_MAX - n)  /* no overflow: 0 <= MAX - n < MAX */
+    {   s->count = COS_SEM_COUNT_MAX;
+        ret = -1;
+    }
+    else
+    {   s->count += n;
+    }
+    COS_TRACE_EVENT(COS_TRACE_SIGNAL, s, s->count);
+    while((n > 0) && (NULL != s->root_pt))
+    {   task_pt = s->root_pt;
+        _unlinkTaskFromWaitList(task_pt);
+        _makeTaskReady(task_pt);
+        n--;
+    }
+    return ret;
+}
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Nimmt ein Ereignis aus dem Semaphor, ohne zu blockieren. Auch aus
+  Funktionen, die keine Task sind, aufrufbar.
+
+@see COS_SEM_WAIT()
+@param s - IN/OUT, Zeiger auf Semaphore
+@retval 0 fuer ok, -1 falls der Zaehler nicht positiv ist
+********************************************************************/
+int8_t COS_SemTryWait(CosSema_t *s)
+{
+    if(s->count <= 0)
+    {   return -1;
+    }
+    s->count--;
+    return 0;
+}
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Der blockierende Teil von COS_SEM_WAIT() fuer Funktionen, die selbst
+  entscheiden, ob sie warten: nimmt ein Ereignis vorweg, blockiert pt
+  und traegt sie in die Warteliste ein. Die Task muss danach zum
+  Scheduler zurueckkehren, geweckt gehoert ihr das Ereignis.
+
+@param s  - IN/OUT, Zeiger auf Semaphore
+@param pt - IN, Zeiger auf die wartende Task
+@retval keiner
+********************************************************************/
+void _semBlock(CosSema_t *s, CosTask_t *pt)
+{
+    pt->state = TASK_STATE_BLOCKED;
+    COS_TRACE_EVENT(COS_TRACE_BLOCK, s, 0);
+    _semEnqueue(s, pt);
+    s->count--;
+}
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Traegt die Task pt in die Warteliste des Semaphors ein, hinten bzw.
+  nach ihrer Prioritaet. Wird von COS_SEM_WAIT() aufgerufen.
+
+@param s  - IN/OUT, Zeiger auf Semaphore
+@param pt - IN, Zeiger auf die wartende Task
+@retval keiner
+********************************************************************/
+void _semEnqueue(CosSema_t *s, CosTask_t *pt)
+{
+    if(COS_SEM_PRIO == s->order)
+    {   _insertTaskToWaitListByPrio(&s->root_pt, pt);
+    }
+    else
+    {   _addTaskToWaitList(&s->root_pt, pt);
+    }
+}
 
+
+
+
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Vererbt prio entlang der Kette Besitzer -> Mutex, auf den er wartet
+  -> dessen Besitzer ... Eine wartende Task wird in ihrer Warteliste
+  neu einsortiert, sobald sich ihre Prioritaet aendert.
+********************************************************************/
+static void _mutexBoost(CosTask_t *owner_pt, uint8_t prio)
+{
+    CosMutex_t *m;
+
+    while((NULL != owner_pt) && (owner_pt->prio < prio))
+    {   _setTaskPrio(owner_pt, prio);
+        m = owner_pt->mutexWait_pt;
+        if(NULL == m)
+        {   break;
+        }
+        _unlinkTaskFromWaitList(owner_pt);
+        _insertTaskToWaitListByPrio(&m->root_pt, owner_pt);
+        owner_pt = m->owner_pt;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _mutexTake(CosMutex_t *m, CosTask_t *pt, uint8_t nest)
+{
+    m->owner_pt = pt;
+    m->nest = nest;
+    m->nextHeld_pt = pt->mutexHeld_pt;
+    pt->mutexHeld_pt = m;
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Initialisiert einen freien Mutex ohne wartende Tasks.
+
+@param m - OUT, Zeiger auf CosMutex_t
+@retval keiner
+********************************************************************/
+void COS_MutexInit(CosMutex_t *m)
+{
+    m->owner_pt = NULL;
+    m->root_pt = NULL;
+    m->nextHeld_pt = NULL;
+    m->nest = 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Gibt einen Mutex frei, der der Task pt gehoert. Bei geschachteltem
+  Sperren wird nur die Tiefe verringert. Sonst geht der Mutex direkt an
+  die wartende Task mit der hoechsten Prioritaet, die dadurch bereit
+  wird, und pt faellt auf die Prioritaet zurueck, die ihr nach den
+  noch gehaltenen Mutexen zusteht.
+
+@see COS_MUTEX_LOCK()
+@param m  - IN/OUT, Zeiger auf CosMutex_t
+@param pt - IN, Zeiger auf die Besitzer-Task
+@retval 0 fuer ok, -1 falls pt nicht der Besitzer ist
+********************************************************************/
+int8_t COS_MutexUnlock(CosMutex_t *m, CosTask_t *pt)
+{
+    CosMutex_t **held_pp;
+    CosTask_t *next_pt;
+
+    if(m->owner_pt != pt)
+    {   return -1;
+    }
+    if(m->nest > 1)
+    {   m->nest--;
+        return 0;
+    }
+    /* unlink m from the owner's list of held mutexes (usually the head) */
+    held_pp = &pt->mutexHeld_pt;
+    while(*held_pp != m)
+    {   held_pp = &(*held_pp)->nextHeld_pt;
+    }
+    *held_pp = m->nextHeld_pt;
+    m->nextHeld_pt = NULL;
+    COS_TRACE_EVENT(COS_TRACE_SIGNAL, m, 0);
+
+    next_pt = m->root_pt;
+    if(NULL == next_pt)
+    {   m->owner_pt = NULL;
+        m->nest = 0;
+    }
+    else
+    {   /* hand over: the new owner confirms with nest 1 in COS_MUTEX_LOCK() */
+        _unlinkTaskFromWaitList(next_pt);
+        next_pt->mutexWait_pt = NULL;
+        _mutexTake(m, next_pt, 0);
+        if(NULL != m->root_pt)
+        {   _mutexBoost(next_pt, m->root_pt->prio);
+        }
+        _makeTaskReady(next_pt);
+    }
+    _setTaskPrio(pt, _mutexInheritedPrio(pt));
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Liefert den Besitzer eines Mutex, NULL falls er frei ist.
+
+@param m - IN, Zeiger auf CosMutex_t
+@retval Zeiger auf Task-Struktur oder NULL
+********************************************************************/
+CosTask_t *COS_MutexGetOwner(CosMutex_t *m)
+{
+    return m->owner_pt;
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Kern von COS_MUTEX_LOCK(). Sperrt den Mutex fuer pt oder traegt pt
+  als wartende Task ein, blockiert sie und vererbt ihre Prioritaet an
+  den Besitzer.
+
+@param m  - IN/OUT, Zeiger auf CosMutex_t
+@param pt - IN, Zeiger auf die laufende Task
+@retval 1 falls pt den Mutex jetzt haelt, 0 falls pt warten muss
+********************************************************************/
+uint8_t _mutexLock(CosMutex_t *m, CosTask_t *pt)
+{
+    if(NULL == m->owner_pt)
+    {   _mutexTake(m, pt, 1);
+        return 1;
+    }
+    if(m->owner_pt == pt)
+    {   /* nested lock, or the first run after the hand over */
+        if(m->nest < 0xFF)
+        {   m->nest++;
+        }
+        return 1;
+    }
+    pt->state = TASK_STATE_BLOCKED;
+    COS_TRACE_EVENT(COS_TRACE_BLOCK, m, 0);
+    if(pt->mutexWait_pt != m)
+    {   _insertTaskToWaitListByPrio(&m->root_pt, pt);
+        pt->mutexWait_pt = m;
+    }
+    _mutexBoost(m->owner_pt, pt->prio);
+    return 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Liefert die Prioritaet, die einer Task zusteht: ihre basePrio oder
+  die hoechste Prioritaet der Tasks, die auf einen ihrer Mutexe warten.
+********************************************************************/
+uint8_t _mutexInheritedPrio(CosTask_t *task_pt)
+{
+    uint8_t prio = task_pt->basePrio;
+    CosMutex_t *m;
+
+    for(m = task_pt->mutexHeld_pt; NULL != m; m = m->nextHeld_pt)
+    {   if((NULL != m->root_pt) && (m->root_pt->prio > prio))
+        {   prio = m->root_pt->prio;
+        }
+    }
+    return prio;
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Wird von COS_SetTaskPrio() aufgerufen: wartet die Task an einem
+  Mutex, wird sie dort neu einsortiert und ihre Prioritaet ggf. an den
+  Besitzer vererbt. Eine gesunkene Prioritaet nimmt die Vererbung erst
+  mit der naechsten Freigabe zurueck.
+********************************************************************/
+void _mutexWaiterPrioChanged(CosTask_t *task_pt)
+{
+    CosMutex_t *m = task_pt->mutexWait_pt;
+
+    if(NULL == m)
+    {   return;
+    }
+    _unlinkTaskFromWaitList(task_pt);
+    _insertTaskToWaitListByPrio(&m->root_pt, task_pt);
+    _mutexBoost(m->owner_pt, task_pt->prio);
+}
+/*---------------------------------------------------------------*/
+/*!
+********************************************************************
+  @par Beschreibung
+  Wird von COS_DeleteTask() aufgerufen, solange die Task noch in der
+  Task-Liste steht. Wartet sie an einem Mutex, wird sie dort
+  ausgetragen, und der Besitzer faellt, entlang der Kette, auf die
+  Prioritaet zurueck, die ihm ohne sie zusteht. Haelt sie selbst
+  Mutexe, werden sie wie mit COS_MutexUnlock() an die naechste
+  wartende Task uebergeben, auch wenn sie geschachtelt gesperrt sind.
+********************************************************************/
+void _mutexTaskDeleted(CosTask_t *task_pt)
+{
+    CosMutex_t *m = task_pt->mutexWait_pt;
+    CosTask_t *owner_pt;
+    uint8_t prio;
+
+    if(NULL != m)
+    {   _unlinkTaskFromWaitList(task_pt);
+        task_pt->mutexWait_pt = NULL;
+        /* take back what it passed on, up to the first owner that keeps its prio */
+        while(NULL != m)
+        {   owner_pt = m->owner_pt;
+            prio = _mutexInheritedPrio(owner_pt);
+            if(prio == owner_pt->prio)
+            {   break;
+            }
+            _setTaskPrio(owner_pt, prio);
+            m = owner_pt->mutexWait_pt;
+            if(NULL != m)
+            {   _unlinkTaskFromWaitList(owner_pt);
+                _insertTaskToWaitListByPrio(&m->root_pt, owner_pt);
+            }
+        }
+    }
+    while(NULL != task_pt->mutexHeld_pt)
+    {   task_pt->mutexHeld_pt->nest = 1;
+        (void) COS_MutexUnlock(task_pt->mutexHeld_pt, task_pt);
+    }
 }
+/*---------------------------------------------------------------*/
@@ -41,6 +41,36 @@
                 leer ist, wird die erste Task in der Warteliste in den
                 Zustand  TASK_STATE_READY geschaltet.
 
+                Die Reihenfolge der Warteliste legt COS_SemCreateOrdered()
+                fest: COS_SEM_FIFO (Voreinstellung von COS_SemCreate())
+                haengt hinten an, O(1), die am laengsten wartende Task
+                kommt zuerst dran. Keine Task wartet dann laenger als
+                bis alle vor ihr Wartenden bedient sind. COS_SEM_PRIO
+                sortiert nach der Prioritaet beim Eintrag, gleiche
+                Prioritaeten der Reihe nach, O(Anzahl Wartende). Eine
+                niedrige Task kann hier verhungern, solange immer wieder
+                hoehere warten.
+
+@section Wie funktioniert ein Mutex in COS?
+                Ein Semaphor hat keinen Besitzer: haelt eine niedrig
+                priorisierte Task ein Betriebsmittel, kann jede mittlere
+                Task die hoch priorisierte, wartende Task beliebig lange
+                aufhalten (Prioritaetsinversion). Ein Mutex CosMutex_t
+                merkt sich daher seine Besitzer-Task. Wartet eine Task
+                mit hoeherer Prioritaet, erbt der Besitzer deren
+                Prioritaet bis zur Freigabe, ueber Ketten von Mutexen
+                hinweg. Die Wartezeit der hohen Task ist damit auf die
+                Zeit begrenzt, die der Besitzer den Mutex haelt.
+
+                Die wartenden Tasks stehen nach Prioritaet sortiert in
+                der Warteliste, die Freigabe uebergibt den Mutex direkt
+                an die erste. Der Besitzer darf den Mutex geschachtelt
+                mehrfach sperren und muss ihn ebenso oft freigeben. Wird
+                eine Task geloescht, die Mutexe haelt, gibt
+                COS_DeleteTask() sie frei und uebergibt sie wie
+                COS_MutexUnlock(); was sie schuetzen, kann dann halb
+                geaendert sein. Eine geloeschte wartende Task vererbt
+                nichts mehr an den Besitzer.
 
 
  ********************************************************************
@@ -81,21 +111,74 @@
 
 #include "cos_scheduler.h"
 #include "cos_linear_task_list.h"
+#include "cos_trace.h"
+
+
+/*! Breite des Semaphor-Zaehlers in Bit: 8, 16 oder 32. Mit 8 Bit zaehlt
+    ein Semaphor bis 127, z.B. auch die freien Slots eines FIFO. Weitere
+    Signale laufen nicht ueber, COS_SEM_SIGNAL() und
+    COS_SemSignalMany() begrenzen den Zaehler und liefern -1. */
+#define COS_SEM_COUNT_BITS   8
+
+#if COS_SEM_COUNT_BITS == 8
+  typedef int8_t  CosSemCount_t;
+  #define COS_SEM_COUNT_MAX  0x7F
+#elif COS_SEM_COUNT_BITS == 16
+  typedef int16_t CosSemCount_t;
+  #define COS_SEM_COUNT_MAX  0x7FFF
+#elif COS_SEM_COUNT_BITS == 32
+  typedef int32_t CosSemCount_t;
+  #define COS_SEM_COUNT_MAX  0x7FFFFFFF
+#else
+  #error "COS_SEM_COUNT_BITS must be 8, 16 or 32"
+#endif
 
 
 /***********************************************
  * FIFO data structure :
  ***********************************************/
 typedef struct {
-        int8_t count;     /*!< Anzahl der Ereignisse, Vorzeichen wird intern genutzt */
-        Node_t *root_pt;  /*!< Zeiger auf naechste Knoten in der Liste der wartenden Tasks */
+        CosSemCount_t count;     /*!< Anzahl der Ereignisse, Vorzeichen wird intern genutzt */
+        uint8_t order;    /*!< COS_SEM_FIFO oder COS_SEM_PRIO */
+        CosTask_t *root_pt;  /*!< Zeiger auf erste Task in der Liste der wartenden Tasks */
 } CosSema_t;
 
+/* Reihenfolge der Warteliste eines Semaphors */
+#define COS_SEM_FIFO    0  /*!< in der Reihenfolge des Wartens */
+#define COS_SEM_PRIO    1  /*!< hoechste Prioritaet zuerst */
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Mutex mit Besitzer und Prioritaetsvererbung, siehe oben.
+ ********************************************************************/
+typedef struct CosMutex_s {
+        CosTask_t *owner_pt;    /*!< Besitzer oder NULL */
+        CosTask_t *root_pt;     /*!< wartende Tasks, hoechste Prioritaet zuerst */
+        struct CosMutex_s *nextHeld_pt; /*!< naechster Mutex desselben Besitzers */
+        uint8_t nest;           /*!< Schachtelungstiefe des Besitzers */
+} CosMutex_t;
 
 
 
-uint8_t COS_SemCreate(CosSema_t *s, int8_t n_start);
+
+uint8_t COS_SemCreate(CosSema_t *s, CosSemCount_t n_start);
+uint8_t COS_SemCreateOrdered(CosSema_t *s, CosSemCount_t n_start, uint8_t order);
 uint8_t COS_SemDestroy(CosSema_t *s);
+int8_t  COS_SemTryWait(CosSema_t *s);
+
+void    COS_MutexInit(CosMutex_t *m);
+int8_t  COS_MutexUnlock(CosMutex_t *m, CosTask_t *pt);
+CosTask_t *COS_MutexGetOwner(CosMutex_t *m);
+
+/* intern, nur ueber die Macros bzw. vom Scheduler benutzen */
+void    _semEnqueue(CosSema_t *s, CosTask_t *pt);
+void    _semBlock(CosSema_t *s, CosTask_t *pt);
+uint8_t _mutexLock(CosMutex_t *m, CosTask_t *pt);
+uint8_t _mutexInheritedPrio(CosTask_t *task_pt);
+void    _mutexWaiterPrioChanged(CosTask_t *task_pt);
+void    _mutexTaskDeleted(CosTask_t *task_pt);
 
 
 
@@ -111,9 +194,10 @@ Der Zustand der Task wird dann auf TASK_STATE_BLOCKED gesetzt, der Scheduler
 wird diese Task nicht mehr starten. Die Task wird in die Liste der an diesem
 Sema wartenden Tasks eingetragen.
 
-Eventuell sollte man die Liste nach Task-Prio sortieren. Aber auch wenn man
-die Warteliste nach Prioritaet sortiert, ist das Problem von
-Prioritaetsinversionen nicht geloest.
+Die Liste ist je nach Semaphor FIFO oder nach Prioritaet sortiert, siehe
+COS_SemCreateOrdered(). Auch eine nach Prioritaet sortierte Warteliste
+loest das Problem von Prioritaetsinversionen nicht, dafuer gibt es
+CosMutex_t.
 
 
 
@@ -155,7 +239,8 @@ void myTask(CosTask_t *pt)
 #define COS_SEM_WAIT(s,pt)  (pt)->lineCnt=__LINE__;\
                             if((s)->count <= 0) {  \
                               (pt)->state = TASK_STATE_BLOCKED; \
-                              (s)->root_pt=_addTaskAtBeginningOfTaskList((s)->root_pt,(pt)); \
+                              COS_TRACE_EVENT(COS_TRACE_BLOCK,(s),0); \
+                              _semEnqueue((s),(pt)); \
                             } \
                             ((s)->count)--; \
                             return;\
@@ -163,7 +248,50 @@ void myTask(CosTask_t *pt)
 
 
 
-void COS_SEM_SIGNAL(CosSema_t *s);
+int8_t COS_SEM_SIGNAL(CosSema_t *s);
+int8_t COS_SemSignalMany(CosSema_t *s, CosSemCount_t n);
+
+
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Dieses Macro sperrt einen Mutex. Ist er frei oder gehoert er schon
+  der Task (geschachtelt), laeuft die Task sofort weiter. Sonst
+  blockiert sie, der Besitzer erbt ihre Prioritaet, falls sie hoeher
+  ist. Bei der Freigabe wird der Mutex direkt an die wartende Task mit
+  der hoechsten Prioritaet uebergeben.
+
+@see COS_MutexUnlock()
+@param m  - IN/OUT, Zeiger auf CosMutex_t
+@param pt - IN, Zeiger auf Task-Struktur
+
+@par Code Beispiel:
+@verbatim
+CosMutex_t spiMutex;
+...
+void sensorTask(CosTask_t *pt)
+{   COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_MUTEX_LOCK(&spiMutex, pt);
+        _spiTransfer();
+        COS_TASK_SCHEDULE(pt);     // the lock is kept across yields
+        _spiTransfer();
+        COS_MutexUnlock(&spiMutex, pt);
+        COS_TASK_SLEEP(pt, 10);
+    }
+    COS_TASK_END(pt);
+}
+@endverbatim
+********************************************************************/
+#define COS_MUTEX_LOCK(m,pt)  (pt)->lineCnt=__LINE__;\
+                            if(0) {\
+                              case __LINE__: ;\
+                            }\
+                            if(0 == _mutexLock((m),(pt))) {\
+                              return;\
+                            }
 
 
 
@@ -47,10 +47,20 @@ in der ISR gesetzt und rueckgesetzt.
 #include "cos_systime.h"
 #include "iodefine.h"
 #include "isr.h"
+#include "cos_trace.h"
+#include "cos_hrtimer.h"
+#include "cos_preempt.h"
 
 
 #define MICROSEC_PER_TICK 1000
 
+/*! CMT0 Vergleichswert fuer einen Tick (PCLKB/8), siehe _initSystemTime() */
+#define CMT0_CMCOR_PER_TICK   0x1700
+/*! CMT0 Zaehlschritte pro Tick, der Zaehler beginnt nach dem Vergleich bei 0 */
+#define CMT0_COUNTS_PER_TICK  ((uint32_t)CMT0_CMCOR_PER_TICK + 1)
+/*! so viele Ticks passen hoechstens in den 16 Bit Zaehler von CMT0 */
+#define TICKLESS_MAX_TICKS    ((uint16_t)(0xFFFFUL / CMT0_COUNTS_PER_TICK))
+
 
 
 /************************************************************
@@ -131,11 +141,34 @@ static volatile unsigned char _led15_state=0;
  * static variables
  ****************************************************************/
 
-static volatile uint16_t systemTimeInTicks=0; /*!< privater Zaehler */
+static volatile uint32_t systemTimeInTicks=0; /*!< privater Zaehler, untere 32 Bit */
+static volatile uint32_t systemTimeWraps=0;   /*!< Ueberlaeufe von systemTimeInTicks */
+static volatile uint16_t ticksPerInterrupt=1;  /*!< >1 waehrend _idleWaitTicks() */
+static volatile uint32_t cyclesBase=0;  /*!< CMT0 Zaehlschritte bis zum Beginn der
+                                             aktuellen Timer-Periode */
+static volatile uint8_t idleWakeRequest=0; /*!< 1: _idleWaitTicks() nicht schlafen */
 
 
 
 
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+   Zaehlt die Systemzeit um n Ticks weiter, mit Uebertrag in die
+   oberen 32 Bit. Nur aus der ISR oder bei gesperrten Interrupts.
+
+ * @param  n  - IN, Anzahl Ticks
+ * @retval - keiner
+ ************************************************************************/
+static void _addTicks(uint16_t n)
+{   uint32_t t = systemTimeInTicks + n;
+
+    if(t < systemTimeInTicks)
+    {   systemTimeWraps++;
+    }
+    systemTimeInTicks = t;
+}
+/*-------------------------------------------------------*/
 /*!
  **********************************************************************
  * @par Beschreibung:
@@ -155,6 +188,7 @@ static volatile uint16_t systemTimeInTicks=0; /*!< privater Zaehler */
  *******************************/
 void INT_Excep_CMT0_CMI0(void)
 {
+    COS_TRACE_EVENT(COS_TRACE_ISR, 0, 28);   /* vector CMT0 CMI0 */
 #if DEBUG
 	if(_led15_state)
 	{
@@ -167,7 +201,34 @@ void INT_Excep_CMT0_CMI0(void)
 		_led15_state = 1;
 	}
 #endif
-    systemTimeInTicks++;    // Ueberlauf zaehlen
+    _addTicks(ticksPerInterrupt);    // Ueberlauf zaehlen
+    cyclesBase += (uint32_t)ticksPerInterrupt * CMT0_COUNTS_PER_TICK;
+    if(ticksPerInterrupt != 1)
+    {   /* end of a stretched tickless period: back to one tick */
+        CMT0.CMCOR = CMT0_CMCOR_PER_TICK;
+        ticksPerInterrupt = 1;
+    }
+#if COS_PREEMPT
+    _preemptTick(systemTimeInTicks);   /* wake P-tasks, SWINT switches */
+#endif
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+   Interrupt Service Routine (ISR) fuer den Compare Match von Timer1,
+   der als One-Shot fuer die HR-Timer laeuft (cos_hrtimer.c). Der Timer
+   wird angehalten, _hrTimerExpired() stellt ihn bei Bedarf neu.
+
+ * @see _hrTimerArm()
+ * @param  - keine
+ * @retval - keiner
+ ************************************************************************/
+void INT_Excep_CMT1_CMI1(void)
+{
+    COS_TRACE_EVENT(COS_TRACE_ISR, 0, 29);   /* vector CMT1 CMI1 */
+    CMT.CMSTR0.BIT.STR1 = 0;
+    _hrTimerExpired();
 }
 
 
@@ -230,7 +291,7 @@ void INT_Excep_CMT0_CMI0(void)
 	 	//CMT0.CMCOR = 0x2222; // 1.5 ms
 	 	//CMT0.CMCOR = 0x1560; // 0.917 ms
 	 	//CMT0.CMCOR = 0x1600; // 0.956 ms
-	 	CMT0.CMCOR = 0x1700; // 0.99 ms
+	 	CMT0.CMCOR = CMT0_CMCOR_PER_TICK; // 0x1700: 0.99 ms
 
 	 	/* PCLKB/8 als Taktquelle wählen.
 	 	   CKS = clock select. */
@@ -247,6 +308,20 @@ void INT_Excep_CMT0_CMI0(void)
 	 	   CMSTR0 = compare match timer start register 0,
 	 	   STR0   = count start 0. */
 	 	CMT.CMSTR0.BIT.STR0 = 1;
+
+	 	/* CMT1 fuer die HR-Timer vorbereiten, gleicher Takt wie CMT0,
+	 	   der Timer wird erst von _hrTimerArm() gestartet. MSTP(CMT1)
+	 	   ist dasselbe Bit wie MSTP(CMT0). */
+	 	CMT1.CMCR.BIT.CKS = 0;
+	 	CMT1.CMCR.BIT.CMIE = 1;
+	 	IPR(CMT1,CMI1) = 3;   /* above the tick, short ISR */
+	 	IEN(CMT1,CMI1) = 1;
+	 #if COS_PREEMPT
+	 	/* SWINT fuer den Taskwechsel der P-Tasks, niedrigste Prioritaet:
+	 	   er laeuft erst, wenn alle anderen ISRs fertig sind. */
+	 	IPR(ICU,SWINT) = 1;
+	 	IEN(ICU,SWINT) = 1;
+	 #endif
 	 #if DEBUG
 	 	_LedInitPortDirections();
 	 #endif
@@ -283,11 +358,86 @@ void INT_Excep_CMT0_CMI0(void)
  uint16_t _gettime_Ticks(void)
 {   uint16_t t;
     //cli();  // INT sperren, exklusiven Zugriff sichern
-    t = systemTimeInTicks;
+    t = (uint16_t) systemTimeInTicks;
     //sei(); // INT freigeben, Timer0 ISR darf systemTimeInTicks aendern
     return t;
 }
 /*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Systemzeit in Ticks als 32 Bit Wert, fuer den Scheduler. Der Wert
+ *   laeuft erst nach etwa 49 Tagen ueber, Differenzen bleiben richtig.
+ *   Das Lesen ist ein einzelner 32 Bit Zugriff und braucht keine Sperre.
+ *
+ * @see _gettime_Ticks(), _gettime_Ticks64()
+ * @param  - keine
+ *
+ * @retval                - Systemzeit in Ticks
+ ************************************************************************/
+CosTicks_t _gettime_Ticks32(void)
+{   return systemTimeInTicks;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Systemzeit in Ticks als 64 Bit Wert, laeuft praktisch nie ueber.
+ *   Aendert die ISR den Zaehler waehrend des Lesens, wird neu gelesen.
+ *
+ * @see _gettime_MicroSec64()
+ * @param  - keine
+ *
+ * @retval                - Systemzeit in Ticks seit _initSystemTime()
+ ************************************************************************/
+uint64_t _gettime_Ticks64(void)
+{   uint32_t base, lo, hi;
+
+    do
+    {   base = cyclesBase;
+        lo   = systemTimeInTicks;
+        hi   = systemTimeWraps;
+    } while(base != cyclesBase);   /* ISR in between: read again */
+    return ((uint64_t) hi << 32) | lo;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Monotone Systemzeit in Mikrosekunden als 64 Bit Wert: die Ticks
+ *   plus der angebrochene Tick aus dem Zaehlerstand CMCNT von CMT0.
+ *   Die Aufloesung ist ein Zaehlschritt von CMT0, die Umrechnung nimmt
+ *   wie _cyclesToMicroSec() MICROSEC_PER_TICK je Tick an.
+ *
+ * @see _gettime_Ticks64(), _getCycles()
+ * @param  - keine
+ *
+ * @retval                - Systemzeit in Mikrosekunden
+ ************************************************************************/
+uint64_t _gettime_MicroSec64(void)
+{   uint32_t base, lo, hi;
+    uint16_t cnt;
+    uint8_t  pending;
+    uint64_t ticks;
+
+    do
+    {   base    = cyclesBase;
+        lo      = systemTimeInTicks;
+        hi      = systemTimeWraps;
+        cnt     = CMT0.CMCNT;
+        pending = IR(CMT0,CMI0);
+        if(pending)
+        {   cnt = CMT0.CMCNT;   /* counter restarted at the compare match */
+        }
+    } while(base != cyclesBase);   /* ISR in between: read again */
+    ticks = ((uint64_t) hi << 32) | lo;
+    if(pending)
+    {   ticks += ticksPerInterrupt;   /* the ISR has not counted it yet */
+    }
+    return ticks * MICROSEC_PER_TICK +
+           ((uint32_t) cnt * MICROSEC_PER_TICK) / CMT0_COUNTS_PER_TICK;
+}
+/*-------------------------------------------------------*/
 /*!
  **********************************************************************
  * @par Beschreibung:
@@ -312,3 +462,353 @@ void INT_Excep_CMT0_CMI0(void)
 
 
 
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Tickless idle: haelt die CPU mit dem RX-Befehl WAIT an, bis zu
+ *   nTicks Ticks lang oder bis ein anderer Interrupt eintrifft. Dazu
+ *   wird die Periode von CMT0 (CMCOR) auf nTicks Ticks verlaengert,
+ *   die ISR zaehlt dann alle diese Ticks auf einmal. Wird die CPU
+ *   vorher durch einen anderen Interrupt geweckt, wird der Timer kurz
+ *   angehalten, die bereits vergangenen ganzen Ticks werden aus dem
+ *   Zaehlerstand CMCNT berechnet und zu systemTimeInTicks addiert,
+ *   der angebrochene Tick laeuft mit der normalen Periode weiter.
+ *   Der 16 Bit Zaehler von CMT0 begrenzt eine Wartezeit auf
+ *   TICKLESS_MAX_TICKS, laengere Wartezeiten muss der Aufrufer in
+ *   mehreren Aufrufen abwarten.
+ *
+ * @see _initSystemTime()
+ * @arg
+ *
+ * @param  nTicks  - IN, maximale Wartezeit in Ticks, 0 kehrt sofort zurueck
+ *
+ * @retval                - tatsaechlich vergangene Zeit in Ticks
+ *
+ ************************************************************************/
+uint16_t _idleWaitTicks(uint16_t nTicks)
+{   uint16_t t_start;
+    uint16_t cnt;
+    uint16_t whole;
+
+    if(0 == nTicks)
+    {   return 0;
+    }
+    if(nTicks > TICKLESS_MAX_TICKS)
+    {   nTicks = TICKLESS_MAX_TICKS;
+    }
+    __asm__ volatile ("clrpsw i");   /* no interrupt between setup and WAIT */
+    if(idleWakeRequest)
+    {   /* an ISR has left work for the scheduler since its last pass */
+        idleWakeRequest = 0;
+        __asm__ volatile ("setpsw i");
+        return 0;
+    }
+    t_start = (uint16_t) systemTimeInTicks;
+    if(nTicks > 1)
+    {   /* the counter keeps running, CMCOR is only moved further away */
+        ticksPerInterrupt = nTicks;
+        CMT0.CMCOR = (uint16_t)(nTicks * CMT0_COUNTS_PER_TICK - 1);
+    }
+    __asm__ volatile ("wait");       /* sets PSW.I, sleeps until any interrupt */
+    __asm__ volatile ("clrpsw i");
+    idleWakeRequest = 0;             /* the scheduler runs a pass now anyway */
+
+    if((ticksPerInterrupt != 1) && (0 == IR(CMT0,CMI0)))
+    {   /* woken early by another interrupt: count the elapsed ticks */
+        CMT.CMSTR0.BIT.STR0 = 0;
+        cnt   = CMT0.CMCNT;
+        whole = (uint16_t)(cnt / CMT0_COUNTS_PER_TICK);
+        CMT0.CMCNT = (uint16_t)(cnt - whole * CMT0_COUNTS_PER_TICK);
+        CMT0.CMCOR = CMT0_CMCOR_PER_TICK;
+        ticksPerInterrupt = 1;
+        _addTicks(whole);
+        cyclesBase += (uint32_t)whole * CMT0_COUNTS_PER_TICK;
+        CMT.CMSTR0.BIT.STR0 = 1;
+    }
+    /* else: the CMT0 ISR has run or is pending and counts nTicks itself */
+    __asm__ volatile ("setpsw i");
+    return (uint16_t)(systemTimeInTicks - t_start);
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Liefert einen frei laufenden 32 Bit Zaehler in Zaehlschritten von
+ *   CMT0 (PCLKB/8), fuer Laufzeitmessungen mit einer Aufloesung weit
+ *   unter einem Tick. Der Wert setzt sich aus den Zaehlschritten aller
+ *   vergangenen Timer-Perioden und dem Zaehlerstand CMCNT zusammen.
+ *   Ist der Vergleich schon erfolgt, die ISR aber noch nicht gelaufen,
+ *   so wird die abgelaufene Periode hier mitgezaehlt und CMCNT neu
+ *   gelesen: der erste Wert kann noch vor dem Vergleich liegen, dann
+ *   waere die Zeit um eine Periode zu gross. Der Zaehler
+ *   laeuft nach 2^32 Schritten ueber, Differenzen bleiben richtig.
+ *
+ * @see _cyclesToMicroSec(), _cyclesAtTick()
+ * @param  - keine
+ *
+ * @retval                - Zeit in CMT0 Zaehlschritten
+ ************************************************************************/
+uint32_t _getCycles(void)
+{   uint32_t base;
+    uint16_t cnt;
+    uint8_t  pending;
+
+    do
+    {   base    = cyclesBase;
+        cnt     = CMT0.CMCNT;
+        pending = IR(CMT0,CMI0);
+        if(pending)
+        {   cnt = CMT0.CMCNT;   /* counter restarted at the compare match */
+        }
+    } while(base != cyclesBase);   /* ISR in between: read again */
+    if(pending)
+    {   base += (uint32_t)ticksPerInterrupt * CMT0_COUNTS_PER_TICK;
+    }
+    return base + cnt;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Rechnet einen Zeitpunkt in Ticks (nicht in der Zukunft) in den
+ *   Stand von _getCycles() zu Beginn dieses Ticks um.
+ *
+ * @see _getCycles()
+ * @param  t_Ticks  - IN, Zeitpunkt in Ticks
+ *
+ * @retval                - Zeit in CMT0 Zaehlschritten
+ ************************************************************************/
+uint32_t _cyclesAtTick(CosTicks_t t_Ticks)
+{   uint32_t base;
+    CosTicks_t now_Ticks;
+
+    do
+    {   base      = cyclesBase;
+        now_Ticks = systemTimeInTicks;
+    } while(base != cyclesBase);
+    return base - (uint32_t)(now_Ticks - t_Ticks) * CMT0_COUNTS_PER_TICK;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Rechnet eine Differenz von _getCycles() Werten in Mikrosekunden um.
+ *
+ * @see _getCycles()
+ * @param  cycles  - IN, Zeit in CMT0 Zaehlschritten
+ *
+ * @retval                - Zeit in Mikrosekunden
+ ************************************************************************/
+uint32_t _cyclesToMicroSec(uint32_t cycles)
+{   /* split to avoid an overflow of cycles * MICROSEC_PER_TICK */
+    return (cycles / CMT0_COUNTS_PER_TICK) * MICROSEC_PER_TICK +
+           ((cycles % CMT0_COUNTS_PER_TICK) * MICROSEC_PER_TICK) / CMT0_COUNTS_PER_TICK;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Liefert die Anzahl der _getCycles() Zaehlschritte pro Millisekunde,
+ *   z.B. um lange Summen von Laufzeiten umzurechnen.
+ *
+ * @see _getCycles(), _cyclesToMicroSec()
+ * @param  - keine
+ *
+ * @retval                - Zaehlschritte pro Millisekunde
+ ************************************************************************/
+uint32_t _cyclesPerMilliSec(void)
+{   return (CMT0_COUNTS_PER_TICK * 1000UL) / MICROSEC_PER_TICK;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Rechnet eine Zeit in Mikrosekunden in Zaehlschritte von
+ *   _getCycles() um, aufgerundet auf den naechsten ganzen Schritt.
+ *
+ * @see _cyclesToMicroSec()
+ * @param  us  - IN, Zeit in Mikrosekunden, unter 2^31 Zaehlschritten
+ *
+ * @retval                - Zeit in CMT0 Zaehlschritten
+ ************************************************************************/
+uint32_t _microSecToCycles(uint32_t us)
+{   /* split like _cyclesToMicroSec() */
+    return (us / MICROSEC_PER_TICK) * CMT0_COUNTS_PER_TICK +
+           ((us % MICROSEC_PER_TICK) * CMT0_COUNTS_PER_TICK + MICROSEC_PER_TICK - 1) /
+           MICROSEC_PER_TICK;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Aus einer ISR aufrufen, die eine Task bereit machen laesst: der
+ *   naechste Aufruf von _idleWaitTicks() kehrt dann sofort zurueck,
+ *   statt bis zum naechsten Tick zu schlafen. Sonst koennte das
+ *   Ereignis zwischen dem letzten Durchlauf des Schedulers und dem
+ *   Sperren der Interrupts in _idleWaitTicks() verloren gehen.
+ *
+ * @see _idleWaitTicks()
+ * @param  - keine
+ * @retval - keiner
+ ************************************************************************/
+void _idleWakeRequest(void)
+{   idleWakeRequest = 1;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Startet CMT1 als One-Shot: der Interrupt kommt nach cycles
+ *   Zaehlschritten (gleicher Takt wie CMT0). Der Zaehler hat 16 Bit,
+ *   laengere Zeiten werden auf 0x10000 Schritte begrenzt, die ISR
+ *   stellt den Timer dann weiter.
+ *
+ * @see _hrTimerStop(), INT_Excep_CMT1_CMI1()
+ * @param  cycles  - IN, Zeit bis zum Interrupt in CMT0 Zaehlschritten
+ * @retval - keiner
+ ************************************************************************/
+void _hrTimerArm(uint32_t cycles)
+{
+    if(0 == cycles)
+    {   cycles = 1;
+    }
+    if(cycles > 0x10000UL)
+    {   cycles = 0x10000UL;
+    }
+    CMT.CMSTR0.BIT.STR1 = 0;
+    IR(CMT1,CMI1) = 0;   /* drop a match of the previous setting */
+    CMT1.CMCNT = 0;
+    CMT1.CMCOR = (uint16_t)(cycles - 1);
+    CMT.CMSTR0.BIT.STR1 = 1;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Haelt CMT1 an, es ist kein HR-Timer mehr eingetragen.
+ *
+ * @see _hrTimerArm()
+ * @param  - keine
+ * @retval - keiner
+ ************************************************************************/
+void _hrTimerStop(void)
+{
+    CMT.CMSTR0.BIT.STR1 = 0;
+    IR(CMT1,CMI1) = 0;
+}
+/*-------------------------------------------------------*/
+
+
+
+
+#if COS_PREEMPT
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Legt den Anfangs-Kontext einer P-Task auf ihren Stack, so wie ihn
+ *   INT_Excep_ICU_SWINT() beim Wechsel wieder abraeumt: ACC, FPSW,
+ *   R1..R15, PC und PSW. Die Task beginnt in _preemptTaskStart() im
+ *   Supervisor-Mode auf dem USP mit freigegebenen Interrupts.
+ *
+ * @see INT_Excep_ICU_SWINT()
+ * @param  t          - IN/OUT, P-Task, t->sp wird gesetzt
+ * @param  stack_p    - IN, unteres Ende des Stacks
+ * @param  stackWords - IN, Groesse des Stacks in 32 Bit Worten
+ * @retval - keiner
+ ************************************************************************/
+void _preemptInitContext(CosPTask_t *t, uint32_t *stack_p, uint16_t stackWords)
+{
+    uint32_t *sp = stack_p + stackWords;
+    uint8_t r;
+
+    *--sp = 0x00030000UL;                   /* PSW: I=1, U=1, IPL 0 */
+    *--sp = (uint32_t) _preemptTaskStart;   /* PC */
+    for(r = 15; r >= 1; r--)
+    {   *--sp = 0;                          /* R15 ... R1 */
+    }
+    *--sp = 0x00000100UL;                   /* FPSW, wie in start.asm */
+    *--sp = 0;                              /* ACC high */
+    *--sp = 0;                              /* ACC middle */
+    t->sp = sp;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Fordert den Taskwechsel an. SWINT hat die niedrigste Prioritaet,
+ *   er laeuft also am Ende der aufrufenden ISR bzw. sobald die Task
+ *   die Interrupts wieder freigibt.
+ *
+ * @see INT_Excep_ICU_SWINT()
+ * @param  - keine
+ * @retval - keiner
+ ************************************************************************/
+void _preemptRequestSwitch(void)
+{
+    ICU.SWINTR.BIT.SWINT = 1;
+}
+/*-------------------------------------------------------*/
+/*!
+ **********************************************************************
+ * @par Beschreibung:
+ *   Taskwechsel der P-Tasks. Alle Tasks (auch die kooperative Stufe)
+ *   laufen auf dem USP, die CPU hat PC und PSW beim Eintritt auf den
+ *   ISP gelegt. Die ISR kopiert sie zusammen mit R15 auf den USP,
+ *   sichert dort R1..R14, FPSW und ACC und merkt sich den USP in
+ *   _preemptCurrent_pt->sp. _preemptSelectNext() waehlt die naechste
+ *   Task, deren Kontext wird in umgekehrter Reihenfolge geladen, RTE
+ *   holt PC und PSW vom neuen USP. Die Interrupts bleiben dabei
+ *   gesperrt. Aufbau wie im RX600 Port von FreeRTOS.
+ *   Symbole aus C haben im Assembler einen zusaetzlichen '_'.
+ *
+ * @see _preemptInitContext(), _preemptRequestSwitch()
+ * @param  - keine
+ * @retval - keiner
+ ************************************************************************/
+void INT_Excep_ICU_SWINT(void) __attribute__ ((naked));
+void INT_Excep_ICU_SWINT(void)
+{
+    __asm__ volatile
+    (
+        /* move R15, PC and PSW from the ISP to the USP */
+        "PUSH.L    R15                      \n"
+        "MVFC      USP, R15                 \n"
+        "SUB       #12, R15                 \n"
+        "MVTC      R15, USP                 \n"
+        "MOV.L     [R0], [R15]              \n"
+        "MOV.L     4[R0], 4[R15]            \n"
+        "MOV.L     8[R0], 8[R15]            \n"
+        "ADD       #12, R0                  \n"
+        /* the rest goes directly onto the USP */
+        "SETPSW    U                        \n"
+        "PUSHM     R1-R14                   \n"
+        "MVFC      FPSW, R15                \n"
+        "PUSH.L    R15                      \n"
+        "MVFACHI   R15                      \n"
+        "PUSH.L    R15                      \n"
+        "MVFACMI   R15                      \n"
+        "SHLL      #16, R15                 \n"
+        "PUSH.L    R15                      \n"
+        /* _preemptCurrent_pt->sp = USP */
+        "MOV.L     #__preemptCurrent_pt, R15 \n"
+        "MOV.L     [R15], R15               \n"
+        "MOV.L     R0, [R15]                \n"
+        "BSR.A     __preemptSelectNext      \n"
+        /* USP = _preemptCurrent_pt->sp */
+        "MOV.L     #__preemptCurrent_pt, R15 \n"
+        "MOV.L     [R15], R15               \n"
+        "MOV.L     [R15], R0                \n"
+        "POP       R15                      \n"
+        "MVTACLO   R15                      \n"
+        "POP       R15                      \n"
+        "MVTACHI   R15                      \n"
+        "POP       R15                      \n"
+        "MVTC      R15, FPSW                \n"
+        "POPM      R1-R15                   \n"
+        "RTE                                \n"
+        "NOP                                \n"
+        "NOP                                \n"
+    );
+}
+/*-------------------------------------------------------*/
+#endif  // COS_PREEMPT
@@ -45,6 +45,11 @@
 //#include <stdint.h>
 #include "cos_types.h"
 
+/*! Zeit in Ticks fuer den Scheduler, laeuft nach 2^32 Ticks ueber.
+    Zeitspannen werden ueberlaufsicher als Differenz gerechnet und
+    muessen kleiner als 2^31 Ticks sein. */
+typedef uint32_t CosTicks_t;
+
 #define set_bit(sfr,bit)    sfr |= (1<<(bit))
 #define clear_bit(sfr,bit)  sfr &= ~(1<<(bit))
 
@@ -52,7 +57,41 @@
 void     _initSystemTime(void);
 uint16_t _microSecPerTick(void);
 uint16_t _gettime_Ticks(void);
+CosTicks_t _gettime_Ticks32(void);
+uint64_t _gettime_Ticks64(void);
+uint64_t _gettime_MicroSec64(void);
 uint16_t _milliSecToTicks(uint16_t milliSec);
+uint16_t _idleWaitTicks(uint16_t nTicks);
+uint32_t _getCycles(void);
+uint32_t _cyclesAtTick(CosTicks_t t_Ticks);
+uint32_t _cyclesToMicroSec(uint32_t cycles);
+uint32_t _cyclesPerMilliSec(void);
+uint32_t _microSecToCycles(uint32_t us);
+void     _idleWakeRequest(void);
+
+/* CMT1 als One-Shot fuer cos_hrtimer.c */
+void     _hrTimerArm(uint32_t cycles);
+void     _hrTimerStop(void);
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Sperrt die Interrupts und merkt sich den alten Zustand des I-Flags in
+  der Variablen state (Typ uint32_t). COS_IRQ_RESTORE(state) stellt den
+  alten Zustand wieder her, die Macros duerfen geschachtelt werden.
+  Im Host-Port (COS_HOST) laufen die nachgebildeten ISRs synchron zum
+  Programm, dort erzeugen die Macros keinen Code.
+
+@parameter state - OUT/IN, uint32_t Variable fuer das PSW
+********************************************************************/
+#if defined(COS_HOST)
+  #define COS_IRQ_SAVE(state)     ((state) = 0)
+  #define COS_IRQ_RESTORE(state)  ((void)(state))
+#else
+  #define COS_IRQ_SAVE(state)     __asm__ volatile ("mvfc psw,%0\n\tclrpsw i" : "=r" (state))
+  #define COS_IRQ_RESTORE(state)  __asm__ volatile ("mvtc %0,psw" : : "r" (state))
+#endif
 
 
 #endif
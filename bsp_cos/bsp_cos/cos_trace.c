@@ -0,0 +1,171 @@
+/*!
+ ********************************************************************
+   @file            cos_trace.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Ereignis-Trace fuer den co-operative Scheduler (COS)
+
+   @brief  Ringpuffer fuer binaere Trace-Ereignisse und Ausgabe ueber
+           die serielle Schnittstelle.
+
+   @par Beschreibung
+   Siehe cos_trace.h. Format der Ausgabe von COS_TraceDump():
+
+   @verbatim
+   COSTRACE 1 <Zaehlschritte pro ms, dez.> <Anzahl aller Ereignisse, dez.>
+   <t, 8 hex> <obj, 8 hex> <arg, 4 hex> <type, 2 hex>
+   ...
+   COSTRACE END
+   @endverbatim
+
+   Ist die Anzahl aller Ereignisse groesser als COS_TRACE_BUF_EVENTS,
+   so sind die aeltesten Ereignisse ueberschrieben worden.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#include "cos_trace.h"
+#include "cos_systime.h"
+#include "cos_ser.h"
+
+
+#if (COS_TRACE_BUF_EVENTS & (COS_TRACE_BUF_EVENTS - 1)) != 0
+  #error "COS_TRACE_BUF_EVENTS must be a power of two"
+#endif
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static CosTraceEvent_t traceBuf_g[COS_TRACE_BUF_EVENTS]; /*! Ringpuffer */
+static volatile uint32_t traceCount_g=0;  /*! Anzahl aller Ereignisse seit Start */
+static volatile uint8_t traceOn_g=1;      /*! 0 waehrend Stop und Dump */
+
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Traegt ein Ereignis in den Ringpuffer ein. Die Interrupts werden
+       nur fuer das Reservieren des Platzes gesperrt, damit auch ISRs
+       Ereignisse eintragen koennen. Der alte Zustand des I-Flags wird
+       wieder hergestellt.
+
+  @see COS_TRACE_EVENT()
+  @param  type - IN, Ereignistyp COS_TRACE_...
+  @param  obj  - IN, Zeiger auf das Objekt oder NULL
+  @param  arg  - IN, Argument
+  @retval keine
+ ********************************************************************/
+void _cosTrace(uint8_t type, const void *obj, uint16_t arg)
+{
+    CosTraceEvent_t *e;
+    uint32_t psw;
+
+    if(!traceOn_g)
+    {   return;
+    }
+    COS_IRQ_SAVE(psw);
+    e = &traceBuf_g[traceCount_g & (COS_TRACE_BUF_EVENTS - 1)];
+    traceCount_g++;
+    e->t    = _getCycles();
+    COS_IRQ_RESTORE(psw);
+    e->obj  = (uint32_t)(unsigned long) obj;
+    e->arg  = arg;
+    e->type = type;
+    e->rsv  = 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Loescht den Trace-Puffer und startet die Aufzeichnung neu.
+
+  @see COS_TraceStop(), COS_TraceDump()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void COS_TraceStart(void)
+{
+    traceOn_g = 0;
+    traceCount_g = 0;
+    traceOn_g = 1;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Haelt die Aufzeichnung an, z.B. sobald eine Latenz-Spitze
+       erkannt wurde, damit die Vorgeschichte erhalten bleibt.
+
+  @see COS_TraceStart()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void COS_TraceStop(void)
+{
+    traceOn_g = 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Gibt den Inhalt des Trace-Puffers ueber die serielle
+       Schnittstelle aus, das aelteste Ereignis zuerst. Waehrend der
+       Ausgabe ist die Aufzeichnung angehalten, danach laeuft sie im
+       alten Zustand weiter. Die Ausgabe wird auf dem Host mit
+       tools/cos_trace2json.py umgewandelt.
+
+  @see cos_trace.h
+  @param  keine
+  @retval keine
+
+  @par Code-Beispiel:
+  @verbatim
+    if(latency_us > 500)
+    {   COS_TraceStop();
+        COS_TraceDump();
+    }
+  @endverbatim
+ ********************************************************************/
+void COS_TraceDump(void)
+{
+    uint8_t  wasOn = traceOn_g;
+    uint32_t count;
+    uint32_t i;
+    CosTraceEvent_t *e;
+
+    traceOn_g = 0;
+    count = traceCount_g;
+    serPuts("\r\nCOSTRACE 1 ");
+    serOutUint32Dec(_cyclesPerMilliSec());
+    serPutc(' ');
+    serOutUint32Dec(count);
+    /* the buffer holds the last COS_TRACE_BUF_EVENTS events */
+    i = (count > COS_TRACE_BUF_EVENTS) ? (count - COS_TRACE_BUF_EVENTS) : 0;
+    for( ; i < count; i++)
+    {   e = &traceBuf_g[i & (COS_TRACE_BUF_EVENTS - 1)];
+        serPuts("\r\n");
+        serOutUint32Hex(e->t);    serPutc(' ');
+        serOutUint32Hex(e->obj);  serPutc(' ');
+        serOutUint16Hex(e->arg);  serPutc(' ');
+        serOutUint8Hex(e->type);
+    }
+    serPuts("\r\nCOSTRACE END\r\n");
+    traceOn_g = wasOn;
+}
+/*---------------------------------------------------------------*/
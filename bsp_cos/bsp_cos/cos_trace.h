@@ -0,0 +1,111 @@
+/*!
+ ********************************************************************
+   @file            cos_trace.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Ereignis-Trace fuer den co-operative Scheduler (COS)
+
+   @brief  Binaerer Trace der Scheduler-, Semaphor- und FIFO-Ereignisse
+
+
+   @section Wie funktioniert der Trace?
+                Mit COS_TRACE 1 schreiben Scheduler, Semaphoren und FIFOs
+                jedes wichtige Ereignis als 12 Byte Datensatz in einen
+                Ringpuffer im RAM: Zeitstempel aus _getCycles(), Adresse
+                des Objekts (Task, Semaphor, FIFO), ein 16 Bit Argument
+                und den Ereignistyp. Ist der Puffer voll, werden die
+                aeltesten Ereignisse ueberschrieben. Ein Eintrag kostet
+                nur wenige Befehle, es wird nichts formatiert.
+                COS_TraceDump() gibt den Puffer als Hex-Zeilen ueber die
+                serielle Schnittstelle aus. Das Host-Programm
+                tools/cos_trace2json.py wandelt diese Ausgabe in das JSON
+                Format von Chrome-Trace bzw. Perfetto um.
+                Mit COS_TRACE 0 erzeugen die Macros keinen Code.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_trace_h_
+#define _cos_trace_h_
+
+
+#include "cos_types.h"
+
+
+/*! 1: Ereignisse werden aufgezeichnet, 0: die Trace-Macros erzeugen keinen Code */
+#define COS_TRACE                0
+/*! Anzahl der Ereignisse im Ringpuffer, muss eine Zweierpotenz sein */
+#define COS_TRACE_BUF_EVENTS     256
+
+
+/* Ereignistypen, obj und arg je Typ */
+#define COS_TRACE_DISPATCH       1  /*!< Task startet,       obj=Task, arg=Prio */
+#define COS_TRACE_RETURN         2  /*!< Task gibt ab,       obj=Task, arg=0 */
+#define COS_TRACE_SLEEP          3  /*!< Task schlaeft,      obj=Task, arg=Sleep-Ticks */
+#define COS_TRACE_BLOCK          4  /*!< Task blockiert,     obj=Semaphor, arg=0 */
+#define COS_TRACE_SIGNAL         5  /*!< Semaphor Signal,    obj=Semaphor, arg=Zaehler */
+#define COS_TRACE_READY          6  /*!< Task wird bereit,   obj=Task, arg=0 */
+#define COS_TRACE_FIFO_WRITE     7  /*!< FIFO geschrieben,   obj=FIFO, arg=belegte Slots */
+#define COS_TRACE_FIFO_READ      8  /*!< FIFO gelesen,       obj=FIFO, arg=belegte Slots */
+#define COS_TRACE_ISR            9  /*!< Interrupt Eintritt, obj=0, arg=Vektor */
+#define COS_TRACE_CREATE        10  /*!< Task erzeugt,       obj=Task, arg=Prio */
+#define COS_TRACE_DELETE        11  /*!< Task geloescht,     obj=Task, arg=0 */
+#define COS_TRACE_SWITCH        12  /*!< P-Task Wechsel,     obj=P-Task, arg=Prio */
+
+
+/*!
+ ********************************************************************
+  @par Beschreibung
+  Ein Ereignis im Trace-Puffer, 12 Byte.
+ ********************************************************************/
+typedef struct {
+        uint32_t t;       /*!< Zeitstempel, _getCycles() */
+        uint32_t obj;     /*!< Adresse von Task, Semaphor oder FIFO */
+        uint16_t arg;     /*!< Argument, je nach Ereignistyp */
+        uint8_t  type;    /*!< COS_TRACE_DISPATCH ... */
+        uint8_t  rsv;     /*!< reserviert, 0 */
+} CosTraceEvent_t;
+
+
+void COS_TraceStart(void);
+void COS_TraceStop(void);
+void COS_TraceDump(void);
+
+/* intern, nur ueber das Macro COS_TRACE_EVENT() benutzen */
+void _cosTrace(uint8_t type, const void *obj, uint16_t arg);
+
+
+/*!
+********************************************************************
+  @par Beschreibung
+  Zeichnet ein Ereignis auf, falls COS_TRACE 1 ist, sonst entsteht kein
+  Code. Das Macro darf auch in Interrupt Service Routinen stehen.
+
+@parameter type - IN, Ereignistyp COS_TRACE_...
+@parameter obj  - IN, Zeiger auf das betroffene Objekt oder NULL
+@parameter arg  - IN, 16 Bit Argument
+
+@returns  nichts
+********************************************************************/
+#if COS_TRACE
+  #define COS_TRACE_EVENT(type,obj,arg) _cosTrace((type),(obj),(uint16_t)(arg))
+#else
+  #define COS_TRACE_EVENT(type,obj,arg)
+#endif
+
+
+#endif
@@ -60,6 +60,10 @@
 
 
 
+#if defined(COS_HOST)
+/* host port (see ../host): the host C library defines the exact types */
+#include <stdint.h>
+#else
 /* for compatibility with gcc types: */
 #ifndef int8_t
   #define int8_t signed char
@@ -79,6 +83,10 @@
 #ifndef uint32_t
   #define uint32_t unsigned long
 #endif
+#ifndef uint64_t
+  #define uint64_t unsigned long long
+#endif
+#endif /* COS_HOST */
 
 
 
@@ -43,8 +43,9 @@ void INT_Excep_FCU_FIFERR(void){ }
 // FCU_FRDYI
 void INT_Excep_FCU_FRDYI(void){ }
 
-#if !FREERTOS_IS_PRESENT
+#if !FREERTOS_IS_PRESENT && !COS_PREEMPT_IS_PRESENT
 // ICU SWINT
+// mit COS_PREEMPT_IS_PRESENT in cos_systime.c implementiert
 void INT_Excep_ICU_SWINT(void){ }
 #endif
 
@@ -57,7 +58,10 @@ void INT_Excep_CMT0_CMI0(void){ }
 #endif
 
 // CMT1 CMI1
+/***************************
+ * jetzt in cos_systime.c implementiert (HR-Timer)!
 void INT_Excep_CMT1_CMI1(void){ }
+******************************/
 
 // CMT2 CMI2
 void INT_Excep_CMT2_CMI2(void){ }
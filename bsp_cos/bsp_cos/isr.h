@@ -74,7 +74,7 @@ void INT_Excep_FCU_FRDYI(void) __attribute__ ((interrupt));;
 // vector 26 reserved
 
 #ifdef BSP_IS_PRESENT
-# if !FREERTOS_IS_PRESENT
+# if !FREERTOS_IS_PRESENT && !COS_PREEMPT_IS_PRESENT
 // ICU SWINT
 void INT_Excep_ICU_SWINT(void) __attribute__ ((interrupt));;
 # endif
@@ -34,6 +34,7 @@
 #define POLL_SERIAL_INTERFACE_H_
 
 #include "cos_types.h"
+#include "cos_semaphore.h"
 
 /*********************************************************************
  * Die Implementierung der Funktionen liegt in 'read.c'. Die ISR der
@@ -42,6 +43,7 @@
 
 void _initSerialInterface_RX_Interrupt(void);
 int16_t _pollSerialInterface(void);
+void _setSerialInterface_RX_Semaphore(CosSema_t *s);
 
 
 #endif /* POLL_SERIAL_INTERFACE_H_ */
@@ -41,6 +41,8 @@
 #include "bsp.h"
 #include "iodefine.h"
 #include "cos_types.h"
+#include "cos_defer.h"
+#include "cos_trace.h"
 
 
 #define Use_FGB_Modification 1
@@ -63,6 +65,7 @@ static volatile uint8_t rx_fifo[RX_BUFFER_LENGTH] = {0};  /*! receiver buffer */
 static volatile uint8_t rx_rd_index = 0; /*! read index for receiver buffer */
 static volatile uint8_t rx_wr_index = 0; /*! write index for receiver buffer */
 static volatile uint8_t rx_fifo_used_bytes =0; /*! number of bytes in fifo */
+static CosSema_t *rx_sema = NULL; /*! signalled when the fifo gets data, may be NULL */
 
 
 
@@ -173,6 +176,7 @@ void INT_Excep_SCI2_RXI2(void)
 {
 	uint8_t x;
 
+	COS_TRACE_EVENT(COS_TRACE_ISR, 0, 220);   /* vector SCI2 RXI2 */
 	/* Den Empfangsinterrupt deaktivieren. */
 	IEN( SCI2, RXI2 ) = 0;
 	SCI2.SCR.BIT.RIE = 0;
@@ -184,6 +188,10 @@ void INT_Excep_SCI2_RXI2(void)
 		rx_fifo[rx_wr_index] = x;
 		rx_wr_index = (rx_wr_index + 1) %  RX_BUFFER_LENGTH; // circular fifo
 		rx_fifo_used_bytes++;
+		if((rx_fifo_used_bytes == 1) && (rx_sema != NULL))
+		{	// fifo was empty: wake the reader task, see cos_defer.h
+			COS_DeferSemSignalFromISR(rx_sema);
+		}
 	}
 	/* Empfangeninterrupt aktivieren. */
 	SCI2.SCR.BIT.RIE = 1;
@@ -236,6 +244,39 @@ void _initSerialInterface_RX_Interrupt(void)
 		IEN( SCI2, RXI2 ) = 1;
 }
 
+/*!
+ * @brief		Semaphor fuer empfangene Zeichen anmelden
+ *
+ * @details		Die Empfangs-ISR signalisiert den Semaphor ueber die
+ *              Defer-Queue (cos_defer.h), sobald ein Zeichen in den leeren
+ *              Empfangspuffer kommt. Eine Task muss die Schnittstelle dann
+ *              nicht mehr abfragen: sie wartet mit COS_SEM_WAIT() und liest
+ *              danach mit serPollc(), bis -1 kommt. Ein Signal kann auch
+ *              ohne neues Zeichen kommen, dann liefert serPollc() gleich -1.
+ *              NULL meldet den Semaphor ab.
+ *
+ * @param		s		Semaphor, mit COS_SemCreate(s, 0) erzeugt, oder NULL
+ *
+ * @par Code-Beispiel:
+ * @verbatim
+void rxTask(CosTask_t *pt)
+{   static int16_t c;
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_SEM_WAIT(&rxSema,pt);
+        while((c = serPollc()) >= 0)
+        {   _handleChar(c);
+        }
+    }
+    COS_TASK_END(pt);
+}
+  @endverbatim
+ */
+void _setSerialInterface_RX_Semaphore(CosSema_t *s)
+{
+	rx_sema = s;
+}
+
 
 #else
 
@@ -127,6 +127,13 @@ _PowerON_Reset:
     NOP
 #endif
 
+	/* Mit den P-Tasks von COS laeuft auch main( ) auf dem
+	   USP, die ISRs bleiben auf dem ISP (siehe cos_preempt.h).
+	   SETPSW U = R0 ist ab jetzt der USP. */
+#if COS_PREEMPT_IS_PRESENT
+    SETPSW		U
+#endif
+
 	/* main( ) aufrufen. */
     BSR.A		_main
 
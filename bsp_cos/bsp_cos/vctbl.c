@@ -23,6 +23,9 @@ extern void INT_Excep_SCI2_RXI2( void );	/* In read.c implementiert. */
 extern void vSoftwareInterruptISR( void );
 extern void vTickISR( void );
 # endif
+# if COS_PREEMPT_IS_PRESENT
+extern void INT_Excep_ICU_SWINT( void );	/* In cos_systime.c implementiert. */
+# endif
 #endif
 
 const void * HardwareVectors[] __attribute__ ( ( section( ".fvectors" ) ) ) =
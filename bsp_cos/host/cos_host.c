@@ -0,0 +1,621 @@
+/*!
+ ********************************************************************
+   @file            cos_host.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Virtuelle bzw. reale Uhr fuer cos_systime.h und serielle
+           Eingabe fuer poll_serial_interface.h auf dem Host.
+
+   @par Beschreibung
+   Ersetzt cos_systime.c und read.c des Targets, siehe cos_host.h.
+   Es gibt keine nebenlaeufigen Interrupts: der Tick-Hook und der
+   One-Shot fuer die HR-Timer (CMT1 im Target) werden synchron bei
+   einem Zugriff auf die Uhr aufgerufen. Daher duerfen
+   COS_IRQ_SAVE()/COS_IRQ_RESTORE() im Host-Port leer sein.
+   Die P-Tasks (cos_preempt.h) laufen mit ucontext auf eigenen Stacks,
+   gewechselt wird am Ende einer nachgebildeten ISR oder sofort, wenn
+   eine Task selbst den Wechsel ausloest.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <setjmp.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <ucontext.h>
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "poll_serial_interface.h"
+#include "cos_hrtimer.h"
+#include "cos_defer.h"
+#include "cos_preempt.h"
+
+
+#define MICROSEC_PER_TICK 1000
+
+#if (COS_HOST_CYCLES_PER_TICK != MICROSEC_PER_TICK)
+  #error "host cycles are microseconds"
+#endif
+
+
+/****************************************************************/
+/* private module variables */
+/****************************************************************/
+static uint8_t  clockMode_g = COS_HOST_CLOCK_VIRTUAL;
+static uint64_t virtCycles_g = 0;       /*!< virtuelle Uhr in us */
+static struct timespec realStart_g;     /*!< Nullpunkt der realen Uhr */
+static uint32_t cyclesPerRead_g = 1;    /*!< Kosten eines Uhr-Zugriffs */
+static void (*tickHook_g)(void) = NULL; /*!< nachgebildete Timer-ISR */
+static uint64_t hookTicks_g = 0;        /*!< Ticks, fuer die der Hook lief */
+static uint8_t  inHook_g = 0;
+static jmp_buf  stopJump_g;
+static uint8_t  stopArmed_g = 0;
+static uint64_t stopAt_g = 0;           /*!< Ende des Laufs in us */
+static uint8_t  hrArmed_g = 0;          /*!< 1: nachgebildeter CMT1 laeuft */
+static uint64_t hrArmAt_g = 0;          /*!< Ablauf des CMT1 in us */
+static uint8_t  idleWakeRequest_g = 0;  /*!< siehe _idleWakeRequest() */
+static CosHostIdleStats_t idleStats_g;  /*!< siehe COS_HostGetIdleStats() */
+static CosSema_t *rxSema_g = NULL;      /*!< siehe _setSerialInterface_RX_Semaphore() */
+static uint8_t  rxSignalled_g = 0;      /*!< 1: Signal seit dem letzten leeren Lesen */
+static ucontext_t preemptCtx_g[COS_PREEMPT_MAX_TASKS + 1]; /*!< je Prio, zuletzt der Hintergrund */
+static uint8_t  switchPending_g = 0;    /*!< wie das IR-Flag von SWINT */
+
+
+
+/*---------------------------------------------------------------*/
+static uint64_t _realCycles(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)(((int64_t)(ts.tv_sec - realStart_g.tv_sec) * 1000000000LL +
+                       (ts.tv_nsec - realStart_g.tv_nsec)) / 1000);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert 1, falls auf stdin ein Zeichen bereit liegt.
+
+  @param  keine
+  @retval 1 oder 0
+ ********************************************************************/
+static uint8_t _stdinReady(void)
+{
+    struct pollfd p;
+
+    p.fd = STDIN_FILENO;
+    p.events = POLLIN;
+    return (poll(&p, 1, 0) > 0) ? 1 : 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Taskwechsel der P-Tasks wie INT_Excep_ICU_SWINT() im Target.
+       Der Kontext des Hintergrunds steht hinter denen der P-Tasks,
+       seine Prio ist COS_PREEMPT_MAX_TASKS.
+
+  @param  keine
+  @retval keine
+ ********************************************************************/
+static void _preemptSwitch(void)
+{
+    CosPTask_t *old_pt = _preemptCurrent_pt;
+
+    switchPending_g = 0;
+    _preemptSelectNext();
+    if(_preemptCurrent_pt != old_pt)
+    {   swapcontext(&preemptCtx_g[old_pt->prio], &preemptCtx_g[_preemptCurrent_pt->prio]);
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Ruft fuer jeden neu begonnenen Tick den Tick-Hook auf, danach
+       die ISR der HR-Timer, falls der nachgebildete CMT1 abgelaufen
+       ist, und beendet den Lauf von COS_HostRunScheduler(), sobald dessen Zeit
+       abgelaufen ist.
+
+  @param  now - IN, aktuelle Zeit in us
+  @retval keine
+ ********************************************************************/
+static void _elapse(uint64_t now)
+{
+    uint64_t ticks = now / COS_HOST_CYCLES_PER_TICK;
+
+    if(!inHook_g)
+    {   inHook_g = 1;
+        while(hookTicks_g < ticks)
+        {   hookTicks_g++;
+            if(NULL != tickHook_g)
+            {   tickHook_g();
+            }
+            _preemptTick((CosTicks_t) hookTicks_g);   /* like INT_Excep_CMT0_CMI0() */
+        }
+        if((NULL != rxSema_g) && !rxSignalled_g && _stdinReady())
+        {   /* like the RX ISR: the first character wakes the reader */
+            rxSignalled_g = 1;
+            (void) COS_DeferSemSignalFromISR(rxSema_g);
+        }
+        if(hrArmed_g && (now >= hrArmAt_g))
+        {   hrArmed_g = 0;
+            _hrTimerExpired();   /* like INT_Excep_CMT1_CMI1() */
+        }
+        inHook_g = 0;
+        if(switchPending_g)
+        {   _preemptSwitch();   /* SWINT after the ISRs */
+        }
+    }
+    if(stopArmed_g && (now >= stopAt_g) && _preemptInBackground())
+    {   stopArmed_g = 0;
+        longjmp(stopJump_g, 1);
+    }
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Ein Zugriff auf die Uhr. Die virtuelle Uhr laeuft dabei um
+       cyclesPerRead_g weiter, damit ein Scheduler ohne TICKLESS_IDLE
+       beim Warten auf den naechsten Tick nicht stehen bleibt.
+
+  @param  keine
+  @retval aktuelle Zeit in us
+ ********************************************************************/
+static uint64_t _readClock(void)
+{
+    uint64_t now;
+
+    if(COS_HOST_CLOCK_REALTIME == clockMode_g)
+    {   now = _realCycles();
+    }
+    else
+    {   virtCycles_g += cyclesPerRead_g;
+        now = virtCycles_g;
+    }
+    _elapse(now);
+    return now;
+}
+/*---------------------------------------------------------------*/
+
+
+
+
+/****************************************************************/
+/* cos_systime.h */
+/****************************************************************/
+void _initSystemTime(void)
+{
+    clock_gettime(CLOCK_MONOTONIC, &realStart_g);
+}
+/*-------------------------------------------------------*/
+uint16_t _microSecPerTick(void)
+{   return MICROSEC_PER_TICK;
+}
+/*-------------------------------------------------------*/
+uint16_t _gettime_Ticks(void)
+{   return (uint16_t)(_readClock() / COS_HOST_CYCLES_PER_TICK);
+}
+/*-------------------------------------------------------*/
+CosTicks_t _gettime_Ticks32(void)
+{   return (CosTicks_t)(_readClock() / COS_HOST_CYCLES_PER_TICK);
+}
+/*-------------------------------------------------------*/
+uint64_t _gettime_Ticks64(void)
+{   return _readClock() / COS_HOST_CYCLES_PER_TICK;
+}
+/*-------------------------------------------------------*/
+uint64_t _gettime_MicroSec64(void)
+{   return _readClock();
+}
+/*-------------------------------------------------------*/
+uint16_t _milliSecToTicks(uint16_t milliSec)
+{   uint32_t t_ms;
+
+    t_ms = ((uint32_t) milliSec*1000)/MICROSEC_PER_TICK;
+    if (t_ms<1) t_ms=1;
+    return ((uint16_t) t_ms);
+}
+/*-------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wartet bis zum Beginn des nTicks-ten folgenden Ticks, wie die
+       Target-Version. Die virtuelle Uhr springt Tick fuer Tick dorthin,
+       mit der realen Uhr schlaeft der Prozess. Nach jedem Tick und
+       jedem Ablauf des HR-Timers wird geprueft, ob eine nachgebildete
+       ISR _idleWakeRequest() aufgerufen hat, das beendet das Warten
+       wie ein Interrupt das WAIT.
+
+  @param  nTicks - IN, Anzahl Ticks
+  @retval tatsaechlich vergangene Ticks
+ ********************************************************************/
+uint16_t _idleWaitTicks(uint16_t nTicks)
+{
+    uint64_t now, until, t, step, real;
+    struct timespec ts;
+
+    if(0 == nTicks)
+    {   return 0;
+    }
+    idleStats_g.calls++;
+    if(nTicks > idleStats_g.maxRequest_Ticks)
+    {   idleStats_g.maxRequest_Ticks = nTicks;
+    }
+    if(idleWakeRequest_g)
+    {   idleWakeRequest_g = 0;
+        idleStats_g.early++;
+        return 0;
+    }
+    now = _readClock();
+    until = (now / COS_HOST_CYCLES_PER_TICK + nTicks) * COS_HOST_CYCLES_PER_TICK;
+    t = now;
+    while((t < until) && !idleWakeRequest_g)
+    {   /* up to the next event: tick or HR timer */
+        step = (t / COS_HOST_CYCLES_PER_TICK + 1) * COS_HOST_CYCLES_PER_TICK;
+        if(hrArmed_g && (hrArmAt_g > t) && (hrArmAt_g < step))
+        {   step = hrArmAt_g;
+        }
+        if(COS_HOST_CLOCK_REALTIME == clockMode_g)
+        {   real = _realCycles();
+            if(step > real)
+            {   ts.tv_sec  = (time_t)((step - real) / 1000000ULL);
+                ts.tv_nsec = (long)((step - real) % 1000000ULL) * 1000L;
+                nanosleep(&ts, NULL);
+            }
+            t = _realCycles();
+        }
+        else
+        {   virtCycles_g = step;
+            t = step;
+        }
+        _elapse(t);
+    }
+    if(t < until)
+    {   idleStats_g.early++;
+    }
+    idleWakeRequest_g = 0;
+    nTicks = (uint16_t)(t / COS_HOST_CYCLES_PER_TICK - now / COS_HOST_CYCLES_PER_TICK);
+    idleStats_g.waited_Ticks += nTicks;
+    return nTicks;
+}
+/*-------------------------------------------------------*/
+uint32_t _getCycles(void)
+{   return (uint32_t) _readClock();
+}
+/*-------------------------------------------------------*/
+uint32_t _cyclesAtTick(CosTicks_t t_Ticks)
+{   uint64_t now_Ticks = _readClock() / COS_HOST_CYCLES_PER_TICK;
+
+    return (uint32_t)((now_Ticks - (CosTicks_t)((CosTicks_t)now_Ticks - t_Ticks)) *
+                      COS_HOST_CYCLES_PER_TICK);
+}
+/*-------------------------------------------------------*/
+uint32_t _cyclesToMicroSec(uint32_t cycles)
+{   return cycles;
+}
+/*-------------------------------------------------------*/
+uint32_t _cyclesPerMilliSec(void)
+{   return 1000;
+}
+/*-------------------------------------------------------*/
+uint32_t _microSecToCycles(uint32_t us)
+{   return us;
+}
+/*-------------------------------------------------------*/
+void _idleWakeRequest(void)
+{   idleWakeRequest_g = 1;
+}
+/*-------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Stellt den nachgebildeten CMT1. Anders als im Target gibt es
+       keine Grenze von 16 Bit, die ISR laeuft beim ersten Zugriff auf
+       die Uhr ab dem Ablaufzeitpunkt.
+
+  @param  cycles - IN, Zeit bis zum Interrupt in us
+  @retval keine
+ ********************************************************************/
+void _hrTimerArm(uint32_t cycles)
+{
+    hrArmAt_g = COS_HostGetCycles64() + ((0 == cycles) ? 1 : cycles);
+    hrArmed_g = 1;
+}
+/*-------------------------------------------------------*/
+void _hrTimerStop(void)
+{
+    hrArmed_g = 0;
+}
+/*-------------------------------------------------------*/
+
+
+
+
+/****************************************************************/
+/* cos_preempt.h */
+/****************************************************************/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Legt den Anfangs-Kontext einer P-Task an. Auf dem Host braucht
+       eine P-Task deutlich mehr Stack als im Target, z.B. 4096 Worte,
+       sobald sie printf() o.ae. aufruft.
+
+  @param  t          - IN/OUT, P-Task
+  @param  stack_p    - IN, unteres Ende des Stacks
+  @param  stackWords - IN, Groesse des Stacks in 32 Bit Worten
+  @retval keine
+ ********************************************************************/
+void _preemptInitContext(CosPTask_t *t, uint32_t *stack_p, uint16_t stackWords)
+{
+    ucontext_t *c = &preemptCtx_g[t->prio];
+
+    getcontext(c);
+    c->uc_stack.ss_sp = stack_p;
+    c->uc_stack.ss_size = (size_t) stackWords * sizeof(uint32_t);
+    c->uc_link = NULL;
+    makecontext(c, _preemptTaskStart, 0);
+    t->sp = stack_p + stackWords;
+}
+/*-------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wie im Target: aus einer nachgebildeten ISR erst an deren Ende,
+       sonst sofort.
+ ********************************************************************/
+void _preemptRequestSwitch(void)
+{
+    switchPending_g = 1;
+    if(!inHook_g)
+    {   _preemptSwitch();
+    }
+}
+/*-------------------------------------------------------*/
+
+
+
+
+/****************************************************************/
+/* poll_serial_interface.h, die Ausgabe geht ueber putchar() */
+/****************************************************************/
+void _initSerialInterface_RX_Interrupt(void)
+{
+}
+/*-------------------------------------------------------*/
+int16_t _pollSerialInterface(void)
+{
+    unsigned char c;
+
+    if(!_stdinReady() || (read(STDIN_FILENO, &c, 1) != 1))
+    {   rxSignalled_g = 0;   /* empty: the next character signals again */
+        return -1;
+    }
+    return c;
+}
+/*-------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Wie in read.c: der Semaphor wird signalisiert, sobald auf stdin
+       ein Zeichen bereit liegt und der Leser seit dem letzten Signal
+       einmal -1 gelesen hat. Geprueft wird bei jedem Tick, wie von
+       einer ISR ueber die Defer-Queue.
+
+  @param  s - IN, Semaphor oder NULL
+  @retval keine
+ ********************************************************************/
+void _setSerialInterface_RX_Semaphore(CosSema_t *s)
+{
+    rxSema_g = s;
+    rxSignalled_g = 0;
+}
+/*-------------------------------------------------------*/
+
+
+
+
+/****************************************************************/
+/* cos_host.h */
+/****************************************************************/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Waehlt die Uhr, COS_HOST_CLOCK_VIRTUAL oder
+       COS_HOST_CLOCK_REALTIME. Vor COS_InitTaskList() aufrufen.
+
+  @param  mode - IN, Modus der Uhr
+  @retval keine
+ ********************************************************************/
+void COS_HostSetClockMode(uint8_t mode)
+{
+    clockMode_g = mode;
+    virtCycles_g = 0;
+    hookTicks_g = 0;
+    hrArmed_g = 0;
+    clock_gettime(CLOCK_MONOTONIC, &realStart_g);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Setzt die Zeit in us, um die die virtuelle Uhr bei jedem Zugriff
+       weiterlaeuft (Vorgabe 1). So kostet auch eine Task, die nur
+       rechnet, virtuelle Zeit.
+
+  @param  cycles - IN, Zaehlschritte pro Zugriff, mindestens 1
+  @retval keine
+ ********************************************************************/
+void COS_HostSetCyclesPerRead(uint32_t cycles)
+{
+    cyclesPerRead_g = (0 == cycles) ? 1 : cycles;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Meldet eine Funktion an, die zu Beginn jedes Ticks aufgerufen
+       wird, wie eine Timer-ISR des Targets. NULL meldet sie ab.
+
+  @param  hook - IN, Funktion oder NULL
+  @retval keine
+ ********************************************************************/
+void COS_HostSetTickHook(void (*hook)(void))
+{
+    tickHook_g = hook;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Stellt die virtuelle Uhr vor, z.B. fuer die Rechenzeit einer
+       Task. Mit der realen Uhr wird nur gewartet.
+
+  @param  cycles - IN, Zeit in us
+  @retval keine
+ ********************************************************************/
+void COS_HostAdvanceCycles(uint32_t cycles)
+{
+    uint64_t until;
+
+    if(COS_HOST_CLOCK_REALTIME == clockMode_g)
+    {   until = _realCycles() + cycles;
+        while(_realCycles() < until)
+        {   /* busy, like the task would be */
+        }
+        _elapse(until);
+        return;
+    }
+    virtCycles_g += cycles;
+    _elapse(virtCycles_g);
+}
+/*---------------------------------------------------------------*/
+void COS_HostAdvanceTicks(uint16_t nTicks)
+{
+    COS_HostAdvanceCycles((uint32_t) nTicks * COS_HOST_CYCLES_PER_TICK);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Stellt die virtuelle Uhr auf den Beginn des Ticks t_Ticks, z.B.
+       kurz vor den Ueberlauf der 32 Bit Systemzeit. Nur vor
+       COS_InitTaskList() aufrufen, der Tick-Hook laeuft fuer die
+       uebersprungenen Ticks nicht.
+
+  @param  t_Ticks - IN, neue Zeit in Ticks
+  @retval keine
+ ********************************************************************/
+void COS_HostSetTicks(uint64_t t_Ticks)
+{
+    virtCycles_g = t_Ticks * COS_HOST_CYCLES_PER_TICK;
+    hookTicks_g = t_Ticks;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die Zeit in us ohne Ueberlauf und ohne die Uhr dabei
+       weiterzustellen, z.B. fuer Auswertungen nach einem Lauf.
+
+  @param  keine
+  @retval Zeit in us
+ ********************************************************************/
+uint64_t COS_HostGetCycles64(void)
+{
+    return (COS_HOST_CLOCK_REALTIME == clockMode_g) ? _realCycles()
+                                                     : virtCycles_g;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Liefert die Statistik von _idleWaitTicks() seit dem letzten
+       COS_HostResetIdleStats(), z.B. fuer Tests von TICKLESS_IDLE.
+
+  @param  s - OUT, Statistik
+  @retval keine
+ ********************************************************************/
+void COS_HostGetIdleStats(CosHostIdleStats_t *s)
+{
+    *s = idleStats_g;
+}
+/*---------------------------------------------------------------*/
+void COS_HostResetIdleStats(void)
+{
+    idleStats_g.calls = 0;
+    idleStats_g.early = 0;
+    idleStats_g.waited_Ticks = 0;
+    idleStats_g.maxRequest_Ticks = 0;
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Startet COS_RunScheduler() und kehrt zurueck, sobald maxTicks
+       Ticks vergangen sind oder eine Task COS_HostStopScheduler()
+       aufruft. Danach sind Auswertungen wie COS_PrintTaskList() oder
+       COS_TraceDump() erlaubt, der Scheduler darf aber nicht erneut
+       gestartet werden: die unterbrochene Task steht in keiner Queue
+       mehr. Fuer einen neuen Lauf einen neuen Prozess starten, z.B.
+       mit fork().
+
+  @param  maxTicks - IN, Laufzeit in Ticks
+  @retval vergangene Ticks
+ ********************************************************************/
+uint32_t COS_HostRunScheduler(uint32_t maxTicks)
+{
+    volatile uint64_t start = COS_HostGetCycles64();
+
+    if(0 == setjmp(stopJump_g))
+    {   stopAt_g = start + (uint64_t) maxTicks * COS_HOST_CYCLES_PER_TICK;
+        stopArmed_g = 1;
+        (void) COS_RunScheduler();
+    }
+    stopArmed_g = 0;
+    return (uint32_t)((COS_HostGetCycles64() - start) / COS_HOST_CYCLES_PER_TICK);
+}
+/*---------------------------------------------------------------*/
+/*!
+ ********************************************************************
+  @par Beschreibung
+       Beendet COS_HostRunScheduler() sofort, z.B. aus einer Task
+       heraus, sobald ein Test sein Ergebnis hat.
+
+  @see COS_HostRunScheduler()
+  @param  keine
+  @retval keine
+ ********************************************************************/
+void COS_HostStopScheduler(void)
+{
+    if(stopArmed_g && !_preemptInBackground())
+    {   stopAt_g = 0;   /* a P-task: stop when the scheduler runs again */
+        return;
+    }
+    if(stopArmed_g)
+    {   stopArmed_g = 0;
+        longjmp(stopJump_g, 1);
+    }
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,92 @@
+/*!
+ ********************************************************************
+   @file            cos_host.h
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Virtuelle Uhr und Steuerung des Schedulers auf dem Host
+
+   @section Wie funktioniert der Host-Port?
+                Scheduler, Semaphoren, FIFOs, Trace und die serielle
+                Ausgabe (cos_ser.c) werden unveraendert fuer den Host
+                uebersetzt, mit -DCOS_HOST. Ersetzt werden nur die
+                Module mit Hardware-Zugriff: cos_host.c implementiert
+                cos_systime.h (statt cos_systime.c mit Timer CMT0) und
+                poll_serial_interface.h (statt read.c). cos_ser.c gibt
+                ueber putchar() auf stdout aus.
+
+                Die Uhr laeuft in einem von zwei Modi:
+                - COS_HOST_CLOCK_VIRTUAL (Vorgabe): die Zeit ist ein
+                  Zaehler, ein Tick sind COS_HOST_CYCLES_PER_TICK
+                  Zaehlschritte zu je 1 us. Jeder Zugriff auf die Uhr
+                  kostet COS_HostSetCyclesPerRead() Zaehlschritte,
+                  _idleWaitTicks() springt sofort ans Ende der
+                  Wartezeit. Ein Programmlauf ist damit reproduzierbar,
+                  unabhaengig von der Last des Rechners.
+                - COS_HOST_CLOCK_REALTIME: die Zeit kommt aus
+                  clock_gettime(CLOCK_MONOTONIC), _idleWaitTicks()
+                  schlaeft mit nanosleep().
+
+                Eine mit COS_HostSetTickHook() angemeldete Funktion wird
+                bei jedem Tick aufgerufen, wie eine ISR des Timers.
+                COS_HostRunScheduler() laesst den Scheduler eine
+                begrenzte Zeit laufen und kehrt dann zurueck.
+
+                Uebersetzen und starten: make -C bsp_cos/host run
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+
+#ifndef _cos_host_h_
+#define _cos_host_h_
+
+
+#include "cos_systime.h"
+
+
+/*! Zaehlschritte (us) pro Tick, wie MICROSEC_PER_TICK im Target */
+#define COS_HOST_CYCLES_PER_TICK   1000
+
+#define COS_HOST_CLOCK_VIRTUAL     0   /*!< reproduzierbare Zeit, siehe oben */
+#define COS_HOST_CLOCK_REALTIME    1   /*!< Zeit des Rechners */
+
+
+/*! Statistik von _idleWaitTicks() (nur mit TICKLESS_IDLE), siehe
+    COS_HostGetIdleStats() */
+typedef struct {
+        uint32_t calls;             /*!< Aufrufe mit nTicks > 0 */
+        uint32_t early;             /*!< davon durch _idleWakeRequest() vorzeitig beendet */
+        uint32_t waited_Ticks;      /*!< Summe der tatsaechlich gewarteten Ticks */
+        uint16_t maxRequest_Ticks;  /*!< groesstes nTicks */
+} CosHostIdleStats_t;
+
+
+void     COS_HostSetClockMode(uint8_t mode);
+void     COS_HostSetCyclesPerRead(uint32_t cycles);
+void     COS_HostSetTickHook(void (*hook)(void));
+void     COS_HostAdvanceCycles(uint32_t cycles);
+void     COS_HostAdvanceTicks(uint16_t nTicks);
+void     COS_HostSetTicks(uint64_t t_Ticks);
+void     COS_HostGetIdleStats(CosHostIdleStats_t *s);
+void     COS_HostResetIdleStats(void);
+uint64_t COS_HostGetCycles64(void);
+uint32_t COS_HostRunScheduler(uint32_t maxTicks);
+void     COS_HostStopScheduler(void);
+
+
+#endif
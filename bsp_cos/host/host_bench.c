@@ -0,0 +1,46 @@
+/*!
+ ********************************************************************
+   @file            host_bench.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Startet die Benchmarks aus bench/cos_bench.c auf dem Host.
+
+   @par Beschreibung
+   Die Benchmarks laufen mit der realen Uhr, die Ergebnisse stehen
+   auf stdout, siehe cos_bench.h. Fuer belastbare Werte ohne
+   Sanitizer uebersetzen: make SANITIZE= bench
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_bench.h"
+#include "cos_ser.h"
+
+
+int main(void)
+{
+    COS_HostSetClockMode(COS_HOST_CLOCK_REALTIME);
+    if((0 != COS_InitTaskList()) || (NULL == COS_BenchStart(COS_HostStopScheduler)))
+    {   serPuts("COS_BenchStart failed\r\n");
+        return 1;
+    }
+    (void) COS_HostRunScheduler(0xFFFFFFFFUL);
+    return 0;
+}
@@ -0,0 +1,127 @@
+/*!
+ ********************************************************************
+   @file            host_demo.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Beispiel und Rauchtest fuer den Host-Port: Erzeuger und
+           Verbraucher ueber ein FIFO, eine periodische Task und eine
+           Task, die Rechenzeit verbraucht.
+
+   @par Beschreibung
+   Aufruf: cos_host_demo [-r] [Ticks]
+   -r benutzt die reale Uhr statt der virtuellen. Am Ende werden die
+   Task-Liste, die CPU-Last und die Zaehler der Tasks ausgegeben; mit
+   der virtuellen Uhr ist die Ausgabe bei jedem Lauf gleich.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_data_fifo.h"
+#include "cos_ser.h"
+
+
+static CosFifo_t fifo_g;
+static uint32_t produced_g = 0;
+static uint32_t consumed_g = 0;
+static uint32_t errors_g = 0;
+
+
+
+/*---------------------------------------------------------------*/
+static void producerTask(CosTask_t *pt)
+{
+    static uint32_t x = 0;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   x++;
+        COS_FifoBlockingWriteSingleSlot(pt, &fifo_g, (char *)&x);
+        produced_g++;
+        COS_TASK_PERIODIC(pt, _milliSecToTicks(2));
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void consumerTask(CosTask_t *pt)
+{
+    static uint32_t x, expected = 1;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReadSingleSlot(pt, &fifo_g, (char *)&x);
+        if(x != expected)
+        {   errors_g++;
+        }
+        expected = x + 1;
+        consumed_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void workerTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_HostAdvanceCycles(300);   /* 0.3 ms of "work" */
+        COS_TASK_SLEEP(pt, _milliSecToTicks(1));
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(int argc, char *argv[])
+{
+    uint32_t ticks = 2000;
+    int i;
+
+    for(i = 1; i < argc; i++)
+    {   if(0 == strcmp(argv[i], "-r"))
+        {   COS_HostSetClockMode(COS_HOST_CLOCK_REALTIME);
+        }
+        else
+        {   ticks = (uint32_t) strtoul(argv[i], NULL, 0);
+        }
+    }
+
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    if(0 != COS_FifoCreate(&fifo_g, sizeof(uint32_t), 4))
+    {   serPuts("COS_FifoCreate failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(20, NULL, producerTask);
+    COS_CreateTask(10, NULL, consumerTask);
+    COS_CreateTask(5, NULL, workerTask);
+
+    ticks = COS_HostRunScheduler(ticks);
+
+    COS_PrintTaskList();
+    serPuts("\r\nticks=");     serOutUint32Dec(ticks);
+    serPuts(" load_permille="); serOutUint16Dec(COS_GetCPULoadPermille(COS_LOAD_MID));
+    serPuts(" produced=");     serOutUint32Dec(produced_g);
+    serPuts(" consumed=");     serOutUint32Dec(consumed_g);
+    serPuts(" errors=");       serOutUint32Dec(errors_g);
+    serPuts("\r\n");
+    return (0 == errors_g) ? 0 : 1;
+}
+/*---------------------------------------------------------------*/
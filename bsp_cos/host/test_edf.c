@@ -0,0 +1,191 @@
+/*!
+ ********************************************************************
+   @file            test_edf.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: EDF-Heap der Ready-Queue.
+
+   @par Beschreibung
+   Die Steuer-Task hat keine Deadline und laeuft deshalb erst, wenn
+   keine Task mit Deadline bereit ist. Jede Task des Tests prueft beim
+   Lauf mit _checkSchedulerQueues(), dass jede Task im Heap ihren Index
+   (heapIdx) kennt und nicht vor ihrem Vorgaenger laufen soll.
+   - order: Tasks verschiedener Prioritaet mit Deadlines aus
+     COS_SetTaskDeadline() werden auf einmal bereit, die Uhr steht kurz
+     vor dem Ueberlauf der 32 Bit Systemzeit, ein Teil der absoluten
+     Deadlines liegt dahinter. Sie laufen nach ihrer absoluten
+     Deadline, bei gleicher Deadline nach Prioritaet, die Task ohne
+     Deadline zuletzt.
+   - heap: die Steuer-Task loescht, suspendiert und setzt fort, auch die
+     Wurzel und Tasks aus der Mitte des Heap, und aendert eine
+     Deadline. Nach jedem Schritt muss der Heap stimmen, danach laufen
+     die Tasks wieder nach ihrer Deadline.
+   Nur mit READY_QUEUE_SCHEDULING 1 und EDF_SCHEDULING 1, siehe
+   Makefile. Laeuft mit der virtuellen Uhr, bei einem Fehler endet das
+   Programm mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_ser.h"
+
+
+#if !(READY_QUEUE_SCHEDULING && EDF_SCHEDULING)
+  #error "test_edf needs -DREADY_QUEUE_SCHEDULING=1 -DEDF_SCHEDULING=1, see Makefile"
+#endif
+
+/*! groesste Anzahl Tasks einer Phase */
+#define TEST_MAX_TASKS      7
+/*! Prioritaet der Steuer-Task */
+#define TEST_CTRL_PRIO      20
+/*! Start der Uhr: so viele Ticks vor dem Ueberlauf */
+#define TEST_WRAP_TICKS     10
+
+
+/* order: Prioritaet und Deadline, 0 = keine Deadline */
+static const uint8_t    orderPrio_g[]  = {10, 200, 50, 5, 100, 60};
+static const CosTicks_t orderDl_g[]    = {50, 30, 5, 12, 0, 12};
+static const uint8_t    orderSeq_g[]   = {2, 5, 3, 1, 0, 4};          /*! erwartete Folge */
+/* heap: alle mit Prioritaet 10, der Heap ist danach genau so belegt */
+static const CosTicks_t heapDl_g[]     = {2, 40, 10, 45, 50, 20, 25};
+static const uint8_t    heapSeq_g[]    = {4, 0, 5, 6, 1};             /*! erwartete Folge */
+
+static CosTask_t *task_g[TEST_MAX_TASKS];
+static uint8_t  index_g[TEST_MAX_TASKS];          /*! pData der Tasks */
+static uint8_t  ran_g[TEST_MAX_TASKS];
+static uint8_t  nRan_g;
+static uint8_t  queueErr_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _edfTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    ran_g[nRan_g++] = *(uint8_t *) pt->pData;
+    if(!_checkSchedulerQueues())
+    {   queueErr_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _create(uint8_t i, uint8_t prio, CosTicks_t deadline_Ticks)
+{
+    index_g[i] = i;
+    task_g[i] = COS_CreateTask(prio, &index_g[i], _edfTask);
+    if(0 != deadline_Ticks)
+    {   COS_SetTaskDeadline(task_g[i], deadline_Ticks);
+    }
+}
+/*---------------------------------------------------------------*/
+static uint8_t _ranInOrder(const uint8_t *seq, uint8_t n)
+{
+    uint8_t i;
+
+    for(i = 0; (i < nRan_g) && (ran_g[i] == seq[i]); i++)
+    {
+    }
+    return (uint8_t)((n == nRan_g) && (n == i));
+}
+/*---------------------------------------------------------------*/
+static void _heapOps(void)
+{
+    COS_DeleteTask(task_g[3]);               /* d=45: the last one, d=25, moves up */
+    _check(_checkSchedulerQueues(), "delete from the middle");
+    COS_SuspendTask(task_g[2]);              /* d=10 */
+    _check(_checkSchedulerQueues(), "suspend");
+    COS_SuspendTask(task_g[0]);              /* d=2, the root */
+    _check(_checkSchedulerQueues(), "suspend the root");
+    COS_DeleteTask(task_g[2]);
+    _check(_checkSchedulerQueues(), "delete a suspended task");
+    COS_SetTaskDeadline(task_g[4], 1);       /* d=50 -> 1 */
+    _check(_checkSchedulerQueues(), "new deadline of a ready task");
+    COS_ResumeTask(task_g[0]);               /* new job: now + 2 */
+    _check(_checkSchedulerQueues(), "resume");
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static CosTicks_t t0_Ticks;
+    static uint8_t i;
+
+    COS_TASK_BEGIN(pt);
+
+    /* order */
+    COS_TASK_SLEEP(pt, 1);        /* phases begin at the start of a tick */
+    t0_Ticks = _gettime_Ticks32();
+    nRan_g = 0;
+    for(i = 0; i < sizeof(orderPrio_g); i++)
+    {   _create(i, orderPrio_g[i], orderDl_g[i]);
+    }
+    COS_TASK_SLEEP(pt, 1);
+    serPuts("order\r\n");
+    _check(((CosTicks_t)(t0_Ticks + orderDl_g[2]) > t0_Ticks) &&
+           ((CosTicks_t)(t0_Ticks + orderDl_g[3]) < t0_Ticks),
+           "deadlines before and after the overflow");
+    _check(_ranInOrder(orderSeq_g, sizeof(orderSeq_g)),
+           "earliest deadline first, then prio, no deadline last");
+
+    /* heap */
+    COS_TASK_SLEEP(pt, 1);
+    serPuts("heap\r\n");
+    nRan_g = 0;
+    for(i = 0; i < sizeof(heapDl_g) / sizeof(heapDl_g[0]); i++)
+    {   _create(i, 10, heapDl_g[i]);
+    }
+    _check(_checkSchedulerQueues(), "insert");
+    _heapOps();
+    COS_TASK_SLEEP(pt, 1);
+    _check(_ranInOrder(heapSeq_g, sizeof(heapSeq_g)), "remaining tasks by deadline");
+    _check(0 == queueErr_g, "heap right at every dispatch");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    COS_HostSetTicks(0x100000000ULL - TEST_WRAP_TICKS);
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_CTRL_PRIO, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("edf: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
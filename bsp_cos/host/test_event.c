@@ -0,0 +1,262 @@
+/*!
+ ********************************************************************
+   @file            test_event.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: mehrere Wartende an Event-Flags und Mailbox.
+
+   @par Beschreibung
+   - event_clear: vier Tasks warten mit COS_EVENT_CLEAR auf dasselbe
+     Flag, eine Task setzt es jeden Tick einmal, mitten im Tick. Jedes
+     Setzen weckt genau eine Task, reihum in der Reihenfolge der
+     Warteliste.
+   - event_all: drei Tasks warten ohne COS_EVENT_CLEAR, ein Setzen
+     weckt alle drei.
+   - mbox: drei Sender und drei Empfaenger tauschen Nachrichten ueber
+     eine Mailbox. Alle Nachrichten kommen genau einmal an.
+   Jede wartende Task muss nach hoechstens TEST_MAX_LATENCY
+   Zaehlschritten (us) weiterlaufen. Eine Task, die jeden Tick
+   nachfragt, statt in der Warteliste zu warten, kaeme erst beim
+   naechsten Tick dran: die Steuer-Task hat deshalb eine niedrigere
+   Prioritaet als die Wartenden und setzt erst mitten im Tick.
+   Laeuft mit der virtuellen Uhr, bei einem Fehler endet das Programm
+   mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_event.h"
+#include "cos_ser.h"
+
+
+#define TEST_WAITERS        4    /*!< event_clear: Tasks an einem Flag */
+#define TEST_SETS           100  /*!< event_clear: Anzahl Setzen */
+#define TEST_ALL_WAITERS    3    /*!< event_all: Tasks ohne CLEAR */
+#define TEST_MBOX_TASKS     3    /*!< mbox: Sender und Empfaenger */
+#define TEST_MSGS           100  /*!< mbox: Nachrichten pro Sender */
+/*! laengste erlaubte Wartezeit nach Setzen bzw. Senden, ein Viertel Tick */
+#define TEST_MAX_LATENCY    (COS_HOST_CYCLES_PER_TICK / 4)
+
+#define EV_CLEAR_BIT        0x1UL
+#define EV_ALL_BIT          0x80000000UL
+
+
+static CosEvent_t ev_g;
+static CosMailbox_t mbox_g;
+static uint8_t  index_g[TEST_WAITERS];
+
+/* event_clear */
+static uint32_t setCycles_g;        /*! Zeitpunkt des letzten Setzens */
+static uint32_t maxLatency_g;       /*! laengste Wartezeit der Phase */
+static uint16_t sets_g, wakes_g;
+static uint16_t lastSet_g[TEST_WAITERS];  /*! Setzen beim letzten Wecken */
+static uint16_t orderErr_g, extraErr_g;
+
+/* event_all */
+static uint8_t  allWoken_g;
+
+/* mbox */
+static uint32_t sent_g, received_g, sum_g;
+static uint32_t seen_g[TEST_MBOX_TASKS];   /*! letzte Nachricht je Sender */
+static uint32_t waitStart_g[2 * TEST_MBOX_TASKS];  /*! Beginn POST bzw. PEND */
+static uint16_t mboxOrderErr_g;
+
+static uint8_t failed_g = 0;
+
+
+
+/*---------------------------------------------------------------*/
+static void _latency(uint32_t since)
+{
+    uint32_t dt = _getCycles() - since;
+
+    if(dt > maxLatency_g)
+    {   maxLatency_g = dt;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _clearWaiter(CosTask_t *pt)
+{
+    static uint32_t got[TEST_WAITERS];
+    uint8_t me = *(uint8_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_EVENT_WAIT(&ev_g, EV_CLEAR_BIT, COS_EVENT_ANY | COS_EVENT_CLEAR, got[me], pt);
+        wakes_g++;
+        if(wakes_g > sets_g)
+        {   extraErr_g++;
+        }
+        /* FIFO: every waiter again after TEST_WAITERS sets */
+        if((0 != lastSet_g[me]) && (sets_g - lastSet_g[me] != TEST_WAITERS))
+        {   orderErr_g++;
+        }
+        lastSet_g[me] = sets_g;
+        _latency(setCycles_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _allWaiter(CosTask_t *pt)
+{
+    static uint32_t got[TEST_ALL_WAITERS];
+    uint8_t me = *(uint8_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    COS_EVENT_WAIT(&ev_g, EV_ALL_BIT, COS_EVENT_ANY, got[me], pt);
+    allWoken_g++;
+    _latency(setCycles_g);
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _sender(CosTask_t *pt)
+{
+    static uint32_t n[TEST_MBOX_TASKS];
+    static void *msg[TEST_MBOX_TASKS];
+    uint8_t me = *(uint8_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    for(n[me] = 1; n[me] <= TEST_MSGS; n[me]++)
+    {   msg[me] = (void *)(uintptr_t)(me * 1000 + n[me]);
+        waitStart_g[me] = _getCycles();
+        COS_MBOX_POST(&mbox_g, msg[me], pt);
+        _latency(waitStart_g[me]);
+        sent_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _receiver(CosTask_t *pt)
+{
+    static void *msg[TEST_MBOX_TASKS];
+    uint8_t me = *(uint8_t *) pt->pData;
+    uint32_t v, from;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   waitStart_g[TEST_MBOX_TASKS + me] = _getCycles();
+        COS_MBOX_PEND(&mbox_g, msg[me], pt);
+        if(sent_g > 0)   /* the first wait is for the senders to start */
+        {   _latency(waitStart_g[TEST_MBOX_TASKS + me]);
+        }
+        v = (uint32_t)(uintptr_t) msg[me];
+        from = v / 1000;
+        if((from >= TEST_MBOX_TASKS) || (v % 1000 != seen_g[from] + 1))
+        {   mboxOrderErr_g++;
+        }
+        else
+        {   seen_g[from]++;
+        }
+        received_g++;
+        sum_g += v;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static uint8_t i;
+    uint32_t sum = 0;
+
+    COS_TASK_BEGIN(pt);
+    COS_TASK_SLEEP(pt, 1);   /* all waiters queued */
+
+    /* event_clear */
+    for(sets_g = 1; sets_g <= TEST_SETS; sets_g++)
+    {   COS_HostAdvanceCycles(COS_HOST_CYCLES_PER_TICK / 2);   /* mid-tick */
+        setCycles_g = _getCycles();
+        COS_EventSet(&ev_g, EV_CLEAR_BIT);
+        COS_TASK_SLEEP(pt, 1);
+    }
+    sets_g = TEST_SETS;
+    serPuts("event_clear\r\n");
+    _check(wakes_g == TEST_SETS, "one wake-up per set");
+    _check(0 == extraErr_g, "no extra wake-up");
+    _check(0 == orderErr_g, "waiters served in queue order");
+    _check(maxLatency_g <= TEST_MAX_LATENCY, "woken right after the set");
+
+    /* event_all */
+    maxLatency_g = 0;
+    COS_HostAdvanceCycles(COS_HOST_CYCLES_PER_TICK / 2);
+    setCycles_g = _getCycles();
+    COS_EventSet(&ev_g, EV_ALL_BIT);
+    COS_TASK_SLEEP(pt, 1);
+    serPuts("event_all\r\n");
+    _check(TEST_ALL_WAITERS == allWoken_g, "all waiters woken");
+    _check(maxLatency_g <= TEST_MAX_LATENCY, "woken right after the set");
+
+    /* mbox */
+    maxLatency_g = 0;
+    for(i = 0; i < TEST_MBOX_TASKS; i++)   /* senders first: they queue up */
+    {   COS_CreateTask(5, &index_g[i], _sender);
+    }
+    for(i = 0; i < TEST_MBOX_TASKS; i++)
+    {   COS_CreateTask(5, &index_g[i], _receiver);
+    }
+    COS_TASK_SLEEP(pt, 20);
+    for(i = 0; i < TEST_MBOX_TASKS; i++)
+    {   sum += i * 1000 * TEST_MSGS + TEST_MSGS * (TEST_MSGS + 1) / 2;
+    }
+    serPuts("mbox\r\n");
+    _check(TEST_MBOX_TASKS * TEST_MSGS == sent_g, "all messages sent");
+    _check(TEST_MBOX_TASKS * TEST_MSGS == received_g, "all messages received");
+    _check((sum == sum_g) && (0 == mboxOrderErr_g), "each message once, in order per sender");
+    _check(maxLatency_g <= TEST_MAX_LATENCY, "no task waits for a tick");
+
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    uint8_t i;
+
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_EventInit(&ev_g);
+    COS_MboxInit(&mbox_g);
+    for(i = 0; i < TEST_WAITERS; i++)
+    {   index_g[i] = i;
+        COS_CreateTask(10, &index_g[i], _clearWaiter);
+    }
+    for(i = 0; i < TEST_ALL_WAITERS; i++)
+    {   COS_CreateTask(10, &index_g[i], _allWaiter);
+    }
+    COS_CreateTask(5, NULL, _ctrlTask);   /* below the waiters: they look first */
+    COS_HostRunScheduler(1000);
+    if(0 == received_g)
+    {   serPuts("event: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
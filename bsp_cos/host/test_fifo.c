@@ -0,0 +1,270 @@
+/*!
+ ********************************************************************
+   @file            test_fifo.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: offene Slots von Reserve/Commit und Peek/Release.
+
+   @par Beschreibung
+   - protocol: Schritt fuer Schritt ohne Blockieren. Commit und Release
+     ohne offenen Slot liefern -1, ein zweites Reserve bzw. Peek NULL.
+     Was waehrend eines offenen Reserve geschrieben wird, liegt hinter
+     dem reservierten Slot und ist erst nach dem Commit lesbar. Was
+     hinter einem offenen Peek gelesen wird, gibt erst das Release
+     frei, der offene Slot wird nicht ueberschrieben.
+   - mixed: zwei Erzeuger (Reserve/Commit, Einzel- und Mehrfach-
+     Schreiben) und zwei Verbraucher (Peek/Release, Einzel-Lesen)
+     teilen sich ein FIFO, teils mit Schlafen zwischen Reserve und
+     Commit bzw. Peek und Release. Jede Nachricht kommt genau einmal
+     an, die eines Erzeugers in ihrer Reihenfolge.
+   Laeuft mit der virtuellen Uhr, bei einem Fehler endet das Programm
+   mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_data_fifo.h"
+#include "cos_ser.h"
+
+
+/*! protocol: Slots im FIFO */
+#define TEST_SLOTS          4
+/*! mixed: Slots im FIFO, keine Zweierpotenz */
+#define TEST_MIXED_SLOTS    5
+/*! mixed: Nachrichten pro Erzeuger */
+#define TEST_MSGS           2000
+/*! mixed: Erzeuger, die Nachricht traegt seine Nummer */
+#define TEST_PRODUCERS      2
+
+
+/*! Inhalt eines Slots */
+typedef struct {
+        uint32_t from;      /*!< Nummer des Erzeugers */
+        uint32_t seq;       /*!< laufende Nummer beim Erzeuger */
+        uint32_t check;     /*!< ~seq, erkennt halb geschriebene Slots */
+} TestMsg_t;
+
+
+static CosFifo_t fifo_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+/* mixed */
+static uint32_t sent_g[TEST_PRODUCERS];
+static uint32_t expect_g[TEST_PRODUCERS];   /*! naechste seq je Erzeuger */
+static uint32_t received_g;
+static uint16_t orderErr_g;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _fill(TestMsg_t *m, uint32_t from, uint32_t seq)
+{
+    m->from = from;
+    m->seq = seq;
+    m->check = ~seq;
+}
+/*---------------------------------------------------------------*/
+/* mixed: the slot a consumer just got must be the next of its producer */
+static void _consume(TestMsg_t *m)
+{
+    if((m->from >= TEST_PRODUCERS) || (m->seq != expect_g[m->from]) || (m->check != ~m->seq))
+    {   orderErr_g++;
+    }
+    else
+    {   expect_g[m->from]++;
+    }
+    received_g++;
+}
+/*---------------------------------------------------------------*/
+static void _protocol(void)
+{
+    TestMsg_t *p, *p2;
+    TestMsg_t buf[TEST_SLOTS];
+    uint8_t ok;
+
+    serPuts("protocol\r\n");
+    COS_FifoCreate(&fifo_g, sizeof(TestMsg_t), TEST_SLOTS);
+    ok = (-1 == COS_FifoCommit(&fifo_g)) && (-1 == COS_FifoRelease(&fifo_g));
+    serPuts("\r\n");   /* after the debug messages */
+    _check(ok, "commit and release without an open slot fail");
+
+    /* write side */
+    p = (TestMsg_t *) COS_FifoTryReserve(&fifo_g);
+    _check((NULL != p) && (NULL == COS_FifoTryReserve(&fifo_g)), "one reserved slot at a time");
+    _fill(&buf[0], 0, 1);
+    _fill(&buf[1], 0, 2);
+    _check(2 == COS_FifoWriteMany(&fifo_g, buf, 2), "writes go on while a slot is reserved");
+    _check((NULL == COS_FifoTryPeek(&fifo_g)) && (0 == COS_FifoReadMany(&fifo_g, buf, 1)),
+           "nothing readable before the commit");
+    _fill(p, 0, 0);
+    _check((0 == COS_FifoCommit(&fifo_g)) && (3 == COS_FifoGetUsedSlots(&fifo_g)), "commit");
+    _check((1 == COS_FifoReadMany(&fifo_g, buf, 1)) && (0 == buf[0].seq),
+           "reserved slot first, then the ones written behind it");
+
+    /* read side: open slot seq 1, seq 2 is read behind it */
+    p = (TestMsg_t *) COS_FifoTryPeek(&fifo_g);
+    _check((NULL != p) && (1 == p->seq) && (NULL == COS_FifoTryPeek(&fifo_g)), "one open peek at a time");
+    _check((1 == COS_FifoReadMany(&fifo_g, buf, 1)) && (2 == buf[0].seq), "reads go on behind the open slot");
+    _fill(&buf[0], 0, 3);
+    _fill(&buf[1], 0, 4);
+    _fill(&buf[2], 0, 5);
+    _check(2 == COS_FifoWriteMany(&fifo_g, buf, 3), "slots read behind it stay taken");
+    _check(1 == p->seq, "open slot not overwritten");
+    _check(0 == COS_FifoRelease(&fifo_g), "release");
+    _check(1 == COS_FifoWriteMany(&fifo_g, &buf[2], 1), "release frees the slots behind it, too");
+    p2 = (TestMsg_t *) COS_FifoTryReserve(&fifo_g);
+    _check(NULL != p2, "reserve after release");
+    _fill(p2, 0, 6);
+    COS_FifoCommit(&fifo_g);
+    _check((4 == COS_FifoReadMany(&fifo_g, buf, TEST_SLOTS)) && (3 == buf[0].seq) &&
+           (6 == buf[3].seq), "all in order");
+    _check((0 == COS_FifoGetUsedSlots(&fifo_g)) && (0 == fifo_g.rSema.count) &&
+           (TEST_SLOTS == fifo_g.wSema.count), "empty afterwards");
+    COS_FifoDestroy(&fifo_g);
+}
+/*---------------------------------------------------------------*/
+/* mixed: reserve/commit, sometimes sleeps with the slot reserved */
+static void _reserveTask(CosTask_t *pt)
+{
+    static TestMsg_t *p;
+
+    COS_TASK_BEGIN(pt);
+    while(sent_g[0] < TEST_MSGS)
+    {   COS_FifoBlockingReserve(pt, &fifo_g, p);
+        p->from = 0;
+        p->seq = sent_g[0];
+        if(0 == sent_g[0] % 7)
+        {   COS_TASK_SLEEP(pt, 1);
+        }
+        p->check = ~sent_g[0];
+        COS_FifoCommit(&fifo_g);
+        sent_g[0]++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* mixed: copies, single slots and batches of three */
+static void _copyTask(CosTask_t *pt)
+{
+    static TestMsg_t m[3];
+    static CosFifoIndex_t cnt;
+
+    COS_TASK_BEGIN(pt);
+    while(sent_g[1] + 3 <= TEST_MSGS)
+    {   _fill(&m[0], 1, sent_g[1]);
+        if(sent_g[1] % 2)
+        {   COS_FifoBlockingWriteSingleSlot(pt, &fifo_g, &m[0]);
+            sent_g[1]++;
+        }
+        else
+        {   _fill(&m[1], 1, sent_g[1] + 1);
+            _fill(&m[2], 1, sent_g[1] + 2);
+            COS_FifoBlockingWriteMany(pt, &fifo_g, m, 3, cnt);
+            sent_g[1] += 3;
+        }
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* mixed: peek/release, sometimes sleeps with the slot open */
+static void _peekTask(CosTask_t *pt)
+{
+    static TestMsg_t *p;
+    static uint32_t n;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingPeek(pt, &fifo_g, p);
+        _consume(p);
+        if(0 == ++n % 5)
+        {   COS_TASK_SLEEP(pt, 1);
+        }
+        if(p->check != ~p->seq)   /* still intact after the sleep */
+        {   orderErr_g++;
+        }
+        COS_FifoRelease(&fifo_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* mixed: single slot copies */
+static void _readTask(CosTask_t *pt)
+{
+    static TestMsg_t m;
+
+    COS_TASK_BEGIN(pt);
+    while(1)
+    {   COS_FifoBlockingReadSingleSlot(pt, &fifo_g, &m);
+        _consume(&m);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    _protocol();
+
+    COS_FifoCreate(&fifo_g, sizeof(TestMsg_t), TEST_MIXED_SLOTS);
+    COS_CreateTask(5, NULL, _reserveTask);
+    COS_CreateTask(5, NULL, _copyTask);
+    COS_CreateTask(5, NULL, _peekTask);
+    COS_CreateTask(5, NULL, _readTask);
+    while((sent_g[0] < TEST_MSGS) || (sent_g[1] + 3 <= TEST_MSGS) ||
+          (received_g < sent_g[0] + sent_g[1]))
+    {   COS_TASK_SLEEP(pt, 10);
+    }
+    serPuts("mixed\r\n");
+    _check((TEST_MSGS == expect_g[0]) && (sent_g[1] == expect_g[1]), "every message once");
+    _check(0 == orderErr_g, "in order per producer, slots intact");
+    _check((0 == COS_FifoGetUsedSlots(&fifo_g)) && !fifo_g.wOpen && !fifo_g.rOpen &&
+           (TEST_MIXED_SLOTS == fifo_g.wSema.count), "empty afterwards");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(20, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("fifo: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,350 @@
+/*!
+ ********************************************************************
+   @file            test_mutex.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Mutex mit Prioritaetsvererbung.
+
+   @par Beschreibung
+   - inversion: eine niedrige Task haelt die Sperre ueber mehrere
+     COS_TASK_SCHEDULE(), eine mittlere rechnet in Schueben von
+     TEST_BURST_TICKS Ticks, eine hohe will die Sperre jeden Tick.
+     Gemessen wird, wie lange die hohe Task auf die Sperre wartet. Mit
+     einem Semaphor muss das mindestens ein Schub sein (sonst zeigt
+     der Aufbau keine Inversion), mit dem Mutex weniger als ein Schub.
+   - nested: low sperrt A geschachtelt, mid sperrt B und wartet auf A,
+     high wartet auf B. low erbt ueber die Kette die Prioritaet von
+     high, nach der Freigabe bekommen mid und dann high ihre Mutexe
+     und alle fallen auf ihre eigene Prioritaet zurueck.
+   - setprio: COS_SetTaskPrio() auf die Wartende hebt den Besitzer mit
+     an, auf den Besitzer aendert sie nur seine eigene Prioritaet, die
+     geerbte bleibt bis zur Freigabe.
+   - delete: COS_DeleteTask() auf den Besitzer uebergibt den Mutex an
+     die Wartende, die dann laeuft. Auf eine Wartende am Ende einer
+     Kette traegt sie aus der Warteliste aus, die Besitzer davor fallen
+     auf die Prioritaet zurueck, die ihnen ohne sie zusteht.
+   Setzt prioritaetsbasiertes Scheduling voraus (PRIO_BASED_SCHEDULING
+   in cos_scheduler.c). Laeuft mit der virtuellen Uhr, bei einem Fehler
+   endet das Programm mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_semaphore.h"
+#include "cos_ser.h"
+
+
+/*! inversion: Laenge eines Schubs der mittleren Task */
+#define TEST_BURST_TICKS    4
+/*! inversion: ein Schub in Zaehlschritten (us) */
+#define TEST_BURST_US       (TEST_BURST_TICKS * COS_HOST_CYCLES_PER_TICK)
+/*! inversion: so oft gibt die niedrige Task ab, waehrend sie sperrt */
+#define TEST_HOLD_YIELDS    20
+/*! inversion: Dauer einer Messung */
+#define TEST_WINDOW_TICKS   100
+/*! Prioritaet der Steuer-Task, ueber allen anderen */
+#define TEST_CTRL_PRIO      30
+
+
+static CosSema_t sem_g;
+static CosMutex_t mutexA_g, mutexB_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+/* inversion */
+static uint8_t  useMutex_g;
+static uint8_t  stop_g;               /*! beendet die Tasks der Messung */
+static uint32_t maxBlocked_g;         /*! laengste Wartezeit von high in us */
+static uint16_t highLocks_g;
+
+/* nested, setprio */
+static CosTask_t *low_g, *mid_g, *high_g;
+static uint8_t  release_g;            /*! Besitzer gibt frei */
+static uint8_t  nestOk_g;
+static uint8_t  order_g[2], nOrder_g;
+static uint8_t  prioAfter_g[3];       /*! Prioritaet nach der Freigabe */
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+/* inversion: lowest prio, holds the lock across yields */
+static void _holderTask(CosTask_t *pt)
+{
+    static uint8_t n;
+
+    COS_TASK_BEGIN(pt);
+    while(!stop_g)
+    {   if(useMutex_g)
+        {   COS_MUTEX_LOCK(&mutexA_g, pt);
+        }
+        else
+        {   COS_SEM_WAIT(&sem_g, pt);
+        }
+        for(n = 0; n < TEST_HOLD_YIELDS; n++)
+        {   COS_HostAdvanceCycles(5);
+            COS_TASK_SCHEDULE(pt);
+        }
+        if(useMutex_g)
+        {   COS_MutexUnlock(&mutexA_g, pt);
+        }
+        else
+        {   COS_SEM_SIGNAL(&sem_g);
+        }
+        COS_TASK_SCHEDULE(pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* inversion: medium prio, computes in bursts */
+static void _burstTask(CosTask_t *pt)
+{
+    static CosTicks_t until;
+
+    COS_TASK_BEGIN(pt);
+    while(!stop_g)
+    {   COS_TASK_SLEEP(pt, TEST_BURST_TICKS / 2);
+        until = _gettime_Ticks32() + TEST_BURST_TICKS;
+        while((int32_t)(until - _gettime_Ticks32()) > 0)
+        {   COS_HostAdvanceCycles(20);
+            COS_TASK_SCHEDULE(pt);
+        }
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* inversion: highest prio, takes the lock every tick */
+static void _waiterTask(CosTask_t *pt)
+{
+    static uint32_t t0;
+    uint32_t blocked;
+
+    COS_TASK_BEGIN(pt);
+    while(!stop_g)
+    {   t0 = _getCycles();
+        if(useMutex_g)
+        {   COS_MUTEX_LOCK(&mutexA_g, pt);
+        }
+        else
+        {   COS_SEM_WAIT(&sem_g, pt);
+        }
+        blocked = _getCycles() - t0;
+        if(blocked > maxBlocked_g)
+        {   maxBlocked_g = blocked;
+        }
+        highLocks_g++;
+        if(useMutex_g)
+        {   COS_MutexUnlock(&mutexA_g, pt);
+        }
+        else
+        {   COS_SEM_SIGNAL(&sem_g);
+        }
+        COS_TASK_SLEEP(pt, 1);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* nested: low locks A twice, unlocks once, holds it until release_g */
+static void _lowTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    COS_MUTEX_LOCK(&mutexA_g, pt);
+    COS_MUTEX_LOCK(&mutexA_g, pt);
+    if((0 == COS_MutexUnlock(&mutexA_g, pt)) && (pt == COS_MutexGetOwner(&mutexA_g)))
+    {   nestOk_g = 1;
+    }
+    if(-1 != COS_MutexUnlock(&mutexB_g, pt))   /* not the owner */
+    {   nestOk_g = 0;
+    }
+    while(!release_g)
+    {   COS_TASK_SLEEP(pt, 1);
+    }
+    COS_MutexUnlock(&mutexA_g, pt);
+    prioAfter_g[0] = pt->prio;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* nested: mid holds B while it waits for A */
+static void _midTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    COS_MUTEX_LOCK(&mutexB_g, pt);
+    COS_MUTEX_LOCK(&mutexA_g, pt);
+    order_g[nOrder_g++] = 1;
+    COS_MutexUnlock(&mutexA_g, pt);
+    COS_MutexUnlock(&mutexB_g, pt);
+    prioAfter_g[1] = pt->prio;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* nested: high waits for B, setprio: waits for A */
+static void _highTask(CosTask_t *pt)
+{
+    CosMutex_t *m = (CosMutex_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    COS_MUTEX_LOCK(m, pt);
+    m = (CosMutex_t *) pt->pData;   /* locals are lost across the wait */
+    order_g[nOrder_g++] = 2;
+    COS_MutexUnlock(m, pt);
+    prioAfter_g[2] = pt->prio;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static uint32_t semBlocked;
+
+    COS_TASK_BEGIN(pt);
+
+    /* inversion, first with the semaphore, then with the mutex */
+    for(useMutex_g = 0; useMutex_g < 2; useMutex_g++)
+    {   COS_SemCreate(&sem_g, 1);
+        COS_MutexInit(&mutexA_g);
+        stop_g = 0;
+        maxBlocked_g = 0;
+        highLocks_g = 0;
+        COS_CreateTask(1, NULL, _holderTask);
+        COS_CreateTask(2, NULL, _burstTask);
+        COS_CreateTask(3, NULL, _waiterTask);
+        COS_TASK_SLEEP(pt, TEST_WINDOW_TICKS);
+        stop_g = 1;
+        COS_TASK_SLEEP(pt, 2 * TEST_BURST_TICKS);   /* let them end */
+        serPuts(useMutex_g ? "inversion_mutex" : "inversion_sem");
+        serPuts(" max_blocked_us=");   serOutUint32Dec(maxBlocked_g);
+        serPuts(" locks=");            serOutUint16Dec(highLocks_g);
+        serPuts("\r\n");
+        semBlocked = useMutex_g ? semBlocked : maxBlocked_g;
+    }
+    _check(semBlocked >= TEST_BURST_US, "semaphore: high waits for a burst");
+    _check(maxBlocked_g < TEST_BURST_US, "mutex: high waits less than a burst");
+    _check(highLocks_g >= TEST_WINDOW_TICKS / 2, "mutex: high gets the lock every tick");
+
+    /* nested: low(2) holds A, mid(5) holds B and waits for A,
+       high(9) waits for B */
+    COS_MutexInit(&mutexA_g);
+    COS_MutexInit(&mutexB_g);
+    release_g = 0;
+    nOrder_g = 0;
+    serPuts("nested\r\n");
+    low_g = COS_CreateTask(2, NULL, _lowTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check(nestOk_g, "nested lock, one unlock keeps the owner");
+    mid_g = COS_CreateTask(5, NULL, _midTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check(5 == low_g->prio, "owner of A inherits mid's prio");
+    high_g = COS_CreateTask(9, &mutexB_g, _highTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check((9 == mid_g->prio) && (9 == low_g->prio), "high's prio passes along the chain");
+    _check((2 == low_g->basePrio) && (5 == mid_g->basePrio), "basePrio unchanged");
+    release_g = 1;
+    COS_TASK_SLEEP(pt, 2);
+    _check((2 == nOrder_g) && (1 == order_g[0]) && (2 == order_g[1]), "mid, then high get the mutexes");
+    _check((2 == prioAfter_g[0]) && (5 == prioAfter_g[1]) && (9 == prioAfter_g[2]),
+           "everybody back to its own prio");
+    _check((NULL == COS_MutexGetOwner(&mutexA_g)) && (NULL == COS_MutexGetOwner(&mutexB_g)),
+           "mutexes free afterwards");
+
+    /* setprio: low(1) holds A, high(3) waits for it */
+    COS_MutexInit(&mutexA_g);
+    release_g = 0;
+    nOrder_g = 0;
+    serPuts("setprio\r\n");
+    low_g = COS_CreateTask(1, NULL, _lowTask);
+    COS_TASK_SLEEP(pt, 1);
+    high_g = COS_CreateTask(3, &mutexA_g, _highTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check(3 == low_g->prio, "owner boosted");
+    COS_SetTaskPrio(high_g, 12);
+    _check(12 == low_g->prio, "raising the waiter raises the owner");
+    COS_SetTaskPrio(low_g, 20);
+    _check(20 == low_g->prio, "owner's own prio above the inherited one");
+    COS_SetTaskPrio(low_g, 4);
+    _check((12 == low_g->prio) && (4 == low_g->basePrio), "owner lowered, keeps the inherited prio");
+    release_g = 1;
+    COS_TASK_SLEEP(pt, 2);
+    _check((1 == nOrder_g) && (4 == prioAfter_g[0]) && (12 == prioAfter_g[2]),
+           "after the unlock: waiter runs, owner back to its own prio");
+
+    /* delete the owner: low(1) holds A, high(3) waits for it */
+    COS_MutexInit(&mutexA_g);
+    release_g = 0;
+    nOrder_g = 0;
+    serPuts("delete\r\n");
+    low_g = COS_CreateTask(1, NULL, _lowTask);
+    COS_TASK_SLEEP(pt, 1);
+    high_g = COS_CreateTask(3, &mutexA_g, _highTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check(0 == COS_DeleteTask(low_g), "delete the owner");
+    _check(high_g == COS_MutexGetOwner(&mutexA_g), "mutex handed over to the waiter");
+    COS_TASK_SLEEP(pt, 1);
+    _check((1 == nOrder_g) && (NULL == COS_MutexGetOwner(&mutexA_g)), "waiter runs and unlocks");
+
+    /* delete a waiter: low(1) holds A, mid(2) holds B and waits for A,
+       high(6) waits for B */
+    COS_MutexInit(&mutexA_g);
+    COS_MutexInit(&mutexB_g);
+    nOrder_g = 0;
+    low_g = COS_CreateTask(1, NULL, _lowTask);
+    COS_TASK_SLEEP(pt, 1);
+    mid_g = COS_CreateTask(2, NULL, _midTask);
+    COS_TASK_SLEEP(pt, 1);
+    high_g = COS_CreateTask(6, &mutexB_g, _highTask);
+    COS_TASK_SLEEP(pt, 1);
+    _check((6 == mid_g->prio) && (6 == low_g->prio), "chain boosted");
+    _check(0 == COS_DeleteTask(high_g), "delete the waiter");
+    _check((NULL == mutexB_g.root_pt) && (2 == mid_g->prio) && (2 == low_g->prio),
+           "waiter gone, owners back to what they still inherit");
+    release_g = 1;
+    COS_TASK_SLEEP(pt, 2);
+    _check((1 == nOrder_g) && (1 == order_g[0]) && (1 == prioAfter_g[0]) && (2 == prioAfter_g[1]),
+           "after the unlock: mid runs, everybody back to its own prio");
+    _check((NULL == COS_MutexGetOwner(&mutexA_g)) && (NULL == COS_MutexGetOwner(&mutexB_g)),
+           "mutexes free afterwards");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_CTRL_PRIO, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("mutex: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,162 @@
+/*!
+ ********************************************************************
+   @file            test_ready_queue.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Ready-Queue mit Prioritaets-Bitmap.
+
+   @par Beschreibung
+   - order: Tasks mit Prioritaeten aus allen Worten des Bitmap, zwei
+     davon gleich, werden auf einmal bereit. Sie muessen nach fallender
+     Prioritaet drankommen, die gleichen in der Reihenfolge des
+     Erzeugens. Jede Task prueft beim Lauf mit _checkSchedulerQueues(),
+     dass im Bitmap genau die Bits nicht leerer Listen gesetzt sind.
+   - bands: die Steuer-Task leert und fuellt Prioritaetsstufen mit
+     COS_SuspendTask(), COS_SetTaskPrio(), COS_ResumeTask() und
+     COS_DeleteTask(), ohne dass eine der Tasks laeuft. Nach jedem
+     Schritt muss das Bit einer leeren Stufe geloescht sein.
+   Nur mit READY_QUEUE_SCHEDULING 1, siehe Makefile. Laeuft mit der
+   virtuellen Uhr, bei einem Fehler endet das Programm mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_ser.h"
+
+
+#if !READY_QUEUE_SCHEDULING
+  #error "test_ready_queue needs -DREADY_QUEUE_SCHEDULING=1, see Makefile"
+#endif
+
+/*! Prioritaet der Steuer-Task, ueber allen Tasks des Tests ausser 254 */
+#define TEST_CTRL_PRIO      200
+
+
+static const uint8_t prioOf_g[] = {3, 100, 40, 7, 70, 40, 254, 1};   /*! order */
+static const uint8_t order_g[]  = {6, 1, 4, 2, 5, 3, 0, 7};         /*! erwartete Folge */
+
+static uint8_t  index_g[sizeof(prioOf_g)];        /*! pData der Tasks */
+static uint8_t  ran_g[sizeof(prioOf_g)];
+static uint8_t  nRan_g;
+static uint8_t  queueErr_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _orderTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    ran_g[nRan_g++] = *(uint8_t *) pt->pData;
+    if(!_checkSchedulerQueues())
+    {   queueErr_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* bands: must never run, the control task keeps them from it */
+static void _bandTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    queueErr_g++;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _bands(void)
+{
+    CosTask_t *a_pt, *b_pt, *c_pt;
+
+    serPuts("bands\r\n");
+    a_pt = COS_CreateTask(60, NULL, _bandTask);
+    b_pt = COS_CreateTask(60, NULL, _bandTask);
+    c_pt = COS_CreateTask(90, NULL, _bandTask);
+    _check(_checkSchedulerQueues(), "three tasks ready, two bands");
+    COS_SuspendTask(a_pt);
+    _check(_checkSchedulerQueues(), "suspend the first of a band");
+    COS_SuspendTask(b_pt);
+    _check(_checkSchedulerQueues(), "suspend the last of a band");
+    COS_SetTaskPrio(c_pt, 61);
+    _check(_checkSchedulerQueues(), "set prio moves a task to another band");
+    COS_ResumeTask(b_pt);
+    COS_SetTaskPrio(c_pt, 60);
+    _check(_checkSchedulerQueues(), "resume and set prio fill a band again");
+    COS_DeleteTask(b_pt);
+    COS_DeleteTask(c_pt);
+    _check(_checkSchedulerQueues(), "delete the ready tasks of a band");
+    COS_DeleteTask(a_pt);
+    _check(_checkSchedulerQueues(), "delete a suspended task");
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static uint8_t i;
+
+    COS_TASK_BEGIN(pt);
+
+    /* order */
+    for(i = 0; i < sizeof(prioOf_g); i++)
+    {   index_g[i] = i;
+        COS_CreateTask(prioOf_g[i], &index_g[i], _orderTask);
+    }
+    COS_TASK_SLEEP(pt, 1);
+    serPuts("order\r\n");
+    _check(sizeof(prioOf_g) == nRan_g, "every task ran");
+    for(i = 0; (i < nRan_g) && (ran_g[i] == order_g[i]); i++)
+    {
+    }
+    _check(sizeof(prioOf_g) == i, "highest priority first, equal ones in order");
+    _check(0 == queueErr_g, "bitmap matches the ready lists at each dispatch");
+    _check(_checkSchedulerQueues(), "bitmap empty bands cleared");
+
+    _bands();
+    COS_TASK_SLEEP(pt, 1);
+    _check(0 == queueErr_g, "no band task ran");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_CTRL_PRIO, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("ready_queue: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
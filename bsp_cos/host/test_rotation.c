@@ -0,0 +1,160 @@
+/*!
+ ********************************************************************
+   @file            test_rotation.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Tasks gleicher Prioritaet kommen reihum dran.
+
+   @par Beschreibung
+   k Tasks gleicher Prioritaet sind ununterbrochen bereit, eine Task
+   hoeherer Prioritaet unterbricht sie jeden Tick. Fuer jede Task der
+   Stufe wird gezaehlt, wie viele Dispatches anderer Tasks derselben
+   Stufe zwischen zwei eigenen liegen (Dispatch-Abstand), vor dem
+   ersten Lauf ab Beginn der Runde. Bei Rotation ist der Abstand
+   hoechstens k-1, ohne Rotation wartet die zweite Task, bis die erste
+   fertig ist. Ausgegeben wird das Histogramm der Abstaende pro k, bei
+   Verletzung der Grenze endet das Programm mit 1.
+   Ohne Ready-Queue rotiert der Scheduler nur mit
+   FAIR_EQUAL_PRIO_SCHEDULING 1, das Makefile setzt den Schalter.
+   Laeuft mit der virtuellen Uhr, das Ergebnis ist reproduzierbar.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_ser.h"
+
+
+/*! groesstes k, Histogramm hat so viele Klassen */
+#define TEST_MAX_TASKS      16
+/*! Laeufe jeder Task pro k */
+#define TEST_RUNS           200
+/*! Prioritaet der Stufe, die Steuer-Task liegt darueber */
+#define TEST_BAND_PRIO      10
+
+
+static const uint8_t testCounts_g[] = {1, 2, 3, 5, 8, 16};
+
+static uint8_t  nBand_g;                          /*! k der laufenden Runde */
+static uint32_t bandDispatches_g;                 /*! Dispatches der Stufe */
+static uint32_t last_g[TEST_MAX_TASKS];           /*! letzter Dispatch je Task */
+static uint16_t runs_g[TEST_MAX_TASKS];
+static uint32_t hist_g[TEST_MAX_TASKS + 1];       /*! letzte Klasse: >= TEST_MAX_TASKS */
+static uint32_t maxGap_g;
+static uint8_t  index_g[TEST_MAX_TASKS];          /*! pData der Tasks */
+static uint8_t  failed_g = 0;
+static uint8_t  idx_g, i_g;                       /*! Zustand der Steuer-Task */
+
+
+
+/*---------------------------------------------------------------*/
+static void _bandTask(CosTask_t *pt)
+{
+    uint8_t me = *(uint8_t *) pt->pData;
+    uint32_t gap;
+
+    COS_TASK_BEGIN(pt);
+    while(runs_g[me] < TEST_RUNS)
+    {   gap = bandDispatches_g - last_g[me] - 1;
+        hist_g[(gap < TEST_MAX_TASKS) ? gap : TEST_MAX_TASKS]++;
+        if(gap > maxGap_g)
+        {   maxGap_g = gap;
+        }
+        last_g[me] = bandDispatches_g++;
+        runs_g[me]++;
+        COS_HostAdvanceCycles(50);
+        COS_TASK_SCHEDULE(pt);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static uint8_t _bandDone(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < nBand_g; i++)
+    {   if(runs_g[i] < TEST_RUNS)
+        {   return 0;
+        }
+    }
+    return 1;
+}
+/*---------------------------------------------------------------*/
+static void _report(void)
+{
+    uint8_t i;
+
+    serPuts("rotation k=");    serOutUint16Dec(nBand_g);
+    serPuts(" max_gap=");      serOutUint32Dec(maxGap_g);
+    serPuts(" hist=");
+    for(i = 0; i <= TEST_MAX_TASKS; i++)
+    {   serOutUint32Dec(hist_g[i]);
+    }
+    if(maxGap_g > (uint32_t)(nBand_g - 1))
+    {   serPuts("  FAIL: gap > k-1");
+        failed_g = 1;
+    }
+    serPuts("\r\n");
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    for(idx_g = 0; idx_g < sizeof(testCounts_g); idx_g++)
+    {   nBand_g = testCounts_g[idx_g];
+        bandDispatches_g = 0;
+        maxGap_g = 0;
+        for(i_g = 0; i_g <= TEST_MAX_TASKS; i_g++)
+        {   hist_g[i_g] = 0;
+        }
+        for(i_g = 0; i_g < nBand_g; i_g++)
+        {   runs_g[i_g] = 0;
+            last_g[i_g] = (uint32_t) -1;   /* the first wait counts, too */
+            index_g[i_g] = i_g;
+            if(NULL == COS_CreateTask(TEST_BAND_PRIO, &index_g[i_g], _bandTask))
+            {   serPuts("COS_CreateTask failed\r\n");
+                failed_g = 1;
+                COS_HostStopScheduler();
+            }
+        }
+        while(!_bandDone())
+        {   COS_TASK_SLEEP(pt, 1);
+        }
+        COS_TASK_SLEEP(pt, 1);   /* let the band tasks end */
+        _report();
+    }
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_BAND_PRIO + 10, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(idx_g < sizeof(testCounts_g))
+    {   serPuts("rotation: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
@@ -0,0 +1,241 @@
+/*!
+ ********************************************************************
+   @file            test_sem_fifo.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Reihenfolge der Warteliste und Grenze des Zaehlers eines
+           Semaphors.
+
+   @par Beschreibung
+   - fifo: k Tasks gleicher Prioritaet wollen immer wieder denselben
+     Semaphor (COS_SEM_FIFO), halten ihn ueber ein COS_TASK_SCHEDULE()
+     und geben ihn frei. Fuer jede Task wird gezaehlt, wie oft der
+     Semaphor an andere Tasks ging, waehrend sie wartete. Bei FIFO sind
+     das hoechstens k-1 Uebergaben, auch beim ersten Warten. Mit einer
+     LIFO-Liste reichen sich zwei Tasks den Semaphor hin und her, die
+     uebrigen warten bis zum Ende.
+   - prio: vier Tasks mit den Prioritaeten 5, 7, 6, 7 beginnen in
+     dieser Reihenfolge an einem Semaphor mit COS_SEM_PRIO zu warten,
+     die Steuer-Task signalisiert dann einmal pro Tick. Sie muessen in der Reihenfolge 7, 7, 6, 5 drankommen, die
+     beiden mit Prioritaet 7 in der Reihenfolge des Wartens.
+   - limit: COS_SEM_SIGNAL() und COS_SemSignalMany() bleiben bei
+     COS_SEM_COUNT_MAX stehen und liefern -1. Wartende Tasks werden
+     auch dann geweckt, wenn der Zaehler begrenzt wird.
+   Laeuft mit der virtuellen Uhr, bei einem Fehler endet das Programm
+   mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_semaphore.h"
+#include "cos_ser.h"
+
+
+/*! groesstes k */
+#define TEST_MAX_TASKS      8
+/*! Zugriffe jeder Task pro k */
+#define TEST_RUNS           50
+/*! Prioritaet der Tasks in fifo, die Steuer-Task liegt darueber */
+#define TEST_BAND_PRIO      10
+
+
+static const uint8_t testCounts_g[] = {2, 3, 4, 8};
+static const uint8_t prioOf_g[] = {5, 7, 6, 7};      /*! prio: Prioritaeten */
+static const uint8_t prioOrder_g[] = {1, 3, 2, 0};   /*! prio: erwartete Folge */
+
+static CosSema_t sem_g;
+static uint8_t  index_g[TEST_MAX_TASKS];          /*! pData der Tasks */
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+/* fifo */
+static uint8_t  nBand_g;                          /*! k der laufenden Runde */
+static uint32_t handoffs_g;                       /*! Uebergaben des Semaphors */
+static uint32_t waitFrom_g[TEST_MAX_TASKS];       /*! handoffs_g beim Warten */
+static uint16_t runs_g[TEST_MAX_TASKS];
+static uint32_t maxWait_g;                        /*! laengste Wartezeit in Uebergaben */
+static uint8_t  holders_g;                        /*! Tasks, die den Semaphor halten */
+static uint8_t  idx_g, i_g;                       /*! Zustand der Steuer-Task */
+
+/* prio */
+static uint8_t  woken_g[sizeof(prioOf_g)];
+static uint8_t  nWoken_g;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _bandTask(CosTask_t *pt)
+{
+    uint8_t me = *(uint8_t *) pt->pData;
+    uint32_t wait;
+
+    COS_TASK_BEGIN(pt);
+    while(runs_g[me] < TEST_RUNS)
+    {   waitFrom_g[me] = handoffs_g;
+        COS_SEM_WAIT(&sem_g, pt);
+        wait = handoffs_g - waitFrom_g[me];
+        if(wait > maxWait_g)
+        {   maxWait_g = wait;
+        }
+        handoffs_g++;
+        runs_g[me]++;
+        holders_g++;
+        COS_HostAdvanceCycles(50);
+        COS_TASK_SCHEDULE(pt);      /* the others queue up meanwhile */
+        holders_g--;
+        COS_SEM_SIGNAL(&sem_g);
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _prioTask(CosTask_t *pt)
+{
+    uint8_t me = *(uint8_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    COS_SEM_WAIT(&sem_g, pt);
+    woken_g[nWoken_g++] = me;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static uint8_t _bandDone(void)
+{
+    uint8_t i;
+
+    for(i = 0; i < nBand_g; i++)
+    {   if(runs_g[i] < TEST_RUNS)
+        {   return 0;
+        }
+    }
+    return 1;
+}
+/*---------------------------------------------------------------*/
+static void _report(void)
+{
+    serPuts("fifo k=");        serOutUint16Dec(nBand_g);
+    serPuts(" max_wait=");     serOutUint32Dec(maxWait_g);
+    serPuts(" handoffs=");     serOutUint32Dec(handoffs_g);
+    serPuts("\r\n");
+    _check(maxWait_g <= (uint32_t)(nBand_g - 1), "every waiter served within k-1 handoffs");
+    _check(0 == holders_g, "one holder at a time");
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+
+    /* fifo */
+    for(idx_g = 0; idx_g < sizeof(testCounts_g); idx_g++)
+    {   nBand_g = testCounts_g[idx_g];
+        handoffs_g = 0;
+        maxWait_g = 0;
+        COS_SemCreate(&sem_g, 1);
+        for(i_g = 0; i_g < nBand_g; i_g++)
+        {   runs_g[i_g] = 0;
+            index_g[i_g] = i_g;
+            if(NULL == COS_CreateTask(TEST_BAND_PRIO, &index_g[i_g], _bandTask))
+            {   serPuts("COS_CreateTask failed\r\n");
+                failed_g = 1;
+                COS_HostStopScheduler();
+            }
+        }
+        while(!_bandDone())
+        {   COS_TASK_SLEEP(pt, 1);
+            if(holders_g > 1)
+            {   _check(0, "one holder at a time");
+            }
+        }
+        COS_TASK_SLEEP(pt, 1);   /* let the band tasks end */
+        _report();
+        _check((1 == sem_g.count) && (NULL == sem_g.root_pt), "semaphore free afterwards");
+    }
+
+    /* prio */
+    COS_SemCreateOrdered(&sem_g, 0, COS_SEM_PRIO);
+    for(i_g = 0; i_g < sizeof(prioOf_g); i_g++)
+    {   index_g[i_g] = i_g;
+        COS_CreateTask(prioOf_g[i_g], &index_g[i_g], _prioTask);
+        COS_TASK_SLEEP(pt, 1);   /* it waits before the next one comes */
+    }
+    for(i_g = 0; i_g < sizeof(prioOf_g); i_g++)
+    {   COS_SEM_SIGNAL(&sem_g);
+        COS_TASK_SLEEP(pt, 1);
+    }
+    serPuts("prio\r\n");
+    _check(sizeof(prioOf_g) == nWoken_g, "every waiter served");
+    for(i_g = 0; (i_g < nWoken_g) && (woken_g[i_g] == prioOrder_g[i_g]); i_g++)
+    {
+    }
+    _check(sizeof(prioOf_g) == i_g, "highest priority first, equal ones in order");
+
+    /* limit */
+    serPuts("limit\r\n");
+    COS_SemCreate(&sem_g, COS_SEM_COUNT_MAX - 1);
+    _check((0 == COS_SEM_SIGNAL(&sem_g)) && (COS_SEM_COUNT_MAX == sem_g.count), "signal up to the limit");
+    _check((-1 == COS_SEM_SIGNAL(&sem_g)) && (COS_SEM_COUNT_MAX == sem_g.count), "signal at the limit");
+    _check((-1 == COS_SemSignalMany(&sem_g, 1)) && (COS_SEM_COUNT_MAX == sem_g.count),
+           "signal many at the limit");
+    COS_SemCreate(&sem_g, COS_SEM_COUNT_MAX - 3);
+    _check((0 == COS_SemSignalMany(&sem_g, 3)) && (COS_SEM_COUNT_MAX == sem_g.count),
+           "signal many up to the limit");
+    COS_SemCreate(&sem_g, 0);
+    nWoken_g = 0;
+    for(i_g = 0; i_g < 2; i_g++)
+    {   COS_CreateTask(prioOf_g[i_g], &index_g[i_g], _prioTask);
+    }
+    COS_TASK_SLEEP(pt, 1);
+    _check(-2 == sem_g.count, "two waiting");
+    _check(0 == COS_SemSignalMany(&sem_g, COS_SEM_COUNT_MAX), "signal many, the waiters take two");
+    _check((COS_SEM_COUNT_MAX - 2 == sem_g.count) && (NULL == sem_g.root_pt), "both woken");
+    _check((-1 == COS_SemSignalMany(&sem_g, 3)) && (COS_SEM_COUNT_MAX == sem_g.count),
+           "signal many beyond the limit stops there");
+    COS_TASK_SLEEP(pt, 1);
+    _check(2 == nWoken_g, "both ran");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_BAND_PRIO + 10, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("sem_fifo: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
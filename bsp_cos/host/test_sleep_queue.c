@@ -0,0 +1,205 @@
+/*!
+ ********************************************************************
+   @file            test_sleep_queue.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Sleep-Queue (Delta-Liste) der Ready-Queue.
+
+   @par Beschreibung
+   In jeder Phase beginnen mehrere Tasks im selben Tick zu schlafen,
+   jede mit ihrer eigenen Sleep-Zeit. Jede muss genau im Tick
+   Beginn + Sleep-Zeit aufwachen, bei jedem Lauf prueft
+   _checkSchedulerQueues() die Deltas der Sleep-Queue.
+   - wrap: die Uhr startet kurz vor dem Ueberlauf der 32 Bit
+     Systemzeit, die Weckzeiten liegen davor und danach, sleepRef_g
+     laeuft dabei ueber.
+   - equal: drei Tasks mit derselben Weckzeit wachen in der Reihenfolge
+     auf, in der sie eingeschlafen sind.
+   - remove: aus der Mitte der Sleep-Queue wird eine Task geloescht und
+     eine suspendiert, die Nachfolger wachen trotzdem rechtzeitig auf.
+     Die suspendierte Task wird vor ihrer Weckzeit fortgesetzt und
+     wacht ebenfalls genau zu ihrer Weckzeit auf.
+   Nur mit READY_QUEUE_SCHEDULING 1, siehe Makefile. Laeuft mit der
+   virtuellen Uhr, bei einem Fehler endet das Programm mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_ser.h"
+
+
+#if !READY_QUEUE_SCHEDULING
+  #error "test_sleep_queue needs -DREADY_QUEUE_SCHEDULING=1, see Makefile"
+#endif
+
+/*! groesste Anzahl Tasks einer Phase */
+#define TEST_MAX_TASKS      5
+/*! Prioritaet der schlafenden Tasks, die Steuer-Task liegt darunter */
+#define TEST_SLEEP_PRIO     40
+/*! Start der Uhr: so viele Ticks vor dem Ueberlauf */
+#define TEST_WRAP_TICKS     6
+
+
+/*! Zustand einer schlafenden Task, pData */
+typedef struct {
+        CosTicks_t sleep_Ticks;     /*!< Sleep-Zeit */
+        CosTicks_t start_Ticks;     /*!< Beginn der Sleep-Zeit */
+        CosTicks_t woke_Ticks;      /*!< Zeit beim Aufwachen */
+        uint8_t    woke;            /*!< 1: ist aufgewacht */
+} TestSleeper_t;
+
+
+static const CosTicks_t wrapSleep_g[]   = {3, 10, 5, 10, 20};
+static const CosTicks_t equalSleep_g[]  = {7, 3, 7, 5, 7};
+static const uint8_t    equalOrder_g[]  = {1, 3, 0, 2, 4};   /*! erwartete Folge */
+static const CosTicks_t removeSleep_g[] = {4, 6, 6, 8, 10};
+
+static TestSleeper_t sleeper_g[TEST_MAX_TASKS];
+static CosTask_t *task_g[TEST_MAX_TASKS];
+static uint8_t  nTasks_g;
+static uint8_t  woken_g[TEST_MAX_TASKS];         /*! Reihenfolge des Aufwachens */
+static uint8_t  nWoken_g;
+static uint8_t  queueErr_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _sleepTask(CosTask_t *pt)
+{
+    TestSleeper_t *s = (TestSleeper_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    s->start_Ticks = pt->lastActivationTime_Ticks;
+    COS_TASK_SLEEP(pt, s->sleep_Ticks);
+    s->woke_Ticks = _gettime_Ticks32();
+    s->woke = 1;
+    woken_g[nWoken_g++] = (uint8_t)(s - sleeper_g);
+    if(!_checkSchedulerQueues())
+    {   queueErr_g++;
+    }
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+/* creates one sleeper per entry, they start at once */
+static void _startSleepers(const CosTicks_t *sleep_Ticks, uint8_t n)
+{
+    uint8_t i;
+
+    nTasks_g = n;
+    nWoken_g = 0;
+    for(i = 0; i < n; i++)
+    {   sleeper_g[i].sleep_Ticks = sleep_Ticks[i];
+        sleeper_g[i].woke = 0;
+        task_g[i] = COS_CreateTask(TEST_SLEEP_PRIO, &sleeper_g[i], _sleepTask);
+    }
+}
+/*---------------------------------------------------------------*/
+/* every sleeper in mask woke at its own wake-up time, no other one */
+static uint8_t _wokeOnTime(uint8_t mask)
+{
+    uint8_t i;
+
+    for(i = 0; i < nTasks_g; i++)
+    {   if(sleeper_g[i].woke != ((mask >> i) & 1))
+        {   return 0;
+        }
+        if(sleeper_g[i].woke && (sleeper_g[i].woke_Ticks !=
+           (CosTicks_t)(sleeper_g[i].start_Ticks + sleeper_g[i].sleep_Ticks)))
+        {   return 0;
+        }
+    }
+    return 1;
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static uint8_t i;
+
+    COS_TASK_BEGIN(pt);
+
+    /* wrap */
+    COS_TASK_SLEEP(pt, 1);        /* phases begin at the start of a tick */
+    _startSleepers(wrapSleep_g, sizeof(wrapSleep_g) / sizeof(wrapSleep_g[0]));
+    COS_TASK_SLEEP(pt, 25);
+    serPuts("wrap\r\n");
+    _check((sleeper_g[0].start_Ticks > 0xFFFFFF00UL) &&
+           (sleeper_g[4].woke_Ticks < 0x100UL), "sleeps across the overflow");
+    _check(_wokeOnTime(0x1F), "each one woke at its own time");
+
+    /* equal */
+    COS_TASK_SLEEP(pt, 1);
+    _startSleepers(equalSleep_g, sizeof(equalSleep_g) / sizeof(equalSleep_g[0]));
+    COS_TASK_SLEEP(pt, 10);
+    serPuts("equal\r\n");
+    _check(_wokeOnTime(0x1F), "each one woke at its own time");
+    for(i = 0; (i < nWoken_g) && (woken_g[i] == equalOrder_g[i]); i++)
+    {
+    }
+    _check(sizeof(equalOrder_g) == i, "equal wake-up times in FIFO order");
+
+    /* remove */
+    COS_TASK_SLEEP(pt, 1);
+    _startSleepers(removeSleep_g, sizeof(removeSleep_g) / sizeof(removeSleep_g[0]));
+    COS_TASK_SLEEP(pt, 2);
+    serPuts("remove\r\n");
+    COS_DeleteTask(task_g[1]);    /* same wake-up time as its successor */
+    _check(_checkSchedulerQueues(), "delete from the middle");
+    COS_SuspendTask(task_g[3]);
+    _check(_checkSchedulerQueues(), "suspend in the middle");
+    COS_TASK_SLEEP(pt, 3);
+    COS_ResumeTask(task_g[3]);    /* before its wake-up time */
+    _check(_checkSchedulerQueues(), "resume puts it back");
+    COS_TASK_SLEEP(pt, 7);
+    _check(_wokeOnTime(0x1D), "successors and the resumed one woke on time");
+    _check(0 == queueErr_g, "sleep queue deltas right at every wake-up");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    COS_HostSetTicks(0x100000000ULL - TEST_WRAP_TICKS);
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_CreateTask(TEST_SLEEP_PRIO - 10, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("sleep_queue: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
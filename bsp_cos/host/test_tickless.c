@@ -0,0 +1,268 @@
+/*!
+ ********************************************************************
+   @file            test_tickless.c
+   @par Project   : co-operative Scheduler renesas uC
+   @par Module    : Host-Port (Linux/POSIX) des COS
+
+   @brief  Test: Warten mit _idleWaitTicks() bei TICKLESS_IDLE.
+
+   @par Beschreibung
+   Jede Phase beginnt am Anfang eines Ticks, ausser den Tasks des Tests
+   schlaeft nur die cpu-load-Task. COS_HostGetIdleStats() zaehlt die
+   Aufrufe von _idleWaitTicks().
+   - sleep: eine Task schlaeft 40 Ticks und wacht genau dann auf, der
+     Scheduler wartet dazwischen in wenigen langen Aufrufen.
+   - preempt: eine P-Task schlaeft immer wieder 7 Ticks, die
+     kooperativen Tasks viel laenger. Keine Wartezeit darf ueber die
+     Weckzeit der P-Task hinaus reichen (_preemptTicksUntilWake()).
+   - hrtimer: eine Task wartet mit COS_HRTIMER_SLEEP() 3,5 ms, der
+     Ablauf des HR-Timers beendet das Warten, die Task laeuft sofort.
+   - early: eine nachgebildete ISR signalisiert im Tick 5 einen
+     Semaphor ueber die Defer-Queue und beendet damit das Warten
+     vorzeitig. Die wartende Task laeuft noch in diesem Tick, eine Task
+     mit 30 Ticks Sleep-Zeit wacht trotzdem genau zu ihrer Zeit auf und
+     die Systemzeit stimmt mit der Zahl der Ticks der ISR ueberein.
+   Nur mit READY_QUEUE_SCHEDULING 1 und TICKLESS_IDLE 1, siehe Makefile.
+   Laeuft mit der virtuellen Uhr, bei einem Fehler endet das Programm
+   mit 1.
+
+ ********************************************************************/
+/**************************************************************************
+    Dieses Programm ist Freie Software: Sie können es unter den Bedingungen
+    der GNU General Public License, wie von der Free Software Foundation,
+    Version 3 der Lizenz oder (nach Ihrer Wahl) jeder neueren
+    veröffentlichten Version, weiterverbreiten und/oder modifizieren.
+
+    Dieses Programm wird in der Hoffnung, dass es nützlich sein wird, aber
+    OHNE JEDE GEWÄHRLEISTUNG, bereitgestellt; sogar ohne die implizite
+    Gewährleistung der MARKTFÄHIGKEIT oder EIGNUNG FÜR EINEN BESTIMMTEN ZWECK.
+    Siehe die GNU General Public License fÜr weitere Details.
+
+    Sie sollten eine Kopie der GNU General Public License zusammen mit diesem
+    Programm erhalten haben. Wenn nicht, siehe <http://www.gnu.org/licenses/>.
+
+*****************************************************************************/
+
+#include "cos_host.h"
+#include "cos_scheduler.h"
+#include "cos_semaphore.h"
+#include "cos_hrtimer.h"
+#include "cos_defer.h"
+#include "cos_preempt.h"
+#include "cos_ser.h"
+
+
+#if !(READY_QUEUE_SCHEDULING && TICKLESS_IDLE)
+  #error "test_tickless needs -DREADY_QUEUE_SCHEDULING=1 -DTICKLESS_IDLE=1, see Makefile"
+#endif
+
+/*! Prioritaet der Tasks, die Steuer-Task liegt darunter */
+#define TEST_TASK_PRIO      40
+/*! Periode der P-Task in Ticks */
+#define TEST_P_PERIOD       7
+/*! Wartezeit mit dem HR-Timer in us */
+#define TEST_HR_US          3500
+/*! Tick, in dem die nachgebildete ISR signalisiert */
+#define TEST_EARLY_TICK     5
+/*! Stack der P-Task in Worten, der Host braucht viel */
+#define TEST_P_STACK        4096
+
+
+/*! Zustand einer schlafenden Task, pData */
+typedef struct {
+        CosTicks_t sleep_Ticks;     /*!< Sleep-Zeit */
+        CosTicks_t start_Ticks;     /*!< Beginn der Sleep-Zeit */
+        CosTicks_t woke_Ticks;      /*!< Zeit beim Aufwachen */
+        uint8_t    woke;            /*!< 1: ist aufgewacht */
+} TestSleeper_t;
+
+
+static TestSleeper_t sleeper_g;
+static CosHostIdleStats_t stats_g;
+static uint8_t  failed_g = 0;
+static uint8_t  done_g = 0;
+
+/* preempt */
+static CosPTask_t pTask_g;
+static uint32_t pStack_g[TEST_P_STACK];
+static uint16_t pRuns_g;
+static volatile uint8_t pStop_g;
+
+/* hrtimer */
+static CosHrTimer_t tmr_g;
+static uint64_t hrStart_g, hrWoke_g;
+
+/* early */
+static CosSema_t sem_g;
+static uint32_t hookTicks_g;                /*! Ticks der nachgebildeten ISR */
+static uint32_t hookFireAt_g;               /*! 0: ISR signalisiert nicht */
+static CosTicks_t semWoke_Ticks_g;
+
+
+
+/*---------------------------------------------------------------*/
+static void _check(uint8_t ok, char *what)
+{
+    serPuts(ok ? "  ok   " : "  FAIL ");
+    serPuts(what);
+    serPuts("\r\n");
+    if(!ok)
+    {   failed_g = 1;
+    }
+}
+/*---------------------------------------------------------------*/
+static void _report(void)
+{
+    COS_HostGetIdleStats(&stats_g);
+    serPuts("  idle calls=");    serOutUint32Dec(stats_g.calls);
+    serPuts(" early=");          serOutUint32Dec(stats_g.early);
+    serPuts(" waited=");         serOutUint32Dec(stats_g.waited_Ticks);
+    serPuts(" max_request=");    serOutUint16Dec(stats_g.maxRequest_Ticks);
+    serPuts("\r\n");
+}
+/*---------------------------------------------------------------*/
+/* like the timer ISR: counts ticks, signals once in tick hookFireAt_g */
+static void _tickHook(void)
+{
+    hookTicks_g++;
+    if((0 != hookFireAt_g) && (hookTicks_g == hookFireAt_g))
+    {   (void) COS_DeferSemSignalFromISR(&sem_g);
+    }
+}
+/*---------------------------------------------------------------*/
+static void _sleepTask(CosTask_t *pt)
+{
+    TestSleeper_t *s = (TestSleeper_t *) pt->pData;
+
+    COS_TASK_BEGIN(pt);
+    s->start_Ticks = pt->lastActivationTime_Ticks;
+    COS_TASK_SLEEP(pt, s->sleep_Ticks);
+    s->woke_Ticks = _gettime_Ticks32();
+    s->woke = 1;
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _startSleeper(CosTicks_t sleep_Ticks)
+{
+    sleeper_g.sleep_Ticks = sleep_Ticks;
+    sleeper_g.woke = 0;
+    COS_CreateTask(TEST_TASK_PRIO, &sleeper_g, _sleepTask);
+}
+/*---------------------------------------------------------------*/
+static uint8_t _sleeperOnTime(void)
+{
+    return (uint8_t)(sleeper_g.woke && (sleeper_g.woke_Ticks ==
+                     (CosTicks_t)(sleeper_g.start_Ticks + sleeper_g.sleep_Ticks)));
+}
+/*---------------------------------------------------------------*/
+static void _pLoop(void *arg)
+{
+    while(!pStop_g)
+    {   pRuns_g++;
+        COS_PTaskSleep(TEST_P_PERIOD);
+    }
+}
+/*---------------------------------------------------------------*/
+static void _hrTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    hrStart_g = COS_HostGetCycles64();
+    COS_HRTIMER_SLEEP(pt, &tmr_g, TEST_HR_US);
+    hrWoke_g = COS_HostGetCycles64();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _semTask(CosTask_t *pt)
+{
+    COS_TASK_BEGIN(pt);
+    COS_SEM_WAIT(&sem_g, pt);
+    semWoke_Ticks_g = _gettime_Ticks32();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+static void _ctrlTask(CosTask_t *pt)
+{
+    static CosTicks_t t0_Ticks;
+    static uint32_t hook0;
+
+    COS_TASK_BEGIN(pt);
+
+    /* sleep */
+    COS_TASK_SLEEP(pt, 1);        /* phases begin at the start of a tick */
+    COS_HostResetIdleStats();
+    _startSleeper(40);
+    COS_TASK_SLEEP(pt, 45);
+    serPuts("sleep\r\n");
+    _report();
+    _check(_sleeperOnTime(), "woke exactly after 40 ticks");
+    _check((stats_g.waited_Ticks >= 40) && (stats_g.calls <= 5),
+           "idle in a few long waits");
+
+    /* preempt */
+    COS_TASK_SLEEP(pt, 1);
+    COS_HostResetIdleStats();
+    _startSleeper(40);
+    (void) COS_PTaskCreate(&pTask_g, 7, _pLoop, NULL, pStack_g, TEST_P_STACK);
+    COS_TASK_SLEEP(pt, 45);
+    serPuts("preempt\r\n");
+    _report();
+    _check(_sleeperOnTime(), "cooperative task woke on time");
+    _check(pRuns_g >= 45 / TEST_P_PERIOD, "P-task ran every period");
+    _check((0 != stats_g.maxRequest_Ticks) && (stats_g.maxRequest_Ticks <= TEST_P_PERIOD),
+           "no idle wait beyond the wake-up of the P-task");
+    pStop_g = 1;
+    COS_TASK_SLEEP(pt, TEST_P_PERIOD + 1);   /* the P-task ends */
+
+    /* hrtimer */
+    COS_TASK_SLEEP(pt, 1);
+    COS_HostResetIdleStats();
+    COS_HrTimerInit(&tmr_g);
+    COS_CreateTask(TEST_TASK_PRIO, NULL, _hrTask);
+    COS_TASK_SLEEP(pt, 20);
+    serPuts("hrtimer\r\n");
+    _report();
+    _check((hrWoke_g - hrStart_g >= TEST_HR_US) &&
+           (hrWoke_g - hrStart_g <= TEST_HR_US + COS_HRTIMER_SLACK_US + 50),
+           "HR timer ends the idle wait, task runs at once");
+    _check(stats_g.early >= 1, "idle wait ended early");
+
+    /* early */
+    COS_TASK_SLEEP(pt, 1);
+    COS_HostResetIdleStats();
+    COS_SemCreate(&sem_g, 0);
+    t0_Ticks = _gettime_Ticks32();
+    hook0 = hookTicks_g;
+    hookFireAt_g = hookTicks_g + TEST_EARLY_TICK;
+    COS_CreateTask(TEST_TASK_PRIO, NULL, _semTask);
+    _startSleeper(30);
+    COS_TASK_SLEEP(pt, 35);
+    serPuts("early\r\n");
+    _report();
+    _check(semWoke_Ticks_g == (CosTicks_t)(t0_Ticks + TEST_EARLY_TICK),
+           "ISR ends the idle wait, waiter runs in the same tick");
+    _check(_sleeperOnTime(), "sleeper still woke on time");
+    _check((CosTicks_t)(_gettime_Ticks32() - t0_Ticks) == (CosTicks_t)(hookTicks_g - hook0),
+           "system time matches the ticks of the ISR");
+    _check(stats_g.early >= 1, "idle wait ended early");
+
+    done_g = 1;
+    COS_HostStopScheduler();
+    COS_TASK_END(pt);
+}
+/*---------------------------------------------------------------*/
+int main(void)
+{
+    if(0 != COS_InitTaskList())
+    {   serPuts("COS_InitTaskList failed\r\n");
+        return 1;
+    }
+    COS_HostSetTickHook(_tickHook);
+    COS_CreateTask(TEST_TASK_PRIO - 10, NULL, _ctrlTask);
+    COS_HostRunScheduler(100000);
+    if(!done_g)
+    {   serPuts("tickless: FAIL, not finished\r\n");
+        failed_g = 1;
+    }
+    return failed_g;
+}
+/*---------------------------------------------------------------*/
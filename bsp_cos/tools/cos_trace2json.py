@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+"""
+cos_trace2json.py - wandelt die Ausgabe von COS_TraceDump() in das JSON
+Format von Chrome-Trace um (chrome://tracing, https://ui.perfetto.dev).
+
+Aufruf:
+    cos_trace2json.py [-n ADRESSE=NAME ...] mitschnitt.txt > trace.json
+
+Die Eingabe ist der Mitschnitt des seriellen Terminals, Zeilen ausserhalb
+von "COSTRACE 1 ..." und "COSTRACE END" werden ignoriert. Jede Task wird
+als eigene Zeile (tid) dargestellt, ihre Laufzeit von DISPATCH bis RETURN
+bzw. SLEEP als Block. Semaphor- und FIFO-Ereignisse erscheinen als
+Markierung in der Zeile der gerade laufenden Task, die Belegung jedes
+FIFO zusaetzlich als Zaehler.
+"""
+
+import argparse
+import json
+import sys
+
+DISPATCH, RETURN, SLEEP, BLOCK, SIGNAL, READY, FIFO_WRITE, FIFO_READ, \
+    ISR, CREATE, DELETE, SWITCH = range(1, 13)
+
+NAMES = {BLOCK: "block", SIGNAL: "signal", READY: "ready",
+         FIFO_WRITE: "fifo write", FIFO_READ: "fifo read", ISR: "isr",
+         CREATE: "create", DELETE: "delete", SWITCH: "preempt switch"}
+
+
+def read_dump(lines):
+    """liefert (Zaehlschritte pro ms, Liste von (t, obj, arg, type))"""
+    cycles_per_ms = None
+    events = []
+    for line in lines:
+        f = line.split()
+        if len(f) >= 2 and f[0] == "COSTRACE":
+            if f[1] == "END":
+                if cycles_per_ms is not None:
+                    break
+            elif f[1] == "1" and len(f) >= 4:
+                cycles_per_ms = int(f[2])
+                events = []
+            continue
+        if cycles_per_ms is None or len(f) != 4:
+            continue
+        try:
+            events.append(tuple(int(x, 16) for x in f))
+        except ValueError:
+            continue   # gestoerte Zeile
+    if cycles_per_ms is None:
+        raise SystemExit("no COSTRACE header found")
+    return cycles_per_ms, events
+
+
+def to_chrome(cycles_per_ms, events, names):
+    out = []
+    last = None
+    wraps = 0
+    running = None
+    t0 = events[0][0] if events else 0
+
+    def label(obj, kind):
+        return names.get(obj, "%s 0x%08x" % (kind, obj))
+
+    def ts(t):
+        return (t - t0) * 1000.0 / cycles_per_ms
+
+    for t, obj, arg, typ in events:
+        # the 32 bit cycle counter wraps, the dump is in time order
+        if last is not None and t + wraps < last:
+            wraps += 1 << 32
+        t += wraps
+        last = t
+        if typ == DISPATCH:
+            running = obj
+            out.append({"name": label(obj, "task"), "ph": "B", "ts": ts(t),
+                        "pid": 1, "tid": obj, "args": {"prio": arg}})
+        elif typ in (RETURN, SLEEP) or (typ == DELETE and obj == running):
+            if running == obj:
+                e = {"ph": "E", "ts": ts(t), "pid": 1, "tid": obj}
+                if typ == SLEEP:
+                    e["args"] = {"sleep_ticks": arg}
+                out.append(e)
+                running = None
+            if typ == DELETE:
+                out.append({"name": "delete", "ph": "i", "s": "t",
+                            "ts": ts(t), "pid": 1, "tid": obj})
+        else:
+            tid = 0 if typ == ISR else (running if running is not None
+                                         else obj)
+            e = {"name": NAMES.get(typ, "type %d" % typ), "ph": "i", "s": "t",
+                 "ts": ts(t), "pid": 1, "tid": tid,
+                 "args": {"obj": "0x%08x" % obj, "arg": arg}}
+            if typ in (FIFO_WRITE, FIFO_READ):
+                out.append({"name": label(obj, "fifo"), "ph": "C",
+                            "ts": ts(t), "pid": 1, "args": {"used": arg}})
+            out.append(e)
+    meta = [{"name": "thread_name", "ph": "M", "pid": 1, "tid": 0,
+             "args": {"name": "isr"}}]
+    for tid in sorted({e["tid"] for e in out if "tid" in e} - {0}):
+        meta.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                     "args": {"name": label(tid, "task")}})
+    return {"traceEvents": meta + out, "displayTimeUnit": "ms"}
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("dump", nargs="?", help="Mitschnitt, Vorgabe stdin")
+    ap.add_argument("-n", "--name", action="append", default=[],
+                    metavar="ADDR=NAME", help="Name fuer eine Objekt-Adresse")
+    a = ap.parse_args()
+    names = {}
+    for n in a.name:
+        addr, _, text = n.partition("=")
+        names[int(addr, 16)] = text
+    src = open(a.dump, errors="replace") if a.dump else sys.stdin
+    cycles_per_ms, events = read_dump(src)
+    json.dump(to_chrome(cycles_per_ms, events, names), sys.stdout, indent=0)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()